@@ -0,0 +1,303 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace arrlist_compact {
+
+namespace detail {
+
+// Smallest unsigned type holding `Bits` bits.
+template <unsigned Bits>
+using uint_for_bits = std::conditional_t<
+    (Bits <= 8), std::uint8_t,
+    std::conditional_t<(Bits <= 16), std::uint16_t, std::conditional_t<(Bits <= 32), std::uint32_t, std::uint64_t>>>;
+
+} // namespace detail
+
+// SoA array-backed doubly linked list with configurable index and generation
+// widths. Links are stored as the narrowest unsigned type that fits IndexBits
+// and handles pack index + generation into one integer, so the default 16+16
+// configuration halves both the link arrays and a per-order handle table
+// compared to arrlist_fast (8-byte handles, 4-byte links).
+//
+// Narrow generations wrap quickly, so a slot whose generation reaches its
+// maximum is retired instead of recycled: a stale handle can then never match
+// a newer occupant. Retired slots reduce the usable capacity (see retired()).
+template <typename T, unsigned IndexBits = 16, unsigned GenerationBits = 16>
+class ArrayLinkedList {
+    static_assert(IndexBits > 0 && GenerationBits > 0, "index and generation need at least one bit");
+    static_assert(IndexBits + GenerationBits <= 64, "handle must fit in 64 bits");
+
+public:
+    using index_type = detail::uint_for_bits<IndexBits>;
+    using generation_type = detail::uint_for_bits<GenerationBits>;
+    using handle_storage = detail::uint_for_bits<IndexBits + GenerationBits>;
+
+    // Packed handle: index in the low IndexBits, generation above it.
+    struct NodeHandle {
+        handle_storage bits = 0;
+
+        int index() const { return static_cast<int>(bits & kIndexMask); }
+        generation_type generation() const { return static_cast<generation_type>(bits >> IndexBits); }
+    };
+
+    // Largest capacity representable; the top index value is reserved as null.
+    static constexpr std::size_t max_capacity() { return static_cast<std::size_t>(kIndexMask); }
+
+    explicit ArrayLinkedList(std::size_t capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("capacity must be greater than zero");
+        }
+        if (capacity > max_capacity()) {
+            throw std::invalid_argument("capacity exceeds the configured index width");
+        }
+        values_.resize(capacity);
+        next_.assign(capacity, kNull);
+        prev_.assign(capacity, kNull);
+        generations_.assign(capacity, 0);
+        free_list_.reserve(capacity);
+        for (std::size_t i = capacity; i-- > 0;) {
+            free_list_.push_back(static_cast<index_type>(i));
+        }
+    }
+
+    std::size_t capacity() const { return values_.size(); }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t retired() const { return retired_; }
+
+    // Adds an element at the front and returns its handle.
+    template <typename... Args>
+    NodeHandle emplace_front(Args&&... args) {
+        NodeHandle handle = allocate_node(std::forward<Args>(args)...);
+        const index_type idx = static_cast<index_type>(handle.index());
+        prev_[idx] = kNull;
+        next_[idx] = head_;
+        if (head_ != kNull) {
+            prev_[head_] = idx;
+        } else {
+            tail_ = idx;
+        }
+        head_ = idx;
+        ++size_;
+        return handle;
+    }
+
+    // Adds an element at the back and returns its handle.
+    template <typename... Args>
+    NodeHandle emplace_back(Args&&... args) {
+        NodeHandle handle = allocate_node(std::forward<Args>(args)...);
+        const index_type idx = static_cast<index_type>(handle.index());
+        next_[idx] = kNull;
+        prev_[idx] = tail_;
+        if (tail_ != kNull) {
+            next_[tail_] = idx;
+        } else {
+            head_ = idx;
+        }
+        tail_ = idx;
+        ++size_;
+        return handle;
+    }
+
+    // Inserts a value after the given handle and returns the new handle.
+    template <typename... Args>
+    NodeHandle emplace_after(const NodeHandle& handle, Args&&... args) {
+        ensure_valid_handle(handle);
+        const index_type node_index = static_cast<index_type>(handle.index());
+        NodeHandle new_handle = allocate_node(std::forward<Args>(args)...);
+        const index_type idx = static_cast<index_type>(new_handle.index());
+        const index_type old_next = next_[node_index];
+        prev_[idx] = node_index;
+        next_[idx] = old_next;
+        next_[node_index] = idx;
+        if (old_next != kNull) {
+            prev_[old_next] = idx;
+        } else {
+            tail_ = idx;
+        }
+        ++size_;
+        return new_handle;
+    }
+
+    // Removes the first element and returns its value.
+    T pop_front() {
+        if (head_ == kNull) {
+            throw std::out_of_range("list is empty");
+        }
+        const index_type idx = head_;
+        head_ = next_[idx];
+        if (head_ != kNull) {
+            prev_[head_] = kNull;
+        } else {
+            tail_ = kNull;
+        }
+        --size_;
+        T value = std::move(values_[idx]);
+        release_node(idx);
+        return value;
+    }
+
+    // Removes the node after the given handle.
+    void erase_after(const NodeHandle& handle) {
+        ensure_valid_handle(handle);
+        const index_type node_index = static_cast<index_type>(handle.index());
+        const index_type target = next_[node_index];
+        if (target == kNull) {
+            throw std::out_of_range("no node exists after the given index");
+        }
+        const index_type new_next = next_[target];
+        next_[node_index] = new_next;
+        if (new_next != kNull) {
+            prev_[new_next] = node_index;
+        } else {
+            tail_ = node_index;
+        }
+        --size_;
+        release_node(target);
+    }
+
+    // Removes a node by handle in O(1) time.
+    void erase(const NodeHandle& handle) {
+        ensure_valid_handle(handle);
+        const index_type node_index = static_cast<index_type>(handle.index());
+        const index_type prev = prev_[node_index];
+        const index_type next = next_[node_index];
+
+        if (prev != kNull) {
+            next_[prev] = next;
+        } else {
+            head_ = next;
+        }
+
+        if (next != kNull) {
+            prev_[next] = prev;
+        } else {
+            tail_ = prev;
+        }
+
+        --size_;
+        release_node(node_index);
+    }
+
+    // Iterates through the list, calling fn(value, index) for each element.
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        index_type idx = head_;
+        while (idx != kNull) {
+            fn(values_[idx], static_cast<int>(idx));
+            idx = next_[idx];
+        }
+    }
+
+    // Accessor for testing/benchmarking.
+    const T& at(int node_index) const {
+        ensure_valid_node(node_index);
+        return values_[node_index];
+    }
+
+    // Handle-based access; lets owners update a node in place without relinking.
+    T& value(const NodeHandle& handle) {
+        ensure_valid_handle(handle);
+        return values_[handle.index()];
+    }
+
+    const T& value(const NodeHandle& handle) const {
+        ensure_valid_handle(handle);
+        return values_[handle.index()];
+    }
+
+    // Convenience push/insert wrappers preserving previous API names.
+    NodeHandle push_front(const T& value) { return emplace_front(value); }
+    NodeHandle push_back(const T& value) { return emplace_back(value); }
+    NodeHandle insert_after(const NodeHandle& handle, const T& value) { return emplace_after(handle, value); }
+
+    // Lightweight iteration helpers for tight loops (unchecked). Indices are
+    // widened to int with -1 as null, matching the other list variants.
+    int head_index_unchecked() const { return to_int(head_); }
+    int next_index_unchecked(int node_index) const { return to_int(next_[node_index]); }
+    const T& value_unchecked(int node_index) const { return values_[node_index]; }
+
+    template <typename Fn>
+    void for_each_value_unchecked(Fn&& fn) const {
+        for (index_type idx = head_; idx != kNull; idx = next_[idx]) {
+            fn(values_[idx]);
+        }
+    }
+
+private:
+    static constexpr handle_storage kIndexMask = (handle_storage{1} << IndexBits) - 1;
+    static constexpr index_type kNull = static_cast<index_type>(kIndexMask);
+    static constexpr generation_type kMaxGeneration =
+        static_cast<generation_type>((std::uint64_t{1} << GenerationBits) - 1);
+
+    static int to_int(index_type idx) { return idx == kNull ? -1 : static_cast<int>(idx); }
+
+    static NodeHandle make_handle(index_type idx, generation_type generation) {
+        return NodeHandle{static_cast<handle_storage>(static_cast<handle_storage>(generation) << IndexBits | idx)};
+    }
+
+    template <typename... Args>
+    NodeHandle allocate_node(Args&&... args) {
+        if (free_list_.empty()) {
+            throw std::overflow_error("no free slots left in the list");
+        }
+        const index_type idx = free_list_.back();
+        free_list_.pop_back();
+        values_[idx] = T(std::forward<Args>(args)...);
+        next_[idx] = kNull;
+        prev_[idx] = kNull;
+        ++generations_[idx];
+        return make_handle(idx, generations_[idx]);
+    }
+
+    void release_node(index_type idx) {
+        next_[idx] = kNull;
+        prev_[idx] = kNull;
+        // The generation moves on at release as well as at allocation, so a
+        // handle to a freed slot is stale at once. Live generations run
+        // 1..kMaxGeneration; recycling past the top would wrap to a value an
+        // old handle may still carry. Parking the slot at generation 0 makes
+        // every handle to it permanently stale.
+        if (generations_[idx] >= kMaxGeneration - 1) {
+            generations_[idx] = 0;
+            ++retired_;
+            return;
+        }
+        ++generations_[idx];
+        free_list_.push_back(idx);
+    }
+
+    void ensure_valid_handle(const NodeHandle& handle) const {
+        const std::size_t idx = static_cast<std::size_t>(handle.index());
+        // Generation 0 never belongs to a live node, which also rejects a
+        // default-constructed handle.
+        if (idx >= values_.size() || handle.generation() == 0 || generations_[idx] != handle.generation()) {
+            throw std::out_of_range("node handle is invalid or stale");
+        }
+    }
+
+    void ensure_valid_node(int idx) const {
+        if (idx < 0 || static_cast<std::size_t>(idx) >= values_.size()) {
+            throw std::out_of_range("node index is invalid");
+        }
+    }
+
+    std::vector<T> values_;
+    std::vector<index_type> next_;
+    std::vector<index_type> prev_;
+    std::vector<generation_type> generations_;
+    std::vector<index_type> free_list_;
+    index_type head_ = kNull;
+    index_type tail_ = kNull;
+    std::size_t size_ = 0;
+    std::size_t retired_ = 0;
+};
+
+} // namespace arrlist_compact
@@ -2,36 +2,203 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
 #include <stdexcept>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "check_policy.hpp"
+#include "list_image.hpp"
+#include "list_stats.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 namespace arrlist_fast {
 
+// Free-slot tracking policies for ArrayLinkedList. acquire(hint) is only called
+// when the policy is not empty and receives the node the new slot will be
+// linked next to (kNull when the list is empty) as a locality hint. Policies
+// that support list images also provide kImageTag, save_image and load_image.
+
+// LIFO stack: reuses the most recently freed slot. Cheapest bookkeeping, but
+// after random cancels the reused slots are scattered across every array.
+class LifoFreeList {
+public:
+    explicit LifoFreeList(std::size_t capacity) {
+        free_.reserve(capacity);
+        for (std::size_t i = capacity; i-- > 0;) {
+            free_.push_back(static_cast<int>(i));
+        }
+    }
+
+    bool empty() const { return free_.empty(); }
+    std::size_t size() const { return free_.size(); }
+
+    int acquire(int /*hint*/) {
+        const int idx = free_.back();
+        free_.pop_back();
+        return idx;
+    }
+
+    void release(int idx) { free_.push_back(idx); }
+
+    static constexpr std::uint32_t kImageTag = 1;
+
+    // The stack as-is, so a restored list reuses slots in the same order.
+    void save_image(arrlist::ImageWriter& out) const {
+        const std::uint64_t count = free_.size();
+        out.array(&count, 1);
+        out.array(free_.data(), free_.size());
+    }
+
+    void load_image(arrlist::ImageReader& in, std::size_t capacity) {
+        std::uint64_t count = 0;
+        in.array(&count, 1);
+        if (count > capacity) {
+            throw std::runtime_error("list image free list is larger than its capacity");
+        }
+        free_.resize(static_cast<std::size_t>(count));
+        in.array(free_.data(), free_.size());
+    }
+
+private:
+    std::vector<int> free_;
+};
+
+// Two-level bitmap: hands out the nearest free slot at or after the hint,
+// wrapping around at the end. Inserts at the back therefore land next to the
+// current tail and share its cache lines in values_/next_/prev_/generations_.
+// A summary word per 64 bitmap words keeps the search short when the area
+// around the hint is full.
+class BitmapFreeList {
+public:
+    explicit BitmapFreeList(std::size_t capacity)
+        : words_((capacity + 63) / 64, ~std::uint64_t{0}), summary_((words_.size() + 63) / 64, 0), free_(capacity) {
+        if (capacity % 64 != 0) {
+            words_.back() = (std::uint64_t{1} << (capacity % 64)) - 1;
+        }
+        for (std::size_t w = 0; w < words_.size(); ++w) {
+            summary_[w >> 6] |= std::uint64_t{1} << (w & 63);
+        }
+    }
+
+    bool empty() const { return free_ == 0; }
+    std::size_t size() const { return free_; }
+
+    int acquire(int hint) {
+        const std::size_t start = hint < 0 ? 0 : static_cast<std::size_t>(hint);
+        std::size_t w = start >> 6;
+        std::uint64_t bits = words_[w] & (~std::uint64_t{0} << (start & 63));
+        if (bits == 0) {
+            w = next_free_word(w + 1);
+            bits = words_[w];
+        }
+        const std::size_t bit = static_cast<std::size_t>(__builtin_ctzll(bits));
+        words_[w] &= ~(std::uint64_t{1} << bit);
+        if (words_[w] == 0) {
+            summary_[w >> 6] &= ~(std::uint64_t{1} << (w & 63));
+        }
+        --free_;
+        return static_cast<int>((w << 6) | bit);
+    }
+
+    void release(int idx) {
+        const std::size_t w = static_cast<std::size_t>(idx) >> 6;
+        if (words_[w] == 0) {
+            summary_[w >> 6] |= std::uint64_t{1} << (w & 63);
+        }
+        words_[w] |= std::uint64_t{1} << (idx & 63);
+        ++free_;
+    }
+
+    static constexpr std::uint32_t kImageTag = 2;
+
+    // Bitmap and summary words; their lengths follow from the capacity.
+    void save_image(arrlist::ImageWriter& out) const {
+        const std::uint64_t free = free_;
+        out.array(&free, 1);
+        out.array(words_.data(), words_.size());
+        out.array(summary_.data(), summary_.size());
+    }
+
+    void load_image(arrlist::ImageReader& in, std::size_t capacity) {
+        std::uint64_t free = 0;
+        in.array(&free, 1);
+        if (free > capacity) {
+            throw std::runtime_error("list image free count is larger than its capacity");
+        }
+        free_ = static_cast<std::size_t>(free);
+        in.array(words_.data(), words_.size());
+        in.array(summary_.data(), summary_.size());
+    }
+
+private:
+    // First bitmap word at or after `from` that has a free bit, wrapping to the
+    // start. Requires at least one free slot.
+    std::size_t next_free_word(std::size_t from) const {
+        if (from >= words_.size()) {
+            from = 0;
+        }
+        std::size_t s = from >> 6;
+        std::uint64_t bits = summary_[s] & (~std::uint64_t{0} << (from & 63));
+        while (bits == 0) {
+            s = s + 1 == summary_.size() ? 0 : s + 1;
+            bits = summary_[s];
+        }
+        return (s << 6) | static_cast<std::size_t>(__builtin_ctzll(bits));
+    }
+
+    std::vector<std::uint64_t> words_;
+    std::vector<std::uint64_t> summary_;
+    std::size_t free_;
+};
+
 // Array-backed doubly linked list using indices instead of pointers.
 // Storage uses structure-of-arrays (SoA) for better cache behavior when only
 // some fields are touched during traversal. Operations use stable handles
-// (index + generation) to detect stale references.
-template <typename T>
+// (index + generation) to detect stale references. FreeList selects how free
+// slots are recycled (see LifoFreeList / BitmapFreeList above); CheckPolicy
+// selects throwing, assert-only or no validation (see check_policy.hpp).
+// Allocator backs the slot arrays (values_, next_, prev_, generations_),
+// rebound per array, e.g. mem::PageAllocator for huge pages at large
+// capacities; the free-list policy keeps its own small storage. Stats gets
+// the size, slot reuse, traversal and rejected-handle events (see
+// list_stats.hpp); the default NoStats compiles them away.
+template <typename T, typename FreeList = LifoFreeList, typename CheckPolicy = arrlist::ThrowChecks,
+          typename Allocator = std::allocator<T>, typename Stats = arrlist::NoStats>
 class ArrayLinkedList {
+    template <typename U>
+    using rebind_alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<U>;
+
 public:
+    using value_type = T;
+    using check_policy = CheckPolicy;
+    using allocator_type = Allocator;
+    using stats_policy = Stats;
+
     struct NodeHandle {
         int index = -1;
         std::uint32_t generation = 0;
     };
 
-    explicit ArrayLinkedList(std::size_t capacity) {
-        if (capacity == 0) {
-            throw std::invalid_argument("capacity must be greater than zero");
-        }
+    explicit ArrayLinkedList(std::size_t capacity, const Allocator& alloc = Allocator())
+        : values_(alloc),
+          next_(rebind_alloc<int>(alloc)),
+          prev_(rebind_alloc<int>(alloc)),
+          generations_(rebind_alloc<std::uint32_t>(alloc)),
+          free_list_(checked_capacity(capacity)) {
         values_.resize(capacity);
         next_.assign(capacity, kNull);
         prev_.assign(capacity, kNull);
         generations_.assign(capacity, 0);
-        free_list_.reserve(capacity);
-        for (std::size_t i = capacity; i-- > 0;) {
-            free_list_.push_back(static_cast<int>(i));
-        }
     }
 
     std::size_t capacity() const { return values_.size(); }
@@ -41,8 +208,9 @@ public:
     // Adds an element at the front and returns its handle.
     template <typename... Args>
     NodeHandle emplace_front(Args&&... args) {
-        NodeHandle handle = allocate_node(std::forward<Args>(args)...);
+        NodeHandle handle = allocate_node(head_, std::forward<Args>(args)...);
         const int idx = handle.index;
+        contiguous_ = head_ == kNull || (contiguous_ && idx + 1 == head_);
         prev_[idx] = kNull;
         next_[idx] = head_;
         if (head_ != kNull) {
@@ -58,8 +226,9 @@ public:
     // Adds an element at the back and returns its handle.
     template <typename... Args>
     NodeHandle emplace_back(Args&&... args) {
-        NodeHandle handle = allocate_node(std::forward<Args>(args)...);
+        NodeHandle handle = allocate_node(tail_, std::forward<Args>(args)...);
         const int idx = handle.index;
+        contiguous_ = tail_ == kNull || (contiguous_ && idx == tail_ + 1);
         next_[idx] = kNull;
         prev_[idx] = tail_;
         if (tail_ != kNull) {
@@ -77,9 +246,10 @@ public:
     NodeHandle emplace_after(const NodeHandle& handle, Args&&... args) {
         ensure_valid_handle(handle);
         const int node_index = handle.index;
-        NodeHandle new_handle = allocate_node(std::forward<Args>(args)...);
+        NodeHandle new_handle = allocate_node(node_index, std::forward<Args>(args)...);
         const int idx = new_handle.index;
         const int old_next = next_[node_index];
+        contiguous_ = contiguous_ && old_next == kNull && idx == node_index + 1;
         prev_[idx] = node_index;
         next_[idx] = old_next;
         next_[node_index] = idx;
@@ -92,11 +262,69 @@ public:
         return new_handle;
     }
 
+    // Inserts a value before the given handle and returns the new handle.
+    template <typename... Args>
+    NodeHandle emplace_before(const NodeHandle& handle, Args&&... args) {
+        ensure_valid_handle(handle);
+        const int node_index = handle.index;
+        NodeHandle new_handle = allocate_node(node_index, std::forward<Args>(args)...);
+        const int idx = new_handle.index;
+        const int old_prev = prev_[node_index];
+        contiguous_ = contiguous_ && old_prev == kNull && idx + 1 == node_index;
+        next_[idx] = node_index;
+        prev_[idx] = old_prev;
+        prev_[node_index] = idx;
+        if (old_prev != kNull) {
+            next_[old_prev] = idx;
+        } else {
+            head_ = idx;
+        }
+        ++size_;
+        return new_handle;
+    }
+
+    // Relinks a node at the back (front) in O(1), keeping its slot, value and
+    // handle: a modify that loses queue priority without a free-list round
+    // trip or a new handle for the owner to store.
+    void move_to_back(const NodeHandle& handle) {
+        ensure_valid_handle(handle);
+        const int idx = handle.index;
+        if (idx == tail_) {
+            return;
+        }
+        contiguous_ = false;
+        unlink(idx);
+        next_[idx] = kNull;
+        prev_[idx] = tail_;
+        if (tail_ != kNull) {
+            next_[tail_] = idx;
+        } else {
+            head_ = idx;
+        }
+        tail_ = idx;
+    }
+
+    void move_to_front(const NodeHandle& handle) {
+        ensure_valid_handle(handle);
+        const int idx = handle.index;
+        if (idx == head_) {
+            return;
+        }
+        contiguous_ = false;
+        unlink(idx);
+        prev_[idx] = kNull;
+        next_[idx] = head_;
+        if (head_ != kNull) {
+            prev_[head_] = idx;
+        } else {
+            tail_ = idx;
+        }
+        head_ = idx;
+    }
+
     // Removes the first element and returns its value.
     T pop_front() {
-        if (head_ == kNull) {
-            throw std::out_of_range("list is empty");
-        }
+        CheckPolicy::template require<std::out_of_range>(head_ != kNull, "list is empty");
         const int idx = head_;
         head_ = next_[idx];
         if (head_ != kNull) {
@@ -115,10 +343,9 @@ public:
         ensure_valid_handle(handle);
         const int node_index = handle.index;
         const int target = next_[node_index];
-        if (target == kNull) {
-            throw std::out_of_range("no node exists after the given index");
-        }
+        CheckPolicy::template require<std::out_of_range>(target != kNull, "no node exists after the given index");
         const int new_next = next_[target];
+        contiguous_ = contiguous_ && new_next == kNull;
         next_[node_index] = new_next;
         if (new_next != kNull) {
             prev_[new_next] = node_index;
@@ -135,6 +362,8 @@ public:
         const int node_index = handle.index;
         const int prev = prev_[node_index];
         const int next = next_[node_index];
+        // Dropping either end keeps a contiguous run contiguous.
+        contiguous_ = contiguous_ && (prev == kNull || next == kNull);
 
         if (prev != kNull) {
             next_[prev] = next;
@@ -155,6 +384,7 @@ public:
     // Iterates through the list, calling fn(value, index) for each element.
     template <typename Fn>
     void for_each(Fn&& fn) const {
+        Stats::on_traverse(size_);
         int idx = head_;
         while (idx != kNull) {
             fn(values_[idx], idx);
@@ -168,10 +398,412 @@ public:
         return values_[node_index];
     }
 
+    // Handle-based access; lets owners update a node in place without relinking.
+    T& value(const NodeHandle& handle) {
+        ensure_valid_handle(handle);
+        return values_[handle.index];
+    }
+
+    const T& value(const NodeHandle& handle) const {
+        ensure_valid_handle(handle);
+        return values_[handle.index];
+    }
+
     // Convenience push/insert wrappers preserving previous API names.
     NodeHandle push_front(const T& value) { return emplace_front(value); }
     NodeHandle push_back(const T& value) { return emplace_back(value); }
     NodeHandle insert_after(const NodeHandle& handle, const T& value) { return emplace_after(handle, value); }
+    NodeHandle insert_before(const NodeHandle& handle, const T& value) { return emplace_before(handle, value); }
+
+    // Appends count values in one pass. Each new node is linked straight to the
+    // previous one, so the old tail is written once and no node is relinked.
+    // One handle per value is written to handles_out when it is non-null.
+    // All-or-nothing: nothing is inserted if fewer than count slots are free.
+    void push_back_bulk(const T* values, std::size_t count, NodeHandle* handles_out = nullptr) {
+        if (count == 0) {
+            return;
+        }
+        CheckPolicy::template require<std::overflow_error>(free_list_.size() >= count, "not enough free slots for bulk insert");
+        int prev = tail_;
+        for (std::size_t i = 0; i < count; ++i) {
+            const int idx = free_list_.acquire(prev);
+            Stats::on_acquire(idx, prev);
+            contiguous_ = prev == kNull || (contiguous_ && idx == prev + 1);
+            values_[idx] = values[i];
+            ++generations_[idx];
+            prev_[idx] = prev;
+            if (prev != kNull) {
+                next_[prev] = idx;
+            } else {
+                head_ = idx;
+            }
+            if (handles_out != nullptr) {
+                handles_out[i] = NodeHandle{idx, generations_[idx]};
+            }
+            prev = idx;
+        }
+        next_[prev] = kNull;
+        tail_ = prev;
+        size_ += count;
+        Stats::on_size(size_);
+    }
+
+    // Erases count handles. Link entries of upcoming nodes and then of their
+    // neighbours are prefetched a few iterations ahead, so the unlink writes
+    // mostly hit lines that are already in flight.
+    void erase_bulk(const NodeHandle* handles, std::size_t count) {
+        constexpr std::size_t kAhead = 4;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (i + 2 * kAhead < count) {
+                const int idx = handles[i + 2 * kAhead].index;
+                if (idx >= 0 && static_cast<std::size_t>(idx) < values_.size()) {
+                    prefetch(&next_[idx]);
+                    prefetch(&prev_[idx]);
+                }
+            }
+            if (i + kAhead < count) {
+                const int idx = handles[i + kAhead].index;
+                if (idx >= 0 && static_cast<std::size_t>(idx) < values_.size()) {
+                    const int prev = prev_[idx];
+                    const int next = next_[idx];
+                    if (prev != kNull) {
+                        prefetch(&next_[prev]);
+                    }
+                    if (next != kNull) {
+                        prefetch(&prev_[next]);
+                    }
+                }
+            }
+            erase(handles[i]);
+        }
+    }
+
+#if __cplusplus >= 202002L
+    void push_back_bulk(std::span<const T> values, NodeHandle* handles_out = nullptr) {
+        push_back_bulk(values.data(), values.size(), handles_out);
+    }
+
+    void erase_bulk(std::span<const NodeHandle> handles) { erase_bulk(handles.data(), handles.size()); }
+#endif
+
+    // Physically reorders values_/next_/prev_ into list order, so the list
+    // occupies slots [0, size()) and traversal becomes a sequential scan.
+    // Returns old slot -> new slot (kNull for free slots); translate existing
+    // handles with remap(). Every slot's generation is bumped, so handles that
+    // are not remapped fail validation instead of aliasing a moved node.
+    std::vector<int> compact() {
+        const std::size_t cap = values_.size();
+        std::vector<int> remap(cap, kNull);
+        std::vector<T, Allocator> values(cap, values_.get_allocator());
+        int rank = 0;
+        for (int idx = head_; idx != kNull; idx = next_[idx], ++rank) {
+            remap[idx] = rank;
+            values[rank] = std::move(values_[idx]);
+        }
+        values_.swap(values);
+        for (std::size_t i = 0; i < cap; ++i) {
+            const int r = static_cast<int>(i);
+            const bool live = i < size_;
+            next_[i] = live && i + 1 < size_ ? r + 1 : kNull;
+            prev_[i] = live && i > 0 ? r - 1 : kNull;
+            ++generations_[i];
+        }
+        // A fresh policy hands out 0, 1, 2, ... when each hint is the previous
+        // slot, which retires exactly the occupied prefix.
+        free_list_ = FreeList(cap);
+        for (std::size_t i = 0; i < size_; ++i) {
+            free_list_.acquire(static_cast<int>(i) - 1);
+        }
+        head_ = size_ > 0 ? 0 : kNull;
+        tail_ = size_ > 0 ? static_cast<int>(size_) - 1 : kNull;
+        contiguous_ = true;
+        return remap;
+    }
+
+    // Translates a handle that was live when compact() produced `remap`.
+    NodeHandle remap(const NodeHandle& handle, const std::vector<int>& table) const {
+        const int idx = table[handle.index];
+        return NodeHandle{idx, idx == kNull ? 0 : generations_[idx]};
+    }
+
+    // True when the list occupies consecutive slots in list order (after
+    // compact(), a sequential fill, or front/back-only churn since then). The
+    // values are then contiguous_values()[0, size()) and can be processed as a
+    // flat array.
+    bool is_contiguous() const { return contiguous_; }
+    const T* contiguous_values() const { return contiguous_ && head_ != kNull ? values_.data() + head_ : nullptr; }
+
+    // Reductions over one arithmetic field of T, e.g. sum_field(&Order::qty).
+    // Integral fields accumulate in 64 bits, floating-point ones in double.
+    template <typename F>
+    using field_sum_t = std::conditional_t<std::is_floating_point<F>::value,
+                                           double,
+                                           std::conditional_t<std::is_signed<F>::value, std::int64_t, std::uint64_t>>;
+
+    struct PrefixResult {
+        std::size_t count = 0; // nodes consumed, including the one crossing the threshold
+        int index = kNull;     // slot of the last consumed node
+        bool reached = false;  // false when the whole list sums below the threshold
+    };
+
+    // Sum of `member` over the list. Contiguous lists reduce as a flat loop;
+    // otherwise the walk collects indices in blocks and, for 4-byte integer
+    // fields on AVX2, fetches the fields with gathers so the payload loads
+    // are issued independently of the next_ chain.
+    template <typename F>
+    field_sum_t<F> sum_field(F T::*member) const {
+        static_assert(std::is_arithmetic<F>::value, "sum_field requires an arithmetic field");
+        using Acc = field_sum_t<F>;
+        Stats::on_traverse(size_);
+        if (contiguous_) {
+            const T* values = values_.data() + (head_ == kNull ? 0 : head_);
+            Acc sum = 0;
+            for (std::size_t i = 0; i < size_; ++i) {
+                sum += static_cast<Acc>(values[i].*member);
+            }
+            return sum;
+        }
+        if constexpr (kGatherable<F>) {
+            constexpr std::size_t kBlock = 64;
+            int indices[kBlock];
+            Acc sum = 0;
+            int idx = head_;
+            while (idx != kNull) {
+                std::size_t n = 0;
+                for (; idx != kNull && n < kBlock; idx = next_[idx]) {
+                    indices[n++] = idx;
+                }
+                sum += gather_sum(member, indices, n);
+            }
+            return sum;
+        } else {
+            Acc sum = 0;
+            for (int idx = head_; idx != kNull; idx = next_[idx]) {
+                sum += static_cast<Acc>(values_[idx].*member);
+            }
+            return sum;
+        }
+    }
+
+    // Walks from the head accumulating `member` until the running total reaches
+    // `threshold`, e.g. how many resting orders a fill of that size consumes.
+    // A threshold <= 0 is reached with no node consumed (count 0, index kNull).
+    // Contiguous lists skip whole blocks in which no running total reaches the
+    // threshold: the block sum when it holds no negative value, otherwise
+    // (the total dips and recovers) the highest running total in the block.
+    template <typename F>
+    PrefixResult find_prefix_ge(F T::*member, field_sum_t<F> threshold) const {
+        static_assert(std::is_arithmetic<F>::value, "find_prefix_ge requires an arithmetic field");
+        using Acc = field_sum_t<F>;
+        PrefixResult result;
+        if (threshold <= 0) {
+            // The empty prefix meets it, on an empty list too.
+            result.reached = true;
+            return result;
+        }
+        Acc total = 0;
+        if (contiguous_ && head_ != kNull) {
+            constexpr std::size_t kBlock = 16;
+            const T* values = values_.data() + head_;
+            std::size_t i = 0;
+            for (; i + kBlock <= size_; i += kBlock) {
+                Acc block = 0;
+                bool dips = false;
+                if constexpr (std::is_integral<F>::value) {
+                    // OR of the raw fields: the sign bit is set iff one is negative.
+                    F bits = 0;
+                    for (std::size_t j = 0; j < kBlock; ++j) {
+                        block += static_cast<Acc>(values[i + j].*member);
+                        bits |= values[i + j].*member;
+                    }
+                    dips = bits < 0;
+                } else {
+                    for (std::size_t j = 0; j < kBlock; ++j) {
+                        block += static_cast<Acc>(values[i + j].*member);
+                        dips |= values[i + j].*member < 0;
+                    }
+                }
+                Acc reach = block;
+                if (dips) {
+                    // total < threshold, so the empty prefix is a safe start.
+                    Acc running = 0;
+                    reach = 0;
+                    for (std::size_t j = 0; j < kBlock; ++j) {
+                        running += static_cast<Acc>(values[i + j].*member);
+                        reach = running > reach ? running : reach;
+                    }
+                }
+                if (total + reach >= threshold) {
+                    break;
+                }
+                total += block;
+            }
+            for (; i < size_; ++i) {
+                total += static_cast<Acc>(values[i].*member);
+                if (total >= threshold) {
+                    Stats::on_traverse(i + 1);
+                    return PrefixResult{i + 1, head_ + static_cast<int>(i), true};
+                }
+            }
+            Stats::on_traverse(size_);
+            return PrefixResult{size_, tail_, false};
+        }
+        for (int idx = head_; idx != kNull; idx = next_[idx]) {
+            total += static_cast<Acc>(values_[idx].*member);
+            ++result.count;
+            result.index = idx;
+            if (total >= threshold) {
+                result.reached = true;
+                break;
+            }
+        }
+        Stats::on_traverse(result.count);
+        return result;
+    }
+
+    // Calls fn(value) from the head until it returns false; returns the number
+    // of values visited (including the one that stopped the walk).
+    template <typename Fn>
+    std::size_t visit_until(Fn&& fn) const {
+        std::size_t visited = 0;
+        if (contiguous_ && head_ != kNull) {
+            const T* values = values_.data() + head_;
+            while (visited < size_) {
+                if (!fn(values[visited++])) {
+                    break;
+                }
+            }
+            Stats::on_traverse(visited);
+            return visited;
+        }
+        for (int idx = head_; idx != kNull; idx = next_[idx]) {
+            ++visited;
+            if (!fn(values_[idx])) {
+                break;
+            }
+        }
+        Stats::on_traverse(visited);
+        return visited;
+    }
+
+    // Non-throwing variants: always validate, regardless of CheckPolicy, and
+    // report failure through the return value.
+    template <typename... Args>
+    std::optional<NodeHandle> try_emplace_front(Args&&... args) {
+        if (free_list_.empty()) {
+            return std::nullopt;
+        }
+        return emplace_front(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::optional<NodeHandle> try_emplace_back(Args&&... args) {
+        if (free_list_.empty()) {
+            return std::nullopt;
+        }
+        return emplace_back(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::optional<NodeHandle> try_emplace_after(const NodeHandle& handle, Args&&... args) {
+        if (free_list_.empty() || !is_valid_handle(handle)) {
+            return std::nullopt;
+        }
+        return emplace_after(handle, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::optional<NodeHandle> try_emplace_before(const NodeHandle& handle, Args&&... args) {
+        if (free_list_.empty() || !is_valid_handle(handle)) {
+            return std::nullopt;
+        }
+        return emplace_before(handle, std::forward<Args>(args)...);
+    }
+
+    std::optional<T> try_pop_front() {
+        if (head_ == kNull) {
+            return std::nullopt;
+        }
+        return pop_front();
+    }
+
+    arrlist::Status try_erase_after(const NodeHandle& handle) {
+        if (!is_valid_handle(handle)) {
+            return arrlist::Status::InvalidHandle;
+        }
+        if (next_[handle.index] == kNull) {
+            return arrlist::Status::NoNext;
+        }
+        erase_after(handle);
+        return arrlist::Status::Ok;
+    }
+
+    arrlist::Status try_erase(const NodeHandle& handle) {
+        if (!is_valid_handle(handle)) {
+            return arrlist::Status::InvalidHandle;
+        }
+        erase(handle);
+        return arrlist::Status::Ok;
+    }
+
+    // Writes the whole state (every slot, links, generations, free list) to fd
+    // as a flat image (see list_image.hpp), starting at its current offset.
+    // Handles stay valid across save/load, so an owner that saves its own
+    // id -> handle table alongside gets a warm restart without replaying the
+    // session. Throws std::runtime_error when a write fails.
+    void save(int fd) const {
+        static_assert(std::is_trivially_copyable<T>::value, "list images copy values as bytes");
+        arrlist::ImageHeader h{};
+        std::memcpy(h.magic, arrlist::kImageMagic, sizeof(h.magic));
+        h.version = arrlist::kImageVersion;
+        h.layout = arrlist::ImageLayout::FastSoa;
+        h.value_size = sizeof(T);
+        h.value_align = alignof(T);
+        h.free_list = FreeList::kImageTag;
+        h.flags = contiguous_ ? arrlist::kImageContiguous : 0;
+        h.capacity = values_.size();
+        h.size = size_;
+        h.head = head_;
+        h.tail = tail_;
+        arrlist::ImageWriter out(fd);
+        out.array(&h, 1);
+        out.array(values_.data(), values_.size());
+        out.array(next_.data(), next_.size());
+        out.array(prev_.data(), prev_.size());
+        out.array(generations_.data(), generations_.size());
+        free_list_.save_image(out);
+    }
+
+    // Replaces this list with an image written by save(), read from fd's
+    // current offset; the capacity becomes the image's. The image is trusted
+    // beyond its header (links are not re-walked). On any error the list is
+    // left unchanged and std::runtime_error is thrown. To traverse an image
+    // without copying it, map the file and use ImageView instead.
+    void load(int fd) {
+        static_assert(std::is_trivially_copyable<T>::value, "list images copy values as bytes");
+        arrlist::ImageReader in(fd);
+        arrlist::ImageHeader h{};
+        in.array(&h, 1);
+        arrlist::check_image_header(h, arrlist::ImageLayout::FastSoa, sizeof(T), alignof(T));
+        if (h.free_list != FreeList::kImageTag) {
+            throw std::runtime_error("list image was written with a different free-list policy");
+        }
+        const auto cap = static_cast<std::size_t>(h.capacity);
+        ArrayLinkedList loaded(cap, values_.get_allocator());
+        in.array(loaded.values_.data(), cap);
+        in.array(loaded.next_.data(), cap);
+        in.array(loaded.prev_.data(), cap);
+        in.array(loaded.generations_.data(), cap);
+        loaded.free_list_.load_image(in, cap);
+        loaded.head_ = static_cast<int>(h.head);
+        loaded.tail_ = static_cast<int>(h.tail);
+        loaded.size_ = static_cast<std::size_t>(h.size);
+        loaded.contiguous_ = (h.flags & arrlist::kImageContiguous) != 0;
+        if (loaded.size_ + loaded.free_list_.size() != cap) {
+            throw std::runtime_error("list image size and free list do not add up to its capacity");
+        }
+        *this = std::move(loaded);
+    }
 
     // Lightweight iteration helpers for tight loops (unchecked).
     int head_index_unchecked() const { return head_; }
@@ -180,6 +812,7 @@ public:
 
     template <typename Fn>
     void for_each_value_unchecked(Fn&& fn) const {
+        Stats::on_traverse(size_);
         for (int idx = head_; idx != kNull; idx = next_[idx]) {
             fn(values_[idx]);
         }
@@ -188,13 +821,65 @@ public:
 private:
     static constexpr int kNull = -1;
 
-    template <typename... Args>
-    NodeHandle allocate_node(Args&&... args) {
-        if (free_list_.empty()) {
-            throw std::overflow_error("no free slots left in the list");
+    static void prefetch(const void* p) { __builtin_prefetch(p, 1); }
+
+    // Fields the AVX2 gather path handles: 4-byte integers inside a T whose
+    // size is a multiple of 4, so field addresses are base + index * stride.
+    template <typename F>
+    static constexpr bool kGatherable =
+#if defined(__AVX2__)
+        std::is_integral<F>::value && sizeof(F) == 4 && sizeof(T) % 4 == 0;
+#else
+        false;
+#endif
+
+    template <typename F>
+    field_sum_t<F> gather_sum(F T::*member, const int* indices, std::size_t n) const {
+        using Acc = field_sum_t<F>;
+        const int* field = reinterpret_cast<const int*>(reinterpret_cast<const char*>(&(values_[0].*member)));
+        std::size_t i = 0;
+        Acc sum = 0;
+#if defined(__AVX2__)
+        const __m256i stride = _mm256_set1_epi32(static_cast<int>(sizeof(T) / 4));
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 8 <= n; i += 8) {
+            const __m256i vidx = _mm256_mullo_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i)), stride);
+            const __m256i v = _mm256_i32gather_epi32(field, vidx, 4);
+            const __m128i lo = _mm256_castsi256_si128(v);
+            const __m128i hi = _mm256_extracti128_si256(v, 1);
+            if constexpr (std::is_signed<F>::value) {
+                acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(lo));
+                acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(hi));
+            } else {
+                acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(lo));
+                acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(hi));
+            }
         }
-        const int idx = free_list_.back();
-        free_list_.pop_back();
+        alignas(32) std::int64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+        sum = static_cast<Acc>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+#endif
+        (void)field;
+        for (; i < n; ++i) {
+            sum += static_cast<Acc>(values_[indices[i]].*member);
+        }
+        return sum;
+    }
+
+    static std::size_t checked_capacity(std::size_t capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("capacity must be greater than zero");
+        }
+        return capacity;
+    }
+
+    // `hint` is the node the new slot will be linked next to.
+    template <typename... Args>
+    NodeHandle allocate_node(int hint, Args&&... args) {
+        CheckPolicy::template require<std::overflow_error>(!free_list_.empty(), "no free slots left in the list");
+        const int idx = free_list_.acquire(hint);
+        Stats::on_acquire(idx, hint);
+        Stats::on_size(size_ + 1);
         values_[idx] = T(std::forward<Args>(args)...);
         next_[idx] = kNull;
         prev_[idx] = kNull;
@@ -202,33 +887,158 @@ private:
         return NodeHandle{idx, generations_[idx]};
     }
 
+    // The generation moves on at release as well as at allocation, so a
+    // handle to a freed slot is stale right away, not only once the slot is
+    // reused: a second erase of the same handle is rejected.
     void release_node(int idx) {
         next_[idx] = kNull;
         prev_[idx] = kNull;
-        free_list_.push_back(idx);
+        ++generations_[idx];
+        free_list_.release(idx);
     }
 
-    void ensure_valid_handle(const NodeHandle& handle) const {
+    // Detaches a live node from its neighbours, leaving its own links stale.
+    void unlink(int idx) {
+        const int prev = prev_[idx];
+        const int next = next_[idx];
+        if (prev != kNull) {
+            next_[prev] = next;
+        } else {
+            head_ = next;
+        }
+        if (next != kNull) {
+            prev_[next] = prev;
+        } else {
+            tail_ = prev;
+        }
+    }
+
+    bool is_valid_handle(const NodeHandle& handle) const {
         const int idx = handle.index;
-        if (idx < 0 || static_cast<std::size_t>(idx) >= values_.size() || generations_[idx] != handle.generation) {
-            throw std::out_of_range("node handle is invalid or stale");
+        const bool valid =
+            idx >= 0 && static_cast<std::size_t>(idx) < values_.size() && generations_[idx] == handle.generation;
+        if (!valid) {
+            Stats::on_invalid_handle();
         }
+        return valid;
+    }
+
+    void ensure_valid_handle(const NodeHandle& handle) const {
+        CheckPolicy::template require<std::out_of_range>(is_valid_handle(handle), "node handle is invalid or stale");
     }
 
     void ensure_valid_node(int idx) const {
-        if (idx < 0 || static_cast<std::size_t>(idx) >= values_.size()) {
-            throw std::out_of_range("node index is invalid");
-        }
+        CheckPolicy::template require<std::out_of_range>(idx >= 0 && static_cast<std::size_t>(idx) < values_.size(),
+                                                         "node index is invalid");
     }
 
-    std::vector<T> values_;
-    std::vector<int> next_;
-    std::vector<int> prev_;
-    std::vector<std::uint32_t> generations_;
-    std::vector<int> free_list_;
+    std::vector<T, Allocator> values_;
+    std::vector<int, rebind_alloc<int>> next_;
+    std::vector<int, rebind_alloc<int>> prev_;
+    std::vector<std::uint32_t, rebind_alloc<std::uint32_t>> generations_;
+    FreeList free_list_;
     int head_ = kNull;
     int tail_ = kNull;
     std::size_t size_ = 0;
+    bool contiguous_ = true;
+};
+
+// Read-only list over an image written by ArrayLinkedList::save(), used in
+// place (typically an arrlist::MappedImage) without copying, so a restarted
+// reader can traverse a checkpoint as soon as the file is mapped. The image
+// must outlive the view. Same read API as the list, validated per List's
+// CheckPolicy; the free list is not consulted, so any policy's image works.
+template <typename List>
+class ImageView {
+    static_assert(alignof(typename List::value_type) <= arrlist::kImageAlign,
+                  "image sections are only aligned to kImageAlign");
+
+public:
+    using value_type = typename List::value_type;
+    using NodeHandle = typename List::NodeHandle;
+    using CheckPolicy = typename List::check_policy;
+
+    // Throws std::runtime_error if the header does not match List or the
+    // buffer is shorter than the arrays it describes.
+    ImageView(const void* data, std::size_t size) {
+        if (size < sizeof(arrlist::ImageHeader)) {
+            throw std::runtime_error("list image is truncated");
+        }
+        arrlist::ImageHeader h;
+        std::memcpy(&h, data, sizeof(h));
+        arrlist::check_image_header(h, arrlist::ImageLayout::FastSoa, sizeof(value_type), alignof(value_type));
+        capacity_ = static_cast<std::size_t>(h.capacity);
+        size_ = static_cast<std::size_t>(h.size);
+        head_ = static_cast<int>(h.head);
+        contiguous_ = (h.flags & arrlist::kImageContiguous) != 0;
+
+        const char* base = static_cast<const char*>(data);
+        std::size_t offset = arrlist::image_align_up(sizeof(h));
+        auto section = [&](std::size_t bytes) {
+            const char* p = base + offset;
+            offset = arrlist::image_align_up(offset + bytes);
+            return p;
+        };
+        values_ = reinterpret_cast<const value_type*>(section(capacity_ * sizeof(value_type)));
+        next_ = reinterpret_cast<const int*>(section(capacity_ * sizeof(int)));
+        section(capacity_ * sizeof(int)); // prev links: traversal is forward only
+        generations_ = reinterpret_cast<const std::uint32_t*>(section(capacity_ * sizeof(std::uint32_t)));
+        if (offset > size) {
+            throw std::runtime_error("list image is truncated");
+        }
+    }
+
+    std::size_t capacity() const { return capacity_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (int idx = head_; idx != kNull; idx = next_[idx]) {
+            fn(values_[idx], idx);
+        }
+    }
+
+    const value_type& at(int node_index) const {
+        CheckPolicy::template require<std::out_of_range>(
+            node_index >= 0 && static_cast<std::size_t>(node_index) < capacity_, "node index is invalid");
+        return values_[node_index];
+    }
+
+    bool is_valid(const NodeHandle& handle) const {
+        const int idx = handle.index;
+        return idx >= 0 && static_cast<std::size_t>(idx) < capacity_ && generations_[idx] == handle.generation;
+    }
+
+    const value_type& value(const NodeHandle& handle) const {
+        CheckPolicy::template require<std::out_of_range>(is_valid(handle), "node handle is invalid or stale");
+        return values_[handle.index];
+    }
+
+    bool is_contiguous() const { return contiguous_; }
+    const value_type* contiguous_values() const { return contiguous_ && head_ != kNull ? values_ + head_ : nullptr; }
+
+    int head_index_unchecked() const { return head_; }
+    int next_index_unchecked(int node_index) const { return next_[node_index]; }
+    const value_type& value_unchecked(int node_index) const { return values_[node_index]; }
+
+    template <typename Fn>
+    void for_each_value_unchecked(Fn&& fn) const {
+        for (int idx = head_; idx != kNull; idx = next_[idx]) {
+            fn(values_[idx]);
+        }
+    }
+
+private:
+    static constexpr int kNull = -1;
+
+    const value_type* values_ = nullptr;
+    const int* next_ = nullptr;
+    const std::uint32_t* generations_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t size_ = 0;
+    int head_ = kNull;
+    bool contiguous_ = false;
 };
 
 } // namespace arrlist_fast
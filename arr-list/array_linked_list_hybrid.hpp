@@ -0,0 +1,312 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace arrlist_hybrid {
+
+namespace detail {
+
+// Hot record for one node: links and generation packed together (12 bytes),
+// optionally followed by a copy of the fields of T marked hot.
+template <typename Hot>
+struct HotRecord {
+    int next;
+    int prev;
+    std::uint32_t generation;
+    Hot hot;
+};
+
+template <>
+struct HotRecord<void> {
+    int next;
+    int prev;
+    std::uint32_t generation;
+};
+
+template <typename T, typename HotFields>
+struct HotTypeOf {
+    using type = std::decay_t<decltype(HotFields::get(std::declval<const T&>()))>;
+};
+
+template <typename T>
+struct HotTypeOf<T, void> {
+    using type = void;
+};
+
+} // namespace detail
+
+// Array-backed doubly linked list with a hybrid (AoSoA-style) layout: the link
+// fields every operation touches live in one packed hot array, the payload T
+// lives in a separate cold array. Relinking touches one cache line per node
+// instead of three (SoA) and the payload no longer dilutes the link array (AoS).
+//
+// HotFields optionally names fields of T to mirror next to the links, e.g.
+//     struct OrderQty { static std::int32_t get(const Order& o) { return o.qty; } };
+// for_each_hot_unchecked() then walks only the hot array. The mirror is
+// refreshed on insert and through modify(); value() is read-only so the copy
+// cannot go stale.
+template <typename T, typename HotFields = void>
+class ArrayLinkedList {
+public:
+    using hot_type = typename detail::HotTypeOf<T, HotFields>::type;
+    static constexpr bool kHasHotFields = !std::is_void<hot_type>::value;
+
+    struct NodeHandle {
+        int index = -1;
+        std::uint32_t generation = 0;
+    };
+
+    explicit ArrayLinkedList(std::size_t capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("capacity must be greater than zero");
+        }
+        values_.resize(capacity);
+        links_.resize(capacity);
+        for (auto& link : links_) {
+            link.next = kNull;
+            link.prev = kNull;
+            link.generation = 0;
+        }
+        free_list_.reserve(capacity);
+        for (std::size_t i = capacity; i-- > 0;) {
+            free_list_.push_back(static_cast<int>(i));
+        }
+    }
+
+    std::size_t capacity() const { return values_.size(); }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Adds an element at the front and returns its handle.
+    template <typename... Args>
+    NodeHandle emplace_front(Args&&... args) {
+        NodeHandle handle = allocate_node(std::forward<Args>(args)...);
+        const int idx = handle.index;
+        links_[idx].prev = kNull;
+        links_[idx].next = head_;
+        if (head_ != kNull) {
+            links_[head_].prev = idx;
+        } else {
+            tail_ = idx;
+        }
+        head_ = idx;
+        ++size_;
+        return handle;
+    }
+
+    // Adds an element at the back and returns its handle.
+    template <typename... Args>
+    NodeHandle emplace_back(Args&&... args) {
+        NodeHandle handle = allocate_node(std::forward<Args>(args)...);
+        const int idx = handle.index;
+        links_[idx].next = kNull;
+        links_[idx].prev = tail_;
+        if (tail_ != kNull) {
+            links_[tail_].next = idx;
+        } else {
+            head_ = idx;
+        }
+        tail_ = idx;
+        ++size_;
+        return handle;
+    }
+
+    // Inserts a value after the given handle and returns the new handle.
+    template <typename... Args>
+    NodeHandle emplace_after(const NodeHandle& handle, Args&&... args) {
+        ensure_valid_handle(handle);
+        const int node_index = handle.index;
+        NodeHandle new_handle = allocate_node(std::forward<Args>(args)...);
+        const int idx = new_handle.index;
+        const int old_next = links_[node_index].next;
+        links_[idx].prev = node_index;
+        links_[idx].next = old_next;
+        links_[node_index].next = idx;
+        if (old_next != kNull) {
+            links_[old_next].prev = idx;
+        } else {
+            tail_ = idx;
+        }
+        ++size_;
+        return new_handle;
+    }
+
+    // Removes the first element and returns its value.
+    T pop_front() {
+        if (head_ == kNull) {
+            throw std::out_of_range("list is empty");
+        }
+        const int idx = head_;
+        head_ = links_[idx].next;
+        if (head_ != kNull) {
+            links_[head_].prev = kNull;
+        } else {
+            tail_ = kNull;
+        }
+        --size_;
+        T value = std::move(values_[idx]);
+        release_node(idx);
+        return value;
+    }
+
+    // Removes the node after the given handle.
+    void erase_after(const NodeHandle& handle) {
+        ensure_valid_handle(handle);
+        const int node_index = handle.index;
+        const int target = links_[node_index].next;
+        if (target == kNull) {
+            throw std::out_of_range("no node exists after the given index");
+        }
+        const int new_next = links_[target].next;
+        links_[node_index].next = new_next;
+        if (new_next != kNull) {
+            links_[new_next].prev = node_index;
+        } else {
+            tail_ = node_index;
+        }
+        --size_;
+        release_node(target);
+    }
+
+    // Removes a node by handle in O(1) time.
+    void erase(const NodeHandle& handle) {
+        ensure_valid_handle(handle);
+        const int node_index = handle.index;
+        const int prev = links_[node_index].prev;
+        const int next = links_[node_index].next;
+
+        if (prev != kNull) {
+            links_[prev].next = next;
+        } else {
+            head_ = next;
+        }
+
+        if (next != kNull) {
+            links_[next].prev = prev;
+        } else {
+            tail_ = prev;
+        }
+
+        --size_;
+        release_node(node_index);
+    }
+
+    // Iterates through the list, calling fn(value, index) for each element.
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        int idx = head_;
+        while (idx != kNull) {
+            fn(values_[idx], idx);
+            idx = links_[idx].next;
+        }
+    }
+
+    // Accessor for testing/benchmarking.
+    const T& at(int node_index) const {
+        ensure_valid_node(node_index);
+        return values_[node_index];
+    }
+
+    const T& value(const NodeHandle& handle) const {
+        ensure_valid_handle(handle);
+        return values_[handle.index];
+    }
+
+    // Updates a value in place via fn(T&) and refreshes its hot mirror.
+    template <typename Fn>
+    void modify(const NodeHandle& handle, Fn&& fn) {
+        ensure_valid_handle(handle);
+        fn(values_[handle.index]);
+        sync_hot(handle.index);
+    }
+
+    // Convenience push/insert wrappers preserving previous API names.
+    NodeHandle push_front(const T& value) { return emplace_front(value); }
+    NodeHandle push_back(const T& value) { return emplace_back(value); }
+    NodeHandle insert_after(const NodeHandle& handle, const T& value) { return emplace_after(handle, value); }
+
+    // Lightweight iteration helpers for tight loops (unchecked).
+    int head_index_unchecked() const { return head_; }
+    int next_index_unchecked(int node_index) const { return links_[node_index].next; }
+    const T& value_unchecked(int node_index) const { return values_[node_index]; }
+
+    template <typename Fn>
+    void for_each_value_unchecked(Fn&& fn) const {
+        for (int idx = head_; idx != kNull; idx = links_[idx].next) {
+            fn(values_[idx]);
+        }
+    }
+
+    // Walks only the hot array, calling fn(hot) per element. Available when
+    // HotFields is set.
+    template <typename Fn>
+    void for_each_hot_unchecked(Fn&& fn) const {
+        static_assert(kHasHotFields, "for_each_hot_unchecked requires HotFields");
+        for (int idx = head_; idx != kNull; idx = links_[idx].next) {
+            fn(links_[idx].hot);
+        }
+    }
+
+private:
+    using Record = detail::HotRecord<hot_type>;
+
+    static constexpr int kNull = -1;
+
+    void sync_hot(int idx) {
+        if constexpr (kHasHotFields) {
+            links_[idx].hot = HotFields::get(values_[idx]);
+        }
+    }
+
+    template <typename... Args>
+    NodeHandle allocate_node(Args&&... args) {
+        if (free_list_.empty()) {
+            throw std::overflow_error("no free slots left in the list");
+        }
+        const int idx = free_list_.back();
+        free_list_.pop_back();
+        values_[idx] = T(std::forward<Args>(args)...);
+        sync_hot(idx);
+        Record& link = links_[idx];
+        link.next = kNull;
+        link.prev = kNull;
+        ++link.generation;
+        return NodeHandle{idx, link.generation};
+    }
+
+    // Bumping the generation here too makes handles to a freed slot stale at
+    // once, so erasing the same handle twice is rejected.
+    void release_node(int idx) {
+        links_[idx].next = kNull;
+        links_[idx].prev = kNull;
+        ++links_[idx].generation;
+        free_list_.push_back(idx);
+    }
+
+    void ensure_valid_handle(const NodeHandle& handle) const {
+        const int idx = handle.index;
+        if (idx < 0 || static_cast<std::size_t>(idx) >= values_.size() || links_[idx].generation != handle.generation) {
+            throw std::out_of_range("node handle is invalid or stale");
+        }
+    }
+
+    void ensure_valid_node(int idx) const {
+        if (idx < 0 || static_cast<std::size_t>(idx) >= values_.size()) {
+            throw std::out_of_range("node index is invalid");
+        }
+    }
+
+    std::vector<T> values_;
+    std::vector<Record> links_;
+    std::vector<int> free_list_;
+    int head_ = kNull;
+    int tail_ = kNull;
+    std::size_t size_ = 0;
+};
+
+} // namespace arrlist_hybrid
@@ -0,0 +1,405 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace arrlist_pool {
+
+// Shared SoA node arena for many ArrayLinkedList instances. All lists drawing
+// from one pool share a single free list, so reserved memory is bounded by the
+// number of live nodes across every list rather than lists x capacity.
+template <typename T>
+class NodePool {
+public:
+    struct NodeHandle {
+        int index = -1;
+        std::uint32_t generation = 0;
+    };
+
+    explicit NodePool(std::size_t capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("capacity must be greater than zero");
+        }
+        values_.resize(capacity);
+        next_.assign(capacity, kNull);
+        prev_.assign(capacity, kNull);
+        generations_.assign(capacity, 0);
+        free_list_.reserve(capacity);
+        for (std::size_t i = capacity; i-- > 0;) {
+            free_list_.push_back(static_cast<int>(i));
+        }
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    std::size_t capacity() const { return values_.size(); }
+    std::size_t size() const { return values_.size() - free_list_.size(); }
+    std::size_t available() const { return free_list_.size(); }
+
+private:
+    template <typename>
+    friend class ArrayLinkedList;
+
+    static constexpr int kNull = -1;
+
+    template <typename... Args>
+    NodeHandle allocate_node(Args&&... args) {
+        if (free_list_.empty()) {
+            throw std::overflow_error("no free slots left in the pool");
+        }
+        const int idx = free_list_.back();
+        free_list_.pop_back();
+        values_[idx] = T(std::forward<Args>(args)...);
+        next_[idx] = kNull;
+        prev_[idx] = kNull;
+        ++generations_[idx];
+        return NodeHandle{idx, generations_[idx]};
+    }
+
+    // Bumping the generation here too makes handles to a freed slot stale at
+    // once, so erasing the same handle twice is rejected.
+    void release_node(int idx) {
+        next_[idx] = kNull;
+        prev_[idx] = kNull;
+        ++generations_[idx];
+        free_list_.push_back(idx);
+    }
+
+    void ensure_valid_handle(const NodeHandle& handle) const {
+        const int idx = handle.index;
+        if (idx < 0 || static_cast<std::size_t>(idx) >= values_.size() || generations_[idx] != handle.generation) {
+            throw std::out_of_range("node handle is invalid or stale");
+        }
+    }
+
+    void ensure_valid_node(int idx) const {
+        if (idx < 0 || static_cast<std::size_t>(idx) >= values_.size()) {
+            throw std::out_of_range("node index is invalid");
+        }
+    }
+
+    std::vector<T> values_;
+    std::vector<int> next_;
+    std::vector<int> prev_;
+    std::vector<std::uint32_t> generations_;
+    std::vector<int> free_list_;
+};
+
+// Doubly linked list whose nodes live in a shared NodePool. Same API as
+// arrlist_fast::ArrayLinkedList, but the list itself only owns head/tail/size.
+// Handles are pool-wide: passing a live handle that belongs to a different
+// list of the same pool is not detected.
+//
+// The list owns its nodes: destroying or clearing it returns them to the
+// pool, so the pool must outlive it. It is move-only, since a copy would
+// share the nodes; a moved-from list is empty and still tied to the pool.
+template <typename T>
+class ArrayLinkedList {
+public:
+    using Pool = NodePool<T>;
+    using NodeHandle = typename Pool::NodeHandle;
+
+    explicit ArrayLinkedList(Pool& pool) : pool_(&pool) {}
+
+    ArrayLinkedList(const ArrayLinkedList&) = delete;
+    ArrayLinkedList& operator=(const ArrayLinkedList&) = delete;
+
+    ArrayLinkedList(ArrayLinkedList&& other) noexcept
+        : pool_(other.pool_),
+          head_(std::exchange(other.head_, kNull)),
+          tail_(std::exchange(other.tail_, kNull)),
+          size_(std::exchange(other.size_, 0)) {}
+
+    ArrayLinkedList& operator=(ArrayLinkedList&& other) noexcept {
+        if (this != &other) {
+            clear();
+            pool_ = other.pool_;
+            head_ = std::exchange(other.head_, kNull);
+            tail_ = std::exchange(other.tail_, kNull);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~ArrayLinkedList() { clear(); }
+
+    std::size_t capacity() const { return pool_->capacity(); }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Returns every node to the pool; handles into the list become stale.
+    void clear() noexcept {
+        Pool& p = *pool_;
+        for (int idx = head_; idx != kNull;) {
+            const int next = p.next_[idx];
+            p.release_node(idx);
+            idx = next;
+        }
+        head_ = kNull;
+        tail_ = kNull;
+        size_ = 0;
+    }
+
+    // Adds an element at the front and returns its handle.
+    template <typename... Args>
+    NodeHandle emplace_front(Args&&... args) {
+        Pool& p = *pool_;
+        NodeHandle handle = p.allocate_node(std::forward<Args>(args)...);
+        const int idx = handle.index;
+        p.prev_[idx] = kNull;
+        p.next_[idx] = head_;
+        if (head_ != kNull) {
+            p.prev_[head_] = idx;
+        } else {
+            tail_ = idx;
+        }
+        head_ = idx;
+        ++size_;
+        return handle;
+    }
+
+    // Adds an element at the back and returns its handle.
+    template <typename... Args>
+    NodeHandle emplace_back(Args&&... args) {
+        Pool& p = *pool_;
+        NodeHandle handle = p.allocate_node(std::forward<Args>(args)...);
+        const int idx = handle.index;
+        p.next_[idx] = kNull;
+        p.prev_[idx] = tail_;
+        if (tail_ != kNull) {
+            p.next_[tail_] = idx;
+        } else {
+            head_ = idx;
+        }
+        tail_ = idx;
+        ++size_;
+        return handle;
+    }
+
+    // Inserts a value after the given handle and returns the new handle.
+    template <typename... Args>
+    NodeHandle emplace_after(const NodeHandle& handle, Args&&... args) {
+        Pool& p = *pool_;
+        p.ensure_valid_handle(handle);
+        const int node_index = handle.index;
+        NodeHandle new_handle = p.allocate_node(std::forward<Args>(args)...);
+        const int idx = new_handle.index;
+        const int old_next = p.next_[node_index];
+        p.prev_[idx] = node_index;
+        p.next_[idx] = old_next;
+        p.next_[node_index] = idx;
+        if (old_next != kNull) {
+            p.prev_[old_next] = idx;
+        } else {
+            tail_ = idx;
+        }
+        ++size_;
+        return new_handle;
+    }
+
+    // Inserts a value before the given handle and returns the new handle.
+    template <typename... Args>
+    NodeHandle emplace_before(const NodeHandle& handle, Args&&... args) {
+        Pool& p = *pool_;
+        p.ensure_valid_handle(handle);
+        const int node_index = handle.index;
+        NodeHandle new_handle = p.allocate_node(std::forward<Args>(args)...);
+        const int idx = new_handle.index;
+        const int old_prev = p.prev_[node_index];
+        p.next_[idx] = node_index;
+        p.prev_[idx] = old_prev;
+        p.prev_[node_index] = idx;
+        if (old_prev != kNull) {
+            p.next_[old_prev] = idx;
+        } else {
+            head_ = idx;
+        }
+        ++size_;
+        return new_handle;
+    }
+
+    // Relinks a node of this list at its back in O(1), keeping its slot,
+    // value and handle (a modify that loses queue priority).
+    void move_to_back(const NodeHandle& handle) {
+        pool_->ensure_valid_handle(handle);
+        if (handle.index == tail_) {
+            return;
+        }
+        unlink(handle.index);
+        --size_;
+        link_back(handle.index);
+    }
+
+    // Moves a node of `other` to the back of this list in O(1). Both lists
+    // share the pool, so the node keeps its slot and the handle stays valid:
+    // a price-changing modify moves the order to its new level without a
+    // free-list round trip. Throws std::invalid_argument for a list of another
+    // pool; that the handle belongs to `other` is not detected.
+    void splice(ArrayLinkedList& other, const NodeHandle& handle) {
+        if (other.pool_ != pool_) {
+            throw std::invalid_argument("cannot splice between lists of different pools");
+        }
+        pool_->ensure_valid_handle(handle);
+        if (&other == this) {
+            move_to_back(handle);
+            return;
+        }
+        other.unlink(handle.index);
+        --other.size_;
+        link_back(handle.index);
+    }
+
+    // Removes the first element and returns its value.
+    T pop_front() {
+        if (head_ == kNull) {
+            throw std::out_of_range("list is empty");
+        }
+        Pool& p = *pool_;
+        const int idx = head_;
+        head_ = p.next_[idx];
+        if (head_ != kNull) {
+            p.prev_[head_] = kNull;
+        } else {
+            tail_ = kNull;
+        }
+        --size_;
+        T value = std::move(p.values_[idx]);
+        p.release_node(idx);
+        return value;
+    }
+
+    // Removes the node after the given handle.
+    void erase_after(const NodeHandle& handle) {
+        Pool& p = *pool_;
+        p.ensure_valid_handle(handle);
+        const int node_index = handle.index;
+        const int target = p.next_[node_index];
+        if (target == kNull) {
+            throw std::out_of_range("no node exists after the given index");
+        }
+        const int new_next = p.next_[target];
+        p.next_[node_index] = new_next;
+        if (new_next != kNull) {
+            p.prev_[new_next] = node_index;
+        } else {
+            tail_ = node_index;
+        }
+        --size_;
+        p.release_node(target);
+    }
+
+    // Removes a node by handle in O(1) time.
+    void erase(const NodeHandle& handle) {
+        Pool& p = *pool_;
+        p.ensure_valid_handle(handle);
+        const int node_index = handle.index;
+        const int prev = p.prev_[node_index];
+        const int next = p.next_[node_index];
+
+        if (prev != kNull) {
+            p.next_[prev] = next;
+        } else {
+            head_ = next;
+        }
+
+        if (next != kNull) {
+            p.prev_[next] = prev;
+        } else {
+            tail_ = prev;
+        }
+
+        --size_;
+        p.release_node(node_index);
+    }
+
+    // Iterates through the list, calling fn(value, index) for each element.
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        const Pool& p = *pool_;
+        int idx = head_;
+        while (idx != kNull) {
+            fn(p.values_[idx], idx);
+            idx = p.next_[idx];
+        }
+    }
+
+    // Accessor for testing/benchmarking.
+    const T& at(int node_index) const {
+        pool_->ensure_valid_node(node_index);
+        return pool_->values_[node_index];
+    }
+
+    // Handle-based access; lets owners update a node in place without relinking.
+    T& value(const NodeHandle& handle) {
+        pool_->ensure_valid_handle(handle);
+        return pool_->values_[handle.index];
+    }
+
+    const T& value(const NodeHandle& handle) const {
+        pool_->ensure_valid_handle(handle);
+        return pool_->values_[handle.index];
+    }
+
+    // Convenience push/insert wrappers preserving previous API names.
+    NodeHandle push_front(const T& value) { return emplace_front(value); }
+    NodeHandle push_back(const T& value) { return emplace_back(value); }
+    NodeHandle insert_after(const NodeHandle& handle, const T& value) { return emplace_after(handle, value); }
+    NodeHandle insert_before(const NodeHandle& handle, const T& value) { return emplace_before(handle, value); }
+
+    // Lightweight iteration helpers for tight loops (unchecked).
+    int head_index_unchecked() const { return head_; }
+    int next_index_unchecked(int node_index) const { return pool_->next_[node_index]; }
+    const T& value_unchecked(int node_index) const { return pool_->values_[node_index]; }
+
+    template <typename Fn>
+    void for_each_value_unchecked(Fn&& fn) const {
+        const Pool& p = *pool_;
+        for (int idx = head_; idx != kNull; idx = p.next_[idx]) {
+            fn(p.values_[idx]);
+        }
+    }
+
+private:
+    static constexpr int kNull = Pool::kNull;
+
+    // Detaches a node from its neighbours in this list; size is the caller's.
+    void unlink(int idx) {
+        Pool& p = *pool_;
+        const int prev = p.prev_[idx];
+        const int next = p.next_[idx];
+        if (prev != kNull) {
+            p.next_[prev] = next;
+        } else {
+            head_ = next;
+        }
+        if (next != kNull) {
+            p.prev_[next] = prev;
+        } else {
+            tail_ = prev;
+        }
+    }
+
+    void link_back(int idx) {
+        Pool& p = *pool_;
+        p.next_[idx] = kNull;
+        p.prev_[idx] = tail_;
+        if (tail_ != kNull) {
+            p.next_[tail_] = idx;
+        } else {
+            head_ = idx;
+        }
+        tail_ = idx;
+        ++size_;
+    }
+
+    Pool* pool_;
+    int head_ = kNull;
+    int tail_ = kNull;
+    std::size_t size_ = 0;
+};
+
+} // namespace arrlist_pool
@@ -2,24 +2,36 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <stdexcept>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
 #include <utility>
 #include <vector>
 
+#include "check_policy.hpp"
+
 namespace arrlist_slow {
 
 // Array-backed doubly linked list using indices instead of pointers.
 // Supports O(1) push/pop front/back, insert after, and erase by node handle.
-// Uses a generation counter to detect stale handles.
-template <typename T>
+// Uses a generation counter to detect stale handles. CheckPolicy selects
+// throwing, assert-only or no validation (see check_policy.hpp). Allocator
+// (rebound to the node type) backs the node array, e.g. mem::PageAllocator
+// for huge pages at large capacities.
+template <typename T, typename CheckPolicy = arrlist::ThrowChecks, typename Allocator = std::allocator<T>>
 class ArrayLinkedList {
 public:
+    using allocator_type = Allocator;
+
     struct NodeHandle {
         int index = -1;
         std::uint32_t generation = 0;
     };
 
-    explicit ArrayLinkedList(std::size_t capacity) {
+    explicit ArrayLinkedList(std::size_t capacity, const Allocator& alloc = Allocator()) : nodes_(NodeAllocator(alloc)) {
         if (capacity == 0) {
             throw std::invalid_argument("capacity must be greater than zero");
         }
@@ -93,11 +105,130 @@ public:
     NodeHandle push_back(const T& value) { return emplace_back(value); }
     NodeHandle insert_after(const NodeHandle& handle, const T& value) { return emplace_after(handle, value); }
 
-    // Removes the first element and returns its value.
-    T pop_front() {
+    // Appends count values in one pass, splicing the top `count` free-list
+    // entries (contiguous slots after a sequential fill) onto the tail at once.
+    // One handle per value is written to handles_out when it is non-null.
+    // All-or-nothing: nothing is inserted if fewer than count slots are free.
+    void push_back_bulk(const T* values, std::size_t count, NodeHandle* handles_out = nullptr) {
+        if (count == 0) {
+            return;
+        }
+        CheckPolicy::template require<std::overflow_error>(free_list_.size() >= count, "not enough free slots for bulk insert");
+        int prev = tail_;
+        for (std::size_t i = 0; i < count; ++i) {
+            const int idx = free_list_[free_list_.size() - 1 - i];
+            Node& node = nodes_[idx];
+            node.value = values[i];
+            ++node.generation;
+            node.prev = prev;
+            if (prev != kNull) {
+                nodes_[prev].next = idx;
+            } else {
+                head_ = idx;
+            }
+            if (handles_out != nullptr) {
+                handles_out[i] = NodeHandle{idx, node.generation};
+            }
+            prev = idx;
+        }
+        free_list_.resize(free_list_.size() - count);
+        nodes_[prev].next = kNull;
+        tail_ = prev;
+        size_ += count;
+    }
+
+    // Erases count handles. Link entries of upcoming nodes and then of their
+    // neighbours are prefetched a few iterations ahead, so the unlink writes
+    // mostly hit lines that are already in flight.
+    void erase_bulk(const NodeHandle* handles, std::size_t count) {
+        constexpr std::size_t kAhead = 4;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (i + 2 * kAhead < count) {
+                const int idx = handles[i + 2 * kAhead].index;
+                if (idx >= 0 && static_cast<std::size_t>(idx) < nodes_.size()) {
+                    prefetch(&nodes_[idx]);
+                }
+            }
+            if (i + kAhead < count) {
+                const int idx = handles[i + kAhead].index;
+                if (idx >= 0 && static_cast<std::size_t>(idx) < nodes_.size()) {
+                    const int prev = nodes_[idx].prev;
+                    const int next = nodes_[idx].next;
+                    if (prev != kNull) {
+                        prefetch(&nodes_[prev]);
+                    }
+                    if (next != kNull) {
+                        prefetch(&nodes_[next]);
+                    }
+                }
+            }
+            erase(handles[i]);
+        }
+    }
+
+#if __cplusplus >= 202002L
+    void push_back_bulk(std::span<const T> values, NodeHandle* handles_out = nullptr) {
+        push_back_bulk(values.data(), values.size(), handles_out);
+    }
+
+    void erase_bulk(std::span<const NodeHandle> handles) { erase_bulk(handles.data(), handles.size()); }
+#endif
+
+    // Non-throwing variants: always validate, regardless of CheckPolicy, and
+    // report failure through the return value.
+    template <typename... Args>
+    std::optional<NodeHandle> try_emplace_front(Args&&... args) {
+        if (free_list_.empty()) {
+            return std::nullopt;
+        }
+        return emplace_front(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::optional<NodeHandle> try_emplace_back(Args&&... args) {
+        if (free_list_.empty()) {
+            return std::nullopt;
+        }
+        return emplace_back(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::optional<NodeHandle> try_emplace_after(const NodeHandle& handle, Args&&... args) {
+        if (free_list_.empty() || !is_valid_handle(handle)) {
+            return std::nullopt;
+        }
+        return emplace_after(handle, std::forward<Args>(args)...);
+    }
+
+    std::optional<T> try_pop_front() {
         if (head_ == kNull) {
-            throw std::out_of_range("list is empty");
+            return std::nullopt;
         }
+        return pop_front();
+    }
+
+    arrlist::Status try_erase_after(const NodeHandle& handle) {
+        if (!is_valid_handle(handle)) {
+            return arrlist::Status::InvalidHandle;
+        }
+        if (nodes_[handle.index].next == kNull) {
+            return arrlist::Status::NoNext;
+        }
+        erase_after(handle);
+        return arrlist::Status::Ok;
+    }
+
+    arrlist::Status try_erase(const NodeHandle& handle) {
+        if (!is_valid_handle(handle)) {
+            return arrlist::Status::InvalidHandle;
+        }
+        erase(handle);
+        return arrlist::Status::Ok;
+    }
+
+    // Removes the first element and returns its value.
+    T pop_front() {
+        CheckPolicy::template require<std::out_of_range>(head_ != kNull, "list is empty");
         const int idx = head_;
         head_ = nodes_[idx].next;
         if (head_ != kNull) {
@@ -116,9 +247,7 @@ public:
         ensure_valid_handle(handle);
         const int node_index = handle.index;
         const int target = nodes_[node_index].next;
-        if (target == kNull) {
-            throw std::out_of_range("no node exists after the given index");
-        }
+        CheckPolicy::template require<std::out_of_range>(target != kNull, "no node exists after the given index");
         const int new_next = nodes_[target].next;
         nodes_[node_index].next = new_next;
         if (new_next != kNull) {
@@ -169,6 +298,17 @@ public:
         return nodes_[node_index].value;
     }
 
+    // Handle-based access; lets owners update a node in place without relinking.
+    T& value(const NodeHandle& handle) {
+        ensure_valid_handle(handle);
+        return nodes_[handle.index].value;
+    }
+
+    const T& value(const NodeHandle& handle) const {
+        ensure_valid_handle(handle);
+        return nodes_[handle.index].value;
+    }
+
     // Lightweight iteration helpers for tight loops (unchecked).
     int head_index_unchecked() const { return head_; }
     int next_index_unchecked(int node_index) const { return nodes_[node_index].next; }
@@ -191,11 +331,11 @@ private:
 
     static constexpr int kNull = -1;
 
+    static void prefetch(const void* p) { __builtin_prefetch(p, 1); }
+
     template <typename... Args>
     NodeHandle allocate_node(Args&&... args) {
-        if (free_list_.empty()) {
-            throw std::overflow_error("no free slots left in the list");
-        }
+        CheckPolicy::template require<std::overflow_error>(!free_list_.empty(), "no free slots left in the list");
         const int idx = free_list_.back();
         free_list_.pop_back();
         nodes_[idx].value = T(std::forward<Args>(args)...);
@@ -205,26 +345,32 @@ private:
         return NodeHandle{idx, nodes_[idx].generation};
     }
 
+    // Bumping the generation here too makes handles to a freed slot stale at
+    // once, so erasing the same handle twice is rejected.
     void release_node(int idx) {
         nodes_[idx].next = kNull;
         nodes_[idx].prev = kNull;
+        ++nodes_[idx].generation;
         free_list_.push_back(idx);
     }
 
-    void ensure_valid_handle(const NodeHandle& handle) const {
+    bool is_valid_handle(const NodeHandle& handle) const {
         const int idx = handle.index;
-        if (idx < 0 || static_cast<std::size_t>(idx) >= nodes_.size() || nodes_[idx].generation != handle.generation) {
-            throw std::out_of_range("node handle is invalid or stale");
-        }
+        return idx >= 0 && static_cast<std::size_t>(idx) < nodes_.size() && nodes_[idx].generation == handle.generation;
+    }
+
+    void ensure_valid_handle(const NodeHandle& handle) const {
+        CheckPolicy::template require<std::out_of_range>(is_valid_handle(handle), "node handle is invalid or stale");
     }
 
     void ensure_valid_node(int idx) const {
-        if (idx < 0 || static_cast<std::size_t>(idx) >= nodes_.size()) {
-            throw std::out_of_range("node index is invalid");
-        }
+        CheckPolicy::template require<std::out_of_range>(idx >= 0 && static_cast<std::size_t>(idx) < nodes_.size(),
+                                                         "node index is invalid");
     }
 
-    std::vector<Node> nodes_;
+    using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+
+    std::vector<Node, NodeAllocator> nodes_;
     std::vector<int> free_list_;
     int head_ = kNull;
     int tail_ = kNull;
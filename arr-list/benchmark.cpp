@@ -1,14 +1,34 @@
 #include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
 #include <iostream>
 #include <limits>
 #include <list>
 #include <random>
+#include <span>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../common/bench_env.hpp"
+#include "../common/bench_harness.hpp"
+#include "../common/itch.hpp"
+#include "../common/page_allocator.hpp"
 #include "array_linked_list_slow_aos.hpp"
+#include "array_linked_list_compact.hpp"
 #include "array_linked_list_fast_soa.hpp"
+#include "array_linked_list_hybrid.hpp"
+#include "array_linked_list_pool.hpp"
+#include "list_stats.hpp"
+#include "order_index.hpp"
 
 template <typename T>
 using SlowArrayLinkedList = arrlist_slow::ArrayLinkedList<T>;
@@ -16,11 +36,67 @@ using SlowArrayLinkedList = arrlist_slow::ArrayLinkedList<T>;
 template <typename T>
 using FastArrayLinkedList = arrlist_fast::ArrayLinkedList<T>;
 
+// 16-bit links with 16+16 packed handles (4 bytes instead of 8).
+template <typename T>
+using CompactArrayLinkedList = arrlist_compact::ArrayLinkedList<T, 16, 16>;
+
+template <typename T>
+using BitmapArrayLinkedList = arrlist_fast::ArrayLinkedList<T, arrlist_fast::BitmapFreeList>;
+
+template <typename T, typename CheckPolicy>
+using SlowCheckedList = arrlist_slow::ArrayLinkedList<T, CheckPolicy>;
+
+template <typename T, typename CheckPolicy>
+using FastCheckedList = arrlist_fast::ArrayLinkedList<T, arrlist_fast::LifoFreeList, CheckPolicy>;
+
+template <typename T>
+using PooledArrayLinkedList = arrlist_pool::ArrayLinkedList<T>;
+
+// Fast soa lists with arrlist::CountingStats, for the untimed stats passes.
+template <typename T, typename FreeList>
+using CountingArrayLinkedList =
+    arrlist_fast::ArrayLinkedList<T, FreeList, arrlist::ThrowChecks, std::allocator<T>, arrlist::CountingStats>;
+
+// Slot arrays on explicitly sized pages (see ../common/page_allocator.hpp).
+template <typename T, mem::Pages Pages>
+using SlowPagedList = arrlist_slow::ArrayLinkedList<T, arrlist::ThrowChecks, mem::PageAllocator<T, Pages>>;
+
+template <typename T, mem::Pages Pages>
+using FastPagedList =
+    arrlist_fast::ArrayLinkedList<T, arrlist_fast::LifoFreeList, arrlist::ThrowChecks, mem::PageAllocator<T, Pages>>;
+
 struct Order {
     std::uint64_t id;
     std::int32_t qty;
 };
 
+// Marks Order::qty as hot for the hybrid layout so the qty sum only walks the
+// packed link array.
+struct OrderQtyHot {
+    static std::int32_t get(const Order& o) { return o.qty; }
+};
+
+template <typename T>
+using HybridArrayLinkedList = arrlist_hybrid::ArrayLinkedList<T>;
+
+template <typename T>
+using HybridHotQtyArrayLinkedList = arrlist_hybrid::ArrayLinkedList<T, OrderQtyHot>;
+
+template <typename List, typename = void>
+struct HasHotFields : std::false_type {};
+
+template <typename List>
+struct HasHotFields<List, std::enable_if_t<List::kHasHotFields>> : std::true_type {};
+
+// The hybrid list only hands out const values; writes go through modify() so
+// its hot mirror stays in sync.
+template <typename List, typename = void>
+struct HasModify : std::false_type {};
+
+template <typename List>
+struct HasModify<List, std::void_t<decltype(std::declval<List&>().modify(std::declval<typename List::NodeHandle>(),
+                                                                         [](Order&) {}))>> : std::true_type {};
+
 struct BenchmarkResult {
     std::string name;
     std::size_t operations = 0;
@@ -28,12 +104,13 @@ struct BenchmarkResult {
     double ms = 0.0;
     double ns_per_op = 0.0;
     std::uint64_t checksum = 0;
+    bench::LatencyHistogram latency; // filled only by the sampled run
 };
 
 // To keep the compiler from optimizing away iteration work.
 volatile std::uint64_t g_sink = 0;
 
-enum class Op { Add, Cancel, Iterate };
+enum class Op { Add, Cancel, Iterate, Modify };
 
 struct ChurnStep {
     Op op;
@@ -41,6 +118,15 @@ struct ChurnStep {
     Order order;            // valid when op == Add
 };
 
+// Step of the modify-heavy flow: Modify re-queues the order at pos at the
+// back of `level` (multi-level books; single queues ignore it).
+struct ModifyStep {
+    Op op;
+    std::size_t pos;    // valid when op == Cancel or Modify
+    std::uint32_t level;
+    Order order;        // valid when op == Add
+};
+
 template <typename List>
 class ArrayListBook {
 public:
@@ -77,6 +163,28 @@ public:
         handles_.pop_back();
     }
 
+    // Packet variants: one push_back_bulk/erase_bulk call per packet.
+    void add_bulk(std::span<const Order> orders) {
+        const std::size_t first = handles_.size();
+        handles_.resize(first + orders.size());
+        list_.push_back_bulk(orders, handles_.data() + first);
+    }
+
+    // Resolves positions with the same swap-remove bookkeeping as
+    // cancel_at_position, then erases the whole packet at once.
+    void cancel_bulk(std::span<const std::size_t> positions) {
+        batch_.clear();
+        for (std::size_t pos : positions) {
+            if (pos >= handles_.size()) {
+                continue;
+            }
+            batch_.push_back(handles_[pos]);
+            handles_[pos] = handles_.back();
+            handles_.pop_back();
+        }
+        list_.erase_bulk(std::span<const typename List::NodeHandle>(batch_));
+    }
+
 
     // std::uint64_t iterate_sum() const {
     //     std::uint64_t sum = 0;
@@ -86,15 +194,328 @@ public:
 
     std::uint64_t iterate_sum() const {
         std::uint64_t sum = 0;
-        list_.for_each_value_unchecked([&](const Order& o) { sum += static_cast<std::uint64_t>(o.qty); });
+        if constexpr (HasHotFields<List>::value) {
+            list_.for_each_hot_unchecked([&](std::int32_t qty) { sum += static_cast<std::uint64_t>(qty); });
+        } else {
+            list_.for_each_value_unchecked([&](const Order& o) { sum += static_cast<std::uint64_t>(o.qty); });
+        }
         return sum;
     }
 
+    // Sum over a contiguous list as a flat loop the compiler can vectorize.
+    std::uint64_t iterate_sum_contiguous() const {
+        const Order* orders = list_.contiguous_values();
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0, n = (orders != nullptr ? list_.size() : 0); i < n; ++i) {
+            sum += static_cast<std::uint64_t>(orders[i].qty);
+        }
+        return sum;
+    }
+
+    // Priority-losing modify of the order at pos, two ways: erase and re-add
+    // (new slot, new handle to store) or relink it with move_to_back.
+    void requeue_at_position(std::size_t pos) {
+        if (pos >= handles_.size()) {
+            return;
+        }
+        const Order order = list_.value(handles_[pos]);
+        list_.erase(handles_[pos]);
+        handles_[pos] = list_.push_back(order);
+    }
+
+    void move_to_back_at_position(std::size_t pos) {
+        if (pos < handles_.size()) {
+            list_.move_to_back(handles_[pos]);
+        }
+    }
+
+    // Reorders the list into slot order and translates every held handle.
+    void compact() {
+        const auto table = list_.compact();
+        for (auto& handle : handles_) {
+            handle = list_.remap(handle, table);
+        }
+    }
+
+    const List& list() const { return list_; }
+
 private:
     List list_;
     std::vector<typename List::NodeHandle> handles_;
+    std::vector<typename List::NodeHandle> batch_;
+};
+
+// std::unordered_map behind OrderIndex's interface, as the baseline index.
+template <typename Value>
+class StdOrderIndex {
+public:
+    explicit StdOrderIndex(std::size_t expected) { map_.reserve(expected); }
+
+    bool insert(std::uint64_t key, const Value& value) { return map_.emplace(key, value).second; }
+
+    bool take(std::uint64_t key, Value& out) {
+        auto it = map_.find(key);
+        if (it == map_.end()) {
+            return false;
+        }
+        out = it->second;
+        map_.erase(it);
+        return true;
+    }
+
+private:
+    std::unordered_map<std::uint64_t, Value> map_;
+};
+
+// ArrayListBook driven the way a feed handler is: cancels arrive by exchange
+// order id and go through an id -> handle index. ids_ only picks which live
+// order a step cancels; the timed cancel is the index lookup and erase plus
+// the list erase.
+template <typename List, typename Index>
+class IdIndexedBook {
+public:
+    explicit IdIndexedBook(std::size_t capacity) : list_(capacity), index_(capacity) { ids_.reserve(capacity); }
+
+    std::size_t size() const { return ids_.size(); }
+
+    void add(const Order& order) {
+        index_.insert(order.id, list_.push_back(order));
+        ids_.push_back(order.id);
+    }
+
+    void cancel_at_position(std::size_t pos) {
+        if (pos >= ids_.size()) {
+            return;
+        }
+        const std::uint64_t id = ids_[pos];
+        ids_[pos] = ids_.back();
+        ids_.pop_back();
+        typename List::NodeHandle handle;
+        if (index_.take(id, handle)) {
+            list_.erase(handle);
+        }
+    }
+
+private:
+    List list_;
+    Index index_;
+    std::vector<std::uint64_t> ids_;
 };
 
+// Spreads orders over many price levels with one list per level. Orders map to
+// levels by hashed id so every implementation sees the same distribution.
+template <typename List>
+class MultiLevelBook {
+public:
+    template <typename MakeList>
+    MultiLevelBook(std::size_t levels, std::size_t capacity, MakeList&& make_list) {
+        levels_.reserve(levels);
+        for (std::size_t i = 0; i < levels; ++i) {
+            levels_.push_back(make_list());
+        }
+        handles_.reserve(capacity);
+    }
+
+    std::size_t size() const { return handles_.size(); }
+
+    static std::size_t level_of(const Order& order, std::size_t levels) {
+        return static_cast<std::size_t>((order.id * 0x9E3779B97F4A7C15ull) >> 32) % levels;
+    }
+
+    void add(const Order& order) {
+        const std::size_t level = level_of(order, levels_.size());
+        auto handle = levels_[level].push_back(order);
+        handles_.push_back(Ref{static_cast<std::uint32_t>(level), handle});
+    }
+
+    void cancel_at_position(std::size_t pos) {
+        if (pos >= handles_.size()) {
+            return;
+        }
+        const Ref ref = handles_[pos];
+        levels_[ref.level].erase(ref.handle);
+        handles_[pos] = handles_.back();
+        handles_.pop_back();
+    }
+
+    // Price-changing modify: the order at pos goes to the back of another
+    // level, by erase and re-add or by splice (shared-pool lists only).
+    void requeue_at_position(std::size_t pos, std::size_t level) {
+        if (pos >= handles_.size()) {
+            return;
+        }
+        Ref& ref = handles_[pos];
+        const Order order = levels_[ref.level].value(ref.handle);
+        levels_[ref.level].erase(ref.handle);
+        ref.handle = levels_[level].push_back(order);
+        ref.level = static_cast<std::uint32_t>(level);
+    }
+
+    void splice_at_position(std::size_t pos, std::size_t level) {
+        if (pos >= handles_.size()) {
+            return;
+        }
+        Ref& ref = handles_[pos];
+        levels_[level].splice(levels_[ref.level], ref.handle);
+        ref.level = static_cast<std::uint32_t>(level);
+    }
+
+private:
+    struct Ref {
+        std::uint32_t level;
+        typename List::NodeHandle handle;
+    };
+
+    std::vector<List> levels_;
+    std::vector<Ref> handles_;
+};
+
+// Peak per-level occupancy over fill + churn, replaying the same swap-remove
+// bookkeeping MultiLevelBook uses. Per-list storage must reserve at least this.
+std::size_t peak_level_depth(std::size_t levels,
+                             const std::vector<Order>& fill_orders,
+                             const std::vector<ChurnStep>& steps) {
+    std::vector<std::size_t> depth(levels, 0);
+    std::vector<std::size_t> level_of_handle;
+    std::size_t peak = 0;
+    auto add = [&](const Order& o) {
+        const std::size_t level = MultiLevelBook<FastArrayLinkedList<Order>>::level_of(o, levels);
+        level_of_handle.push_back(level);
+        peak = std::max(peak, ++depth[level]);
+    };
+    for (const auto& o : fill_orders) {
+        add(o);
+    }
+    for (const auto& step : steps) {
+        if (step.op == Op::Add) {
+            add(step.order);
+        } else if (step.cancel_pos < level_of_handle.size()) {
+            --depth[level_of_handle[step.cancel_pos]];
+            level_of_handle[step.cancel_pos] = level_of_handle.back();
+            level_of_handle.pop_back();
+        }
+    }
+    return peak;
+}
+
+// Bytes reserved per SoA slot: value, next, prev, generation and free list entry.
+constexpr std::size_t soa_slot_bytes() {
+    return sizeof(Order) + 3 * sizeof(int) + sizeof(std::uint32_t);
+}
+
+// Physical layout of the list in link order: mean slot distance between
+// neighbours and the share of links that stay inside one 64-byte line of the
+// value array. Tells how scattered a traversal or an insert next to the tail is.
+struct Locality {
+    double avg_link_distance = 0.0;
+    double same_line_ratio = 0.0;
+};
+
+template <typename List>
+Locality measure_locality(const List& list) {
+    constexpr int kSlotsPerLine = static_cast<int>(64 / sizeof(Order)) > 0 ? static_cast<int>(64 / sizeof(Order)) : 1;
+    std::size_t links = 0;
+    std::size_t same_line = 0;
+    double distance = 0.0;
+    int idx = list.head_index_unchecked();
+    if (idx < 0) {
+        return {};
+    }
+    for (int next = list.next_index_unchecked(idx); next >= 0; idx = next, next = list.next_index_unchecked(idx)) {
+        distance += static_cast<double>(next > idx ? next - idx : idx - next);
+        same_line += (next / kSlotsPerLine) == (idx / kSlotsPerLine);
+        ++links;
+    }
+    if (links == 0) {
+        return {};
+    }
+    return Locality{distance / static_cast<double>(links), static_cast<double>(same_line) / static_cast<double>(links)};
+}
+
+// Same bookkeeping as ArrayListBook, but goes through the non-throwing
+// try_emplace_back/try_erase APIs and handles failures by return value.
+template <typename List>
+class TryArrayListBook {
+public:
+    explicit TryArrayListBook(std::size_t capacity) : list_(capacity) { handles_.reserve(capacity); }
+
+    std::size_t size() const { return handles_.size(); }
+
+    void add(const Order& order) {
+        if (auto handle = list_.try_emplace_back(order)) {
+            handles_.push_back(*handle);
+        }
+    }
+
+    void cancel_at_position(std::size_t pos) {
+        if (pos >= handles_.size()) {
+            return;
+        }
+        if (list_.try_erase(handles_[pos]) != arrlist::Status::Ok) {
+            return;
+        }
+        handles_[pos] = handles_.back();
+        handles_.pop_back();
+    }
+
+private:
+    List list_;
+    std::vector<typename List::NodeHandle> handles_;
+};
+
+// A cancel that arrives twice (a duplicated or replayed message) must be
+// rejected, not free the slot a second time: after push_back(a); erase(a),
+// try_erase(a) and try_erase_after(a) report InvalidHandle and the next two
+// inserts get distinct slots.
+template <typename List>
+void check_double_cancel(const std::string& name) {
+    List list(4);
+    const auto a = list.push_back(Order{1, 10});
+    list.erase(a);
+    if (list.try_erase(a) != arrlist::Status::InvalidHandle ||
+        list.try_erase_after(a) != arrlist::Status::InvalidHandle) {
+        throw std::runtime_error(name + ": a handle to an erased node still validates");
+    }
+    const auto b = list.push_back(Order{2, 20});
+    const auto c = list.push_back(Order{3, 30});
+    if (b.index == c.index || list.size() != 2) {
+        throw std::runtime_error(name + ": a double cancel released a slot twice");
+    }
+}
+
+// find_prefix_ge on an empty list, a contiguous one and one scattered by an
+// erase: a threshold <= 0 is met by the empty prefix, and a run of values
+// that overshoots the threshold and falls back is still found inside a block.
+void check_prefix() {
+    using List = FastArrayLinkedList<Order>;
+    auto expect = [](const List& list, std::int64_t threshold, std::size_t count, bool reached) {
+        const auto r = list.find_prefix_ge(&Order::qty, threshold);
+        if (r.count != count || r.reached != reached) {
+            throw std::runtime_error("find_prefix_ge(" + std::to_string(threshold) + ") consumed " +
+                                     std::to_string(r.count) + (r.reached ? " nodes, reached" : " nodes, not reached"));
+        }
+    };
+    List list(64);
+    expect(list, 0, 0, true);
+    expect(list, 1, 0, false);
+    // 5, then -1 x 15: the total reaches 5 at the first node and ends at -10.
+    const auto first = list.push_back(Order{0, 5});
+    List::NodeHandle middle;
+    for (std::uint64_t id = 1; id < 32; ++id) {
+        const auto h = list.push_back(Order{id, id < 16 ? -1 : 1});
+        middle = id == 20 ? h : middle;
+    }
+    expect(list, 0, 0, true);
+    expect(list, -3, 0, true);
+    expect(list, 5, 1, true);
+    expect(list, 7, 32, false);
+    list.erase(first);
+    expect(list, 1, 31, true);
+    list.erase(middle);
+    expect(list, 0, 0, true);
+    expect(list, 1, 30, false);
+}
+
 class StdListBook {
 public:
     using Iterator = std::list<Order>::iterator;
@@ -153,16 +574,19 @@ void preload(Book& book, const std::vector<Order>& orders) {
 
 template <typename Book>
 BenchmarkResult bench_fill(const std::string& name, Book& book, const std::vector<Order>& orders) {
+    bench::OpTimer timer;
     const auto start = std::chrono::steady_clock::now();
+    timer.start();
     for (const auto& o : orders) {
         book.add(o);
+        timer.lap();
     }
     const auto end = std::chrono::steady_clock::now();
     const double ms = std::chrono::duration<double, std::milli>(end - start).count();
     const double ns_per_op = (ms * 1e6) / static_cast<double>(orders.size());
     g_sink = static_cast<std::uint64_t>(book.size());
 
-    return BenchmarkResult{name, orders.size(), book.size(), ms, ns_per_op, g_sink};
+    return BenchmarkResult{name, orders.size(), book.size(), ms, ns_per_op, g_sink, timer.take()};
 }
 
 template <typename Book>
@@ -172,16 +596,19 @@ BenchmarkResult bench_erase(const std::string& name,
                             const std::vector<std::size_t>& cancel_positions) {
     preload(book, preload_orders);
 
+    bench::OpTimer timer;
     const auto start = std::chrono::steady_clock::now();
+    timer.start();
     for (std::size_t pos : cancel_positions) {
         book.cancel_at_position(pos);
+        timer.lap();
     }
     const auto end = std::chrono::steady_clock::now();
     const double ms = std::chrono::duration<double, std::milli>(end - start).count();
     const double ns_per_op = (ms * 1e6) / static_cast<double>(cancel_positions.size());
     g_sink = static_cast<std::uint64_t>(book.size());
 
-    return BenchmarkResult{name, cancel_positions.size(), book.size(), ms, ns_per_op, g_sink};
+    return BenchmarkResult{name, cancel_positions.size(), book.size(), ms, ns_per_op, g_sink, timer.take()};
 }
 
 template <typename Book>
@@ -191,20 +618,23 @@ BenchmarkResult bench_churn(const std::string& name,
                             const std::vector<ChurnStep>& steps) {
     preload(book, preload_orders);
 
+    bench::OpTimer timer;
     const auto start = std::chrono::steady_clock::now();
+    timer.start();
     for (const auto& step : steps) {
         if (step.op == Op::Add) {
             book.add(step.order);
         } else {
             book.cancel_at_position(step.cancel_pos);
         }
+        timer.lap();
     }
     const auto end = std::chrono::steady_clock::now();
     const double ms = std::chrono::duration<double, std::milli>(end - start).count();
     const double ns_per_op = (ms * 1e6) / static_cast<double>(steps.size());
     g_sink = static_cast<std::uint64_t>(book.size());
 
-    return BenchmarkResult{name, steps.size(), book.size(), ms, ns_per_op, g_sink};
+    return BenchmarkResult{name, steps.size(), book.size(), ms, ns_per_op, g_sink, timer.take()};
 }
 
 template <typename Book>
@@ -218,46 +648,426 @@ BenchmarkResult bench_iterate(const std::string& name,
     g_sink = book.iterate_sum();
 
     std::uint64_t checksum = 0;
+    bench::OpTimer timer;
     const auto start = std::chrono::steady_clock::now();
+    timer.start();
     for (std::size_t i = 0; i < iterations; ++i) {
         checksum += book.iterate_sum();
+        timer.lap();
     }
     const auto end = std::chrono::steady_clock::now();
     const double ms = std::chrono::duration<double, std::milli>(end - start).count();
     const double ns_per_op = (ms * 1e6) / static_cast<double>(iterations);
     g_sink = checksum;
 
-    return BenchmarkResult{name, iterations, book.size(), ms, ns_per_op, checksum};
+    return BenchmarkResult{name, iterations, book.size(), ms, ns_per_op, checksum, timer.take()};
+}
+
+// Adds, cancels and priority-losing modifies; requeue(book, step) applies a
+// Modify step.
+template <typename Book, typename Requeue>
+BenchmarkResult bench_modify(const std::string& name,
+                             Book& book,
+                             const std::vector<Order>& preload_orders,
+                             const std::vector<ModifyStep>& steps,
+                             Requeue&& requeue) {
+    preload(book, preload_orders);
+
+    bench::OpTimer timer;
+    const auto start = std::chrono::steady_clock::now();
+    timer.start();
+    for (const auto& step : steps) {
+        if (step.op == Op::Add) {
+            book.add(step.order);
+        } else if (step.op == Op::Cancel) {
+            book.cancel_at_position(step.pos);
+        } else {
+            requeue(book, step);
+        }
+        timer.lap();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    const double ns_per_op = (ms * 1e6) / static_cast<double>(steps.size());
+    g_sink = static_cast<std::uint64_t>(book.size());
+
+    return BenchmarkResult{name, steps.size(), book.size(), ms, ns_per_op, g_sink, timer.take()};
+}
+
+template <typename T>
+struct TypeTag {
+    using type = T;
+};
+
+// Batched counterparts of bench_fill/bench_erase/bench_churn: the same
+// messages delivered in packets of `batch` and applied with one bulk call per
+// packet. ns/op stays per message so rows compare directly.
+template <typename Book>
+BenchmarkResult bench_fill_batched(const std::string& name, Book& book, const std::vector<Order>& orders, std::size_t batch) {
+    bench::OpTimer timer;
+    const auto start = std::chrono::steady_clock::now();
+    timer.start();
+    for (std::size_t i = 0; i < orders.size(); i += batch) {
+        const std::size_t n = std::min(batch, orders.size() - i);
+        book.add_bulk(std::span<const Order>(orders.data() + i, n));
+        timer.lap_batch(n);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    const double ns_per_op = (ms * 1e6) / static_cast<double>(orders.size());
+    g_sink = static_cast<std::uint64_t>(book.size());
+
+    return BenchmarkResult{name, orders.size(), book.size(), ms, ns_per_op, g_sink, timer.take()};
+}
+
+template <typename Book>
+BenchmarkResult bench_erase_batched(const std::string& name,
+                                    Book& book,
+                                    const std::vector<Order>& preload_orders,
+                                    const std::vector<std::size_t>& cancel_positions,
+                                    std::size_t batch) {
+    preload(book, preload_orders);
+
+    bench::OpTimer timer;
+    const auto start = std::chrono::steady_clock::now();
+    timer.start();
+    for (std::size_t i = 0; i < cancel_positions.size(); i += batch) {
+        const std::size_t n = std::min(batch, cancel_positions.size() - i);
+        book.cancel_bulk(std::span<const std::size_t>(cancel_positions.data() + i, n));
+        timer.lap_batch(n);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    const double ns_per_op = (ms * 1e6) / static_cast<double>(cancel_positions.size());
+    g_sink = static_cast<std::uint64_t>(book.size());
+
+    return BenchmarkResult{name, cancel_positions.size(), book.size(), ms, ns_per_op, g_sink, timer.take()};
+}
+
+// Churn delivered as packets of one message type (see make_packet_churn).
+struct ChurnPacket {
+    Op op;
+    std::vector<Order> orders;           // valid when op == Add
+    std::vector<std::size_t> positions;  // valid when op == Cancel
+};
+
+template <typename Book>
+BenchmarkResult bench_churn_batched(const std::string& name,
+                                    Book& book,
+                                    const std::vector<Order>& preload_orders,
+                                    const std::vector<ChurnPacket>& packets) {
+    preload(book, preload_orders);
+
+    std::size_t ops = 0;
+    bench::OpTimer timer;
+    const auto start = std::chrono::steady_clock::now();
+    timer.start();
+    for (const auto& packet : packets) {
+        if (packet.op == Op::Add) {
+            book.add_bulk(packet.orders);
+            ops += packet.orders.size();
+            timer.lap_batch(packet.orders.size());
+        } else {
+            book.cancel_bulk(packet.positions);
+            ops += packet.positions.size();
+            timer.lap_batch(packet.positions.size());
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    const double ns_per_op = (ms * 1e6) / static_cast<double>(ops);
+    g_sink = static_cast<std::uint64_t>(book.size());
+
+    return BenchmarkResult{name, ops, book.size(), ms, ns_per_op, g_sink, timer.take()};
+}
+
+// Same message flow applied one message at a time, for the per-packet baseline.
+template <typename Book>
+BenchmarkResult bench_churn_packets_sequential(const std::string& name,
+                                               Book& book,
+                                               const std::vector<Order>& preload_orders,
+                                               const std::vector<ChurnPacket>& packets) {
+    preload(book, preload_orders);
+
+    std::size_t ops = 0;
+    bench::OpTimer timer;
+    const auto start = std::chrono::steady_clock::now();
+    timer.start();
+    for (const auto& packet : packets) {
+        if (packet.op == Op::Add) {
+            for (const auto& o : packet.orders) {
+                book.add(o);
+                timer.lap();
+            }
+            ops += packet.orders.size();
+        } else {
+            for (std::size_t pos : packet.positions) {
+                book.cancel_at_position(pos);
+                timer.lap();
+            }
+            ops += packet.positions.size();
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    const double ns_per_op = (ms * 1e6) / static_cast<double>(ops);
+    g_sink = static_cast<std::uint64_t>(book.size());
+
+    return BenchmarkResult{name, ops, book.size(), ms, ns_per_op, g_sink, timer.take()};
+}
+
+// Random add/cancel churn from full depth where every packet carries `batch`
+// messages of one type, like a feed packet of adds or of cancels.
+std::vector<ChurnPacket> make_packet_churn(std::size_t capacity,
+                                           std::size_t ops,
+                                           std::size_t batch,
+                                           const std::vector<Order>& orders) {
+    std::mt19937_64 rng(11);
+    std::bernoulli_distribution add_bias(0.5);
+    std::uniform_int_distribution<std::size_t> cancel_dist;
+    std::vector<ChurnPacket> packets;
+    std::size_t depth = capacity;
+    std::size_t order_idx = 0;
+    for (std::size_t done = 0; done < ops;) {
+        ChurnPacket packet;
+        const bool do_add = depth + batch <= capacity && (depth < batch || add_bias(rng));
+        packet.op = do_add ? Op::Add : Op::Cancel;
+        const std::size_t n = std::min({batch, ops - done, do_add ? capacity - depth : depth});
+        for (std::size_t i = 0; i < n; ++i) {
+            if (do_add) {
+                packet.orders.push_back(orders[order_idx++ % orders.size()]);
+                ++depth;
+            } else {
+                cancel_dist.param(std::uniform_int_distribution<std::size_t>::param_type{0, depth - 1});
+                packet.positions.push_back(cancel_dist(rng));
+                --depth;
+            }
+        }
+        done += n;
+        packets.push_back(std::move(packet));
+    }
+    return packets;
+}
+
+// Times `iterations` calls of sum(book) on an already prepared book.
+template <typename Book, typename Sum>
+BenchmarkResult bench_iterate_prepared(const std::string& name, const Book& book, std::size_t iterations, Sum&& sum) {
+    g_sink = sum(book);
+
+    std::uint64_t checksum = 0;
+    bench::OpTimer timer;
+    const auto start = std::chrono::steady_clock::now();
+    timer.start();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        checksum += sum(book);
+        timer.lap();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    const double ns_per_op = (ms * 1e6) / static_cast<double>(iterations);
+    g_sink = checksum;
+
+    return BenchmarkResult{name, iterations, book.size(), ms, ns_per_op, checksum, timer.take()};
 }
 
 struct RunSummary {
     BenchmarkResult best;
     BenchmarkResult worst;
+    bench::LatencyHistogram latency;
+    bench::Interference interference; // over all runs, sampled one included
+    bench::PerfSample best_perf;      // --perf counts of the best and worst runs
+    bench::PerfSample worst_perf;
+    std::vector<std::pair<std::string, double>> counters; // exported with the record
 };
 
+// Wall-clock best/worst over `runs` unsampled runs, then one extra run with
+// per-operation timestamps for the latency distribution. Sampling has its own
+// run because a timer read costs about as much as the cheaper operations.
 template <typename Fn>
 RunSummary run_best_and_worst(std::size_t runs, Fn&& fn) {
     RunSummary summary;
+    const bench::Interference before = bench::interference_now();
     summary.best.ms = std::numeric_limits<double>::max();
     summary.worst.ms = 0.0;
     for (std::size_t i = 0; i < runs; ++i) {
         auto r = fn();
+        const bench::PerfSample perf = bench::last_perf_sample();
         if (r.ms < summary.best.ms) {
             summary.best = r;
+            summary.best_perf = perf;
         }
         if (r.ms > summary.worst.ms) {
             summary.worst = r;
+            summary.worst_perf = perf;
         }
     }
+    bench::ScopedSampling sampling(1);
+    summary.latency = fn().latency;
+    summary.interference = bench::interference_now() - before;
     return summary;
 }
 
-int main() {
-    const std::size_t capacity = 32 * 1024;
+// One price level's queue driven by order id, as a feed handler holds it:
+// ITCH messages name orders, not queue positions. Partial executions and
+// cancels shrink the order in place; replaces lose priority.
+template <typename List>
+class ReplayListBook {
+public:
+    explicit ReplayListBook(std::size_t capacity) : list_(capacity) { ids_.reserve(capacity); }
+
+    std::size_t size() const { return ids_.size(); }
+
+    void apply(const itch::Event& e) {
+        switch (e.kind) {
+        case itch::Kind::Add:
+            ids_.emplace(e.order_id, list_.emplace_back(Order{e.order_id, static_cast<std::int32_t>(e.shares)}));
+            break;
+        case itch::Kind::Execute:
+        case itch::Kind::Cancel:
+            reduce(e.order_id, e.shares);
+            break;
+        case itch::Kind::Delete:
+            remove(e.order_id);
+            break;
+        case itch::Kind::Replace:
+            if (remove(e.order_id)) {
+                ids_.emplace(e.new_order_id,
+                             list_.emplace_back(Order{e.new_order_id, static_cast<std::int32_t>(e.shares)}));
+            }
+            break;
+        }
+    }
+
+    std::uint64_t iterate_sum() const {
+        std::uint64_t sum = 0;
+        list_.for_each_value_unchecked([&](const Order& o) { sum += static_cast<std::uint64_t>(o.qty); });
+        return sum;
+    }
+
+private:
+    void reduce(std::uint64_t id, std::uint32_t shares) {
+        auto it = ids_.find(id);
+        if (it == ids_.end()) {
+            return;
+        }
+        const std::int32_t qty = list_.value(it->second).qty;
+        if (static_cast<std::int64_t>(shares) < qty) {
+            const auto left = static_cast<std::int32_t>(qty - static_cast<std::int32_t>(shares));
+            if constexpr (HasModify<List>::value) {
+                list_.modify(it->second, [&](Order& o) { o.qty = left; });
+            } else {
+                list_.value(it->second).qty = left;
+            }
+            return;
+        }
+        list_.erase(it->second);
+        ids_.erase(it);
+    }
+
+    bool remove(std::uint64_t id) {
+        auto it = ids_.find(id);
+        if (it == ids_.end()) {
+            return false;
+        }
+        list_.erase(it->second);
+        ids_.erase(it);
+        return true;
+    }
+
+    List list_;
+    std::unordered_map<std::uint64_t, typename List::NodeHandle> ids_;
+};
+
+// Writes an ITCH capture of one queue hovering around `depth` orders, shaped
+// like a real level rather than the uniform churn above: executions take the
+// head, most cancels hit recently added orders (geometric distance from the
+// tail), and some orders are partially cancelled or replaced.
+void write_queue_capture(const std::string& path, std::size_t depth, std::size_t ops) {
+    std::mt19937_64 rng(21);
+    std::uniform_real_distribution<double> op_dist(0.0, 1.0);
+    std::uniform_int_distribution<std::uint32_t> shares_dist(1, 10);
+    std::geometric_distribution<std::size_t> from_tail(8.0 / static_cast<double>(std::max<std::size_t>(depth, 8)));
+    constexpr std::uint16_t locate = 1;
+    constexpr std::uint32_t price = 100 * itch::kPriceScale;
+
+    itch::Writer out;
+    std::deque<std::pair<std::uint64_t, std::uint32_t>> queue; // id, remaining shares, in queue order
+    std::uint64_t next_id = 1;
+    std::uint64_t ts = 34'200'000'000'000; // 09:30
+    auto add = [&] {
+        const std::uint32_t shares = shares_dist(rng);
+        out.add(locate, ts, next_id, 'B', shares, price);
+        queue.emplace_back(next_id++, shares);
+    };
+    for (std::size_t i = 0; i < depth; ++i) {
+        add();
+    }
+    for (std::size_t i = 0; i < ops; ++i, ts += 1000) {
+        const double r = op_dist(rng);
+        const double add_ratio = queue.size() < depth ? 0.55 : 0.35;
+        if (queue.empty() || r < add_ratio) {
+            add();
+        } else if (r < add_ratio + 0.15) {
+            auto& head = queue.front();
+            const std::uint32_t shares = op_dist(rng) < 0.5 ? head.second : 1;
+            out.execute(locate, ts, head.first, shares);
+            if (shares >= head.second) {
+                queue.pop_front();
+            } else {
+                head.second -= shares;
+            }
+        } else {
+            const std::size_t back = std::min(from_tail(rng), queue.size() - 1);
+            const auto pos = queue.end() - 1 - static_cast<std::ptrdiff_t>(back);
+            const double kind = op_dist(rng);
+            if (kind < 0.1 && pos->second > 1) {
+                out.cancel(locate, ts, pos->first, 1);
+                --pos->second;
+            } else if (kind < 0.2) {
+                const std::uint32_t shares = shares_dist(rng);
+                out.replace(locate, ts, pos->first, next_id, shares, price);
+                queue.erase(pos);
+                queue.emplace_back(next_id++, shares);
+            } else {
+                out.remove(locate, ts, pos->first);
+                queue.erase(pos);
+            }
+        }
+    }
+    out.save(path);
+}
+
+template <typename Book>
+BenchmarkResult bench_replay(const std::string& name, Book& book, const itch::MappedFile& file,
+                             const itch::Profile& prof) {
+    bench::OpTimer timer;
+    const auto start = std::chrono::steady_clock::now();
+    timer.start();
+    itch::for_each_event(file.data(), file.size(), [&](const itch::Event& e) {
+        if (e.locate == prof.locate) {
+            book.apply(e);
+            timer.lap();
+        }
+    });
+    const auto end = std::chrono::steady_clock::now();
+    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    const double ns_per_op = (ms * 1e6) / static_cast<double>(std::max<std::size_t>(1, prof.events));
+    g_sink = book.iterate_sum();
+
+    return BenchmarkResult{name, prof.events, book.size(), ms, ns_per_op, g_sink, timer.take()};
+}
+
+// Every scenario at one depth. churn_ops and runs_per_case come from
+// --iters/--reps; traversal counts shrink with depth so each iteration case
+// visits about the same number of nodes.
+void run_scenarios(std::size_t capacity,
+                   std::size_t churn_ops,
+                   std::size_t runs_per_case,
+                   const bench::Options& opts,
+                   bench::Reporter& report) {
+    std::ostream& out = report.text();
     const std::size_t erase_ops = capacity;
-    const std::size_t churn_ops = 200'000;
-    const std::size_t iterate_loops = 2'000;
-    const std::size_t runs_per_case = 5;
+    const std::size_t iterate_loops = std::max<std::size_t>(1, 2'000 * (32 * 1024) / capacity);
 
     std::mt19937_64 rng_orders(42);
     std::uniform_int_distribution<int> qty_dist(1, 10);
@@ -313,15 +1123,48 @@ int main() {
         }
     }
 
-    auto print = [](const BenchmarkResult& r, const std::string& tag) {
-        std::cout << "  " << r.name << " [" << tag << "]\n"
-                  << "    final depth: " << r.final_depth << "\n"
-                  << "    time:        " << r.ms << " ms\n"
-                  << "    ns/op:       " << r.ns_per_op << "\n";
+    std::string scenario;
+    auto run_scenario = [&](const char* name) {
+        scenario = name;
+        return opts.selected(name);
+    };
+    auto misses_per_op = [](const bench::PerfSample& p, const BenchmarkResult& r) {
+        return static_cast<double>(p.cache_misses) / static_cast<double>(std::max<std::size_t>(1, r.operations));
+    };
+    auto record = [&](const RunSummary& r) {
+        bench::Record rec{scenario, r.best.name, capacity, r.best.operations, runs_per_case, r.best.ns_per_op,
+                          r.worst.ns_per_op, r.latency.summary(), r.interference.ctx_switches,
+                          r.interference.page_faults, r.counters};
+        if (r.best_perf.valid && r.worst_perf.valid) {
+            rec.counters.emplace_back("cache_misses_per_op", misses_per_op(r.best_perf, r.best));
+            rec.counters.emplace_back("worst_cache_misses_per_op", misses_per_op(r.worst_perf, r.worst));
+        }
+        report.add(std::move(rec));
+    };
+    // The 16-bit compact layout stops at 64k slots; deeper sweeps skip its
+    // cases (CompactArrayLinkedList only, not fast soa compact()).
+    const bool compact_fits = capacity <= CompactArrayLinkedList<Order>::max_capacity();
+    auto run_compact = [&](auto&& fn) { return compact_fits ? run_best_and_worst(runs_per_case, fn) : RunSummary(); };
+    auto print = [&](const RunSummary& r) {
+        if (r.best.name.empty()) {
+            return;
+        }
+        record(r);
+        out << "  " << r.best.name << "\n"
+            << "    final depth: " << r.best.final_depth << "\n"
+            << "    time:        " << r.best.ms << " ms best, " << r.worst.ms << " ms worst\n"
+            << "    ns/op:       " << r.best.ns_per_op << " best, " << r.worst.ns_per_op << " worst\n"
+            << "    latency:     " << r.latency.summary() << "\n"
+            << "    interrupted: " << r.interference.ctx_switches << " ctx switches, "
+            << r.interference.page_faults << " page faults\n";
+        if (r.best_perf.valid && r.worst_perf.valid) {
+            out << "    cache:       " << misses_per_op(r.best_perf, r.best) << " misses/op best run, "
+                << misses_per_op(r.worst_perf, r.worst) << " worst run\n";
+        }
     };
 
     // Scenario 1: fill to capacity.
-    {
+    if (run_scenario("fill")) {
         auto slow_result = run_best_and_worst(runs_per_case, [&] {
             ArrayListBook<SlowArrayLinkedList<Order>> slow_book(capacity);
             return bench_fill("slow aos fill", slow_book, fill_orders);
@@ -330,23 +1173,35 @@ int main() {
             ArrayListBook<FastArrayLinkedList<Order>> fast_book(capacity);
             return bench_fill("fast soa fill", fast_book, fill_orders);
         });
+        auto hybrid_result = run_best_and_worst(runs_per_case, [&] {
+            ArrayListBook<HybridArrayLinkedList<Order>> hybrid_book(capacity);
+            return bench_fill("hybrid fill", hybrid_book, fill_orders);
+        });
+        auto hybrid_hot_result = run_best_and_worst(runs_per_case, [&] {
+            ArrayListBook<HybridHotQtyArrayLinkedList<Order>> hybrid_hot_book(capacity);
+            return bench_fill("hybrid hot-qty fill", hybrid_hot_book, fill_orders);
+        });
+        auto compact_result = run_compact([&] {
+            ArrayListBook<CompactArrayLinkedList<Order>> compact_book(capacity);
+            return bench_fill("compact 16+16 fill", compact_book, fill_orders);
+        });
         auto list_result = run_best_and_worst(runs_per_case, [&] {
             StdListBook list_book(capacity);
             return bench_fill("std::list fill", list_book, fill_orders);
         });
 
-        std::cout << "Fill to capacity (" << capacity << " orders, best/worst of " << runs_per_case << ")\n";
-        print(slow_result.best, "best");
-        print(slow_result.worst, "worst");
-        print(fast_result.best, "best");
-        print(fast_result.worst, "worst");
-        print(list_result.best, "best");
-        print(list_result.worst, "worst");
-        std::cout << "\n";
+        out << "Fill to capacity (" << capacity << " orders, best/worst of " << runs_per_case << ")\n";
+        print(slow_result);
+        print(fast_result);
+        print(hybrid_result);
+        print(hybrid_hot_result);
+        print(compact_result);
+        print(list_result);
+        out << "\n";
     }
 
     // Scenario 2: random erase from full depth.
-    {
+    if (run_scenario("erase")) {
         auto slow_result = run_best_and_worst(runs_per_case, [&] {
             ArrayListBook<SlowArrayLinkedList<Order>> slow_book(capacity);
             return bench_erase("slow aos erase", slow_book, fill_orders, erase_positions);
@@ -355,23 +1210,35 @@ int main() {
             ArrayListBook<FastArrayLinkedList<Order>> fast_book(capacity);
             return bench_erase("fast soa erase", fast_book, fill_orders, erase_positions);
         });
+        auto hybrid_result = run_best_and_worst(runs_per_case, [&] {
+            ArrayListBook<HybridArrayLinkedList<Order>> hybrid_book(capacity);
+            return bench_erase("hybrid erase", hybrid_book, fill_orders, erase_positions);
+        });
+        auto hybrid_hot_result = run_best_and_worst(runs_per_case, [&] {
+            ArrayListBook<HybridHotQtyArrayLinkedList<Order>> hybrid_hot_book(capacity);
+            return bench_erase("hybrid hot-qty erase", hybrid_hot_book, fill_orders, erase_positions);
+        });
+        auto compact_result = run_compact([&] {
+            ArrayListBook<CompactArrayLinkedList<Order>> compact_book(capacity);
+            return bench_erase("compact 16+16 erase", compact_book, fill_orders, erase_positions);
+        });
         auto list_result = run_best_and_worst(runs_per_case, [&] {
             StdListBook list_book(capacity);
             return bench_erase("std::list erase", list_book, fill_orders, erase_positions);
         });
 
-        std::cout << "Random erase from full depth (" << erase_ops << " cancels, best/worst of " << runs_per_case << ")\n";
-        print(slow_result.best, "best");
-        print(slow_result.worst, "worst");
-        print(fast_result.best, "best");
-        print(fast_result.worst, "worst");
-        print(list_result.best, "best");
-        print(list_result.worst, "worst");
-        std::cout << "\n";
+        out << "Random erase from full depth (" << erase_ops << " cancels, best/worst of " << runs_per_case << ")\n";
+        print(slow_result);
+        print(fast_result);
+        print(hybrid_result);
+        print(hybrid_hot_result);
+        print(compact_result);
+        print(list_result);
+        out << "\n";
     }
 
     // Scenario 3: churn (random erase + insert) starting from full depth.
-    {
+    if (run_scenario("churn")) {
         auto slow_result = run_best_and_worst(runs_per_case, [&] {
             ArrayListBook<SlowArrayLinkedList<Order>> slow_book(capacity);
             return bench_churn("slow aos churn", slow_book, fill_orders, churn_steps);
@@ -380,23 +1247,122 @@ int main() {
             ArrayListBook<FastArrayLinkedList<Order>> fast_book(capacity);
             return bench_churn("fast soa churn", fast_book, fill_orders, churn_steps);
         });
+        auto hybrid_result = run_best_and_worst(runs_per_case, [&] {
+            ArrayListBook<HybridArrayLinkedList<Order>> hybrid_book(capacity);
+            return bench_churn("hybrid churn", hybrid_book, fill_orders, churn_steps);
+        });
+        auto hybrid_hot_result = run_best_and_worst(runs_per_case, [&] {
+            ArrayListBook<HybridHotQtyArrayLinkedList<Order>> hybrid_hot_book(capacity);
+            return bench_churn("hybrid hot-qty churn", hybrid_hot_book, fill_orders, churn_steps);
+        });
+        auto compact_result = run_compact([&] {
+            ArrayListBook<CompactArrayLinkedList<Order>> compact_book(capacity);
+            return bench_churn("compact 16+16 churn", compact_book, fill_orders, churn_steps);
+        });
+        auto bitmap_result = run_best_and_worst(runs_per_case, [&] {
+            ArrayListBook<BitmapArrayLinkedList<Order>> bitmap_book(capacity);
+            return bench_churn("fast soa bitmap churn", bitmap_book, fill_orders, churn_steps);
+        });
         auto list_result = run_best_and_worst(runs_per_case, [&] {
             StdListBook list_book(capacity);
             return bench_churn("std::list churn", list_book, fill_orders, churn_steps);
         });
 
-        std::cout << "Random erase/insert churn (" << churn_ops << " ops, best/worst of " << runs_per_case << ")\n";
-        print(slow_result.best, "best");
-        print(slow_result.worst, "worst");
-        print(fast_result.best, "best");
-        print(fast_result.worst, "worst");
-        print(list_result.best, "best");
-        print(list_result.worst, "worst");
-        std::cout << "\n";
+        // The same churn keyed by exchange-style ids: one feed-wide sequence,
+        // so a single book sees increasing ids with gaps (mean 32 here).
+        std::mt19937_64 rng_ids(2024);
+        std::geometric_distribution<std::uint64_t> id_gap(1.0 / 32.0);
+        std::vector<std::uint64_t> exchange_id(capacity + churn_ops + 1);
+        for (std::size_t i = 1, next = 0; i < exchange_id.size(); ++i) {
+            next += 1 + id_gap(rng_ids);
+            exchange_id[i] = next;
+        }
+        std::vector<Order> id_fill = fill_orders;
+        for (Order& o : id_fill) {
+            o.id = exchange_id[o.id];
+        }
+        std::vector<ChurnStep> id_steps = churn_steps;
+        for (ChurnStep& step : id_steps) {
+            if (step.op == Op::Add) {
+                step.order.id = exchange_id[step.order.id];
+            }
+        }
+        using FastList = FastArrayLinkedList<Order>;
+        using Handle = FastList::NodeHandle;
+        auto std_index_result = run_best_and_worst(runs_per_case, [&] {
+            IdIndexedBook<FastList, StdOrderIndex<Handle>> book(capacity);
+            return bench_churn("fast soa churn, cancel by id via std::unordered_map", book, id_fill, id_steps);
+        });
+        auto order_index_result = run_best_and_worst(runs_per_case, [&] {
+            IdIndexedBook<FastList, arrlist::OrderIndex<Handle>> book(capacity);
+            return bench_churn("fast soa churn, cancel by id via OrderIndex", book, id_fill, id_steps);
+        });
+
+        // Untimed replay of the same churn with arrlist::CountingStats, plus
+        // one walk of the final list: what each free-list policy does to the
+        // slots it hands out. Exported with the timed records.
+        auto list_stats = [&](auto list_tag) {
+            using List = typename decltype(list_tag)::type;
+            arrlist::CountingStats::reset();
+            ArrayListBook<List> book(capacity);
+            bench_churn("", book, fill_orders, churn_steps);
+            book.list().for_each_value_unchecked([](const Order&) {});
+            return arrlist::CountingStats::snapshot();
+        };
+        const arrlist::ListCounters lifo_stats =
+            list_stats(TypeTag<CountingArrayLinkedList<Order, arrlist_fast::LifoFreeList>>{});
+        const arrlist::ListCounters bitmap_stats =
+            list_stats(TypeTag<CountingArrayLinkedList<Order, arrlist_fast::BitmapFreeList>>{});
+        auto export_stats = [](RunSummary& r, const arrlist::ListCounters& c) {
+            r.counters.emplace_back("high_water", static_cast<double>(c.high_water));
+            r.counters.emplace_back("avg_reuse_distance", c.avg_reuse_distance());
+            r.counters.emplace_back("avg_traversal", c.avg_traversal());
+            r.counters.emplace_back("invalid_handles", static_cast<double>(c.invalid_handles));
+        };
+        export_stats(fast_result, lifo_stats);
+        export_stats(bitmap_result, bitmap_stats);
+
+        out << "Random erase/insert churn (" << churn_ops << " ops, best/worst of " << runs_per_case << ")\n";
+        print(slow_result);
+        print(fast_result);
+        print(hybrid_result);
+        print(hybrid_hot_result);
+        print(compact_result);
+        print(bitmap_result);
+        print(list_result);
+        print(std_index_result);
+        print(order_index_result);
+
+        // Layout after the churn, untimed: LIFO reuse vs nearest-to-tail reuse.
+        auto print_locality = [&](const std::string& name, const Locality& l) {
+            out << "  " << name << " locality after churn\n"
+                << "    avg link distance: " << l.avg_link_distance << " slots\n"
+                << "    same-line links:   " << l.same_line_ratio * 100.0 << " %\n";
+        };
+        auto print_stats = [&](const std::string& name, const arrlist::ListCounters& c) {
+            out << "  " << name << " list stats over the churn\n"
+                << "    high-water size:   " << c.high_water << "\n"
+                << "    reuse distance:    " << c.avg_reuse_distance() << " slots from the neighbour, avg\n"
+                << "    traversal length:  " << c.avg_traversal() << " nodes, avg\n"
+                << "    invalid handles:   " << c.invalid_handles << "\n";
+        };
+        {
+            ArrayListBook<FastArrayLinkedList<Order>> fast_book(capacity);
+            bench_churn("", fast_book, fill_orders, churn_steps);
+            print_locality("fast soa lifo", measure_locality(fast_book.list()));
+            print_stats("fast soa lifo", lifo_stats);
+        }
+        {
+            ArrayListBook<BitmapArrayLinkedList<Order>> bitmap_book(capacity);
+            bench_churn("", bitmap_book, fill_orders, churn_steps);
+            print_locality("fast soa bitmap", measure_locality(bitmap_book.list()));
+            print_stats("fast soa bitmap", bitmap_stats);
+        }
+        out << "\n";
     }
 
     // Scenario 4: pure iteration over a full bucket.
-    {
+    if (run_scenario("iterate")) {
         auto slow_result = run_best_and_worst(runs_per_case, [&] {
             ArrayListBook<SlowArrayLinkedList<Order>> slow_book(capacity);
             return bench_iterate("slow aos iterate", slow_book, fill_orders, iterate_loops);
@@ -405,20 +1371,544 @@ int main() {
             ArrayListBook<FastArrayLinkedList<Order>> fast_book(capacity);
             return bench_iterate("fast soa iterate", fast_book, fill_orders, iterate_loops);
         });
+        auto hybrid_result = run_best_and_worst(runs_per_case, [&] {
+            ArrayListBook<HybridArrayLinkedList<Order>> hybrid_book(capacity);
+            return bench_iterate("hybrid iterate", hybrid_book, fill_orders, iterate_loops);
+        });
+        auto hybrid_hot_result = run_best_and_worst(runs_per_case, [&] {
+            ArrayListBook<HybridHotQtyArrayLinkedList<Order>> hybrid_hot_book(capacity);
+            return bench_iterate("hybrid hot-qty iterate", hybrid_hot_book, fill_orders, iterate_loops);
+        });
+        auto compact_result = run_compact([&] {
+            ArrayListBook<CompactArrayLinkedList<Order>> compact_book(capacity);
+            return bench_iterate("compact 16+16 iterate", compact_book, fill_orders, iterate_loops);
+        });
         auto list_result = run_best_and_worst(runs_per_case, [&] {
             StdListBook list_book(capacity);
             return bench_iterate("std::list iterate", list_book, fill_orders, iterate_loops);
         });
 
-        std::cout << "Pure iteration over full depth (" << iterate_loops << " traversals, best/worst of " << runs_per_case << ")\n";
-        print(slow_result.best, "best");
-        print(slow_result.worst, "worst");
-        print(fast_result.best, "best");
-        print(fast_result.worst, "worst");
-        print(list_result.best, "best");
-        print(list_result.worst, "worst");
-        std::cout << "\n";
+        out << "Pure iteration over full depth (" << iterate_loops << " traversals, best/worst of " << runs_per_case << ")\n";
+        print(slow_result);
+        print(fast_result);
+        print(hybrid_result);
+        print(hybrid_hot_result);
+        print(compact_result);
+        print(list_result);
+        out << "\n";
     }
 
+    // Scenario 5: many price levels, per-list storage vs one shared node pool.
+    for (std::size_t levels : {1024, 4096}) {
+        if (!run_scenario("multi-level")) {
+            break;
+        }
+        // Per-list storage gets 2x the observed per-level peak; a real book has
+        // to guess this up front, the pool only needs the total depth.
+        const std::size_t level_capacity = 2 * peak_level_depth(levels, fill_orders, churn_steps);
+        using PerList = MultiLevelBook<FastArrayLinkedList<Order>>;
+        using Pooled = MultiLevelBook<PooledArrayLinkedList<Order>>;
+        auto make_per_list = [&] { return PerList(levels, capacity, [&] { return FastArrayLinkedList<Order>(level_capacity); }); };
+
+        auto per_list_fill = run_best_and_worst(runs_per_case, [&] {
+            PerList book = make_per_list();
+            return bench_fill("per-list fill", book, fill_orders);
+        });
+        auto pooled_fill = run_best_and_worst(runs_per_case, [&] {
+            arrlist_pool::NodePool<Order> pool(capacity);
+            Pooled book(levels, capacity, [&] { return PooledArrayLinkedList<Order>(pool); });
+            return bench_fill("pooled fill", book, fill_orders);
+        });
+        auto per_list_erase = run_best_and_worst(runs_per_case, [&] {
+            PerList book = make_per_list();
+            return bench_erase("per-list erase", book, fill_orders, erase_positions);
+        });
+        auto pooled_erase = run_best_and_worst(runs_per_case, [&] {
+            arrlist_pool::NodePool<Order> pool(capacity);
+            Pooled book(levels, capacity, [&] { return PooledArrayLinkedList<Order>(pool); });
+            return bench_erase("pooled erase", book, fill_orders, erase_positions);
+        });
+        auto per_list_churn = run_best_and_worst(runs_per_case, [&] {
+            PerList book = make_per_list();
+            return bench_churn("per-list churn", book, fill_orders, churn_steps);
+        });
+        auto pooled_churn = run_best_and_worst(runs_per_case, [&] {
+            arrlist_pool::NodePool<Order> pool(capacity);
+            Pooled book(levels, capacity, [&] { return PooledArrayLinkedList<Order>(pool); });
+            return bench_churn("pooled churn", book, fill_orders, churn_steps);
+        });
+
+        const double per_list_mb = static_cast<double>(levels * level_capacity * soa_slot_bytes()) / (1024.0 * 1024.0);
+        const double pooled_mb = static_cast<double>(capacity * soa_slot_bytes()) / (1024.0 * 1024.0);
+        out << "Multi-level fill/erase/churn (" << levels << " levels, " << level_capacity
+            << " slots/level, best/worst of " << runs_per_case << ")\n"
+            << "  reserved: per-list " << per_list_mb << " MB, pooled " << pooled_mb << " MB\n";
+        print(per_list_fill);
+        print(pooled_fill);
+        print(per_list_erase);
+        print(pooled_erase);
+        print(per_list_churn);
+        print(pooled_churn);
+        out << "\n";
+    }
+
+    // Scenario 6: cancel path cost per validation policy.
+    if (run_scenario("check-policy")) {
+        auto run_erase = [&](auto book_tag, const std::string& name) {
+            using Book = typename decltype(book_tag)::type;
+            return run_best_and_worst(runs_per_case, [&] {
+                Book book(capacity);
+                return bench_erase(name, book, fill_orders, erase_positions);
+            });
+        };
+        using arrlist::AssertChecks;
+        using arrlist::NoChecks;
+        using arrlist::ThrowChecks;
+        const RunSummary results[] = {
+            run_erase(TypeTag<ArrayListBook<SlowCheckedList<Order, ThrowChecks>>>{}, "slow aos erase throw"),
+            run_erase(TypeTag<ArrayListBook<SlowCheckedList<Order, AssertChecks>>>{}, "slow aos erase assert"),
+            run_erase(TypeTag<ArrayListBook<SlowCheckedList<Order, NoChecks>>>{}, "slow aos erase unchecked"),
+            run_erase(TypeTag<TryArrayListBook<SlowCheckedList<Order, NoChecks>>>{}, "slow aos try_erase"),
+            run_erase(TypeTag<ArrayListBook<FastCheckedList<Order, ThrowChecks>>>{}, "fast soa erase throw"),
+            run_erase(TypeTag<ArrayListBook<FastCheckedList<Order, AssertChecks>>>{}, "fast soa erase assert"),
+            run_erase(TypeTag<ArrayListBook<FastCheckedList<Order, NoChecks>>>{}, "fast soa erase unchecked"),
+            run_erase(TypeTag<TryArrayListBook<FastCheckedList<Order, NoChecks>>>{}, "fast soa try_erase"),
+        };
+
+        check_double_cancel<SlowCheckedList<Order, NoChecks>>("slow aos");
+        check_double_cancel<FastCheckedList<Order, NoChecks>>("fast soa");
+
+        out << "Cancel path by check policy (" << erase_ops << " cancels, best/worst of " << runs_per_case
+#ifdef NDEBUG
+            << ", NDEBUG"
+#endif
+            << ")\n";
+        for (const auto& r : results) {
+            print(r);
+        }
+        out << "  double cancel: try_erase rejects the erased handle on slow aos and fast soa\n\n";
+    }
+
+    // Scenario 7: packet-sized bulk insert/erase vs one call per message.
+    if (run_scenario("batched")) {
+        auto print_row = [&](const RunSummary& r) {
+            record(r);
+            const bench::LatencySummary l = r.latency.summary();
+            out << "  " << r.best.name << ": " << r.best.ns_per_op << " ns/op (worst " << r.worst.ns_per_op
+                << "), p50 " << l.p50 << " / p99 " << l.p99 << " / p99.9 " << l.p999 << " ns\n";
+        };
+        out << "Batched fill/erase/churn (" << churn_ops << " churn ops, best/worst of " << runs_per_case << ")\n";
+        for (std::size_t batch : {1, 8, 16, 32, 64}) {
+            const std::string tag = " x" + std::to_string(batch);
+            const auto packets = make_packet_churn(capacity, churn_ops, batch, churn_orders);
+            print_row(run_best_and_worst(runs_per_case, [&] {
+                ArrayListBook<SlowArrayLinkedList<Order>> book(capacity);
+                return bench_fill_batched("slow aos bulk fill" + tag, book, fill_orders, batch);
+            }));
+            print_row(run_best_and_worst(runs_per_case, [&] {
+                ArrayListBook<FastArrayLinkedList<Order>> book(capacity);
+                return bench_fill_batched("fast soa bulk fill" + tag, book, fill_orders, batch);
+            }));
+            print_row(run_best_and_worst(runs_per_case, [&] {
+                ArrayListBook<SlowArrayLinkedList<Order>> book(capacity);
+                return bench_erase_batched("slow aos bulk erase" + tag, book, fill_orders, erase_positions, batch);
+            }));
+            print_row(run_best_and_worst(runs_per_case, [&] {
+                ArrayListBook<FastArrayLinkedList<Order>> book(capacity);
+                return bench_erase_batched("fast soa bulk erase" + tag, book, fill_orders, erase_positions, batch);
+            }));
+            print_row(run_best_and_worst(runs_per_case, [&] {
+                ArrayListBook<SlowArrayLinkedList<Order>> book(capacity);
+                return bench_churn_packets_sequential("slow aos per-msg churn" + tag, book, fill_orders, packets);
+            }));
+            print_row(run_best_and_worst(runs_per_case, [&] {
+                ArrayListBook<SlowArrayLinkedList<Order>> book(capacity);
+                return bench_churn_batched("slow aos bulk churn" + tag, book, fill_orders, packets);
+            }));
+            print_row(run_best_and_worst(runs_per_case, [&] {
+                ArrayListBook<FastArrayLinkedList<Order>> book(capacity);
+                return bench_churn_packets_sequential("fast soa per-msg churn" + tag, book, fill_orders, packets);
+            }));
+            print_row(run_best_and_worst(runs_per_case, [&] {
+                ArrayListBook<FastArrayLinkedList<Order>> book(capacity);
+                return bench_churn_batched("fast soa bulk churn" + tag, book, fill_orders, packets);
+            }));
+        }
+        out << "\n";
+    }
+
+    // Scenario 8: traversal after churn has scattered the nodes, with and
+    // without an explicit compaction pass.
+    if (run_scenario("iterate-after-churn")) {
+        auto linked_sum = [](const auto& book) { return book.iterate_sum(); };
+        auto flat_sum = [](const auto& book) { return book.iterate_sum_contiguous(); };
+        auto slow_result = run_best_and_worst(runs_per_case, [&] {
+            ArrayListBook<SlowArrayLinkedList<Order>> book(capacity);
+            bench_churn("", book, fill_orders, churn_steps);
+            return bench_iterate_prepared("slow aos iterate after churn", book, iterate_loops, linked_sum);
+        });
+        auto fast_result = run_best_and_worst(runs_per_case, [&] {
+            ArrayListBook<FastArrayLinkedList<Order>> book(capacity);
+            bench_churn("", book, fill_orders, churn_steps);
+            return bench_iterate_prepared("fast soa iterate after churn", book, iterate_loops, linked_sum);
+        });
+        double compact_ms = 0.0;
+        auto compact_result = run_best_and_worst(runs_per_case, [&] {
+            ArrayListBook<FastArrayLinkedList<Order>> book(capacity);
+            bench_churn("", book, fill_orders, churn_steps);
+            const auto start = std::chrono::steady_clock::now();
+            book.compact();
+            const auto end = std::chrono::steady_clock::now();
+            compact_ms = std::chrono::duration<double, std::milli>(end - start).count();
+            return bench_iterate_prepared("fast soa iterate after churn+compact", book, iterate_loops, linked_sum);
+        });
+        auto flat_result = run_best_and_worst(runs_per_case, [&] {
+            ArrayListBook<FastArrayLinkedList<Order>> book(capacity);
+            bench_churn("", book, fill_orders, churn_steps);
+            book.compact();
+            return bench_iterate_prepared("fast soa flat sum after churn+compact", book, iterate_loops, flat_sum);
+        });
+
+        out << "Iteration after churn (" << iterate_loops << " traversals, best/worst of " << runs_per_case
+            << ", last compact " << compact_ms << " ms)\n";
+        print(slow_result);
+        print(fast_result);
+        print(compact_result);
+        print(flat_result);
+        out << "\n";
+    }
+
+    // Scenario 9: first-class reductions vs the generic lambda walk, on a
+    // freshly filled (contiguous) list and on one scattered by churn.
+    if (run_scenario("reductions")) {
+        check_prefix();
+        using Book = ArrayListBook<FastArrayLinkedList<Order>>;
+        auto lambda_sum = [](const Book& book) { return book.iterate_sum(); };
+        auto api_sum = [](const Book& book) { return static_cast<std::uint64_t>(book.list().sum_field(&Order::qty)); };
+        // Orders needed to fill half the resting quantity.
+        const std::int64_t fill_qty = 5 * static_cast<std::int64_t>(capacity) / 4;
+        auto lambda_prefix = [fill_qty](const Book& book) {
+            std::int64_t total = 0;
+            std::uint64_t count = 0;
+            book.list().for_each_value_unchecked([&](const Order& o) {
+                if (total < fill_qty) {
+                    total += o.qty;
+                    ++count;
+                }
+            });
+            return count;
+        };
+        auto api_prefix = [fill_qty](const Book& book) {
+            return static_cast<std::uint64_t>(book.list().find_prefix_ge(&Order::qty, fill_qty).count);
+        };
+
+        std::vector<RunSummary> results;
+        for (bool churned : {false, true}) {
+            const std::string tag = churned ? " after churn" : " after fill";
+            auto run = [&](const std::string& name, auto&& fn) {
+                results.push_back(run_best_and_worst(runs_per_case, [&] {
+                    Book book(capacity);
+                    if (churned) {
+                        bench_churn("", book, fill_orders, churn_steps);
+                    } else {
+                        preload(book, fill_orders);
+                    }
+                    return bench_iterate_prepared(name + tag, book, iterate_loops, fn);
+                }));
+            };
+            run("fast soa lambda qty sum", lambda_sum);
+            run("fast soa sum_field", api_sum);
+            run("fast soa lambda prefix", lambda_prefix);
+            run("fast soa find_prefix_ge", api_prefix);
+        }
+
+        out << "Reductions (" << iterate_loops << " passes, best/worst of " << runs_per_case << ")\n";
+        for (const auto& r : results) {
+            print(r);
+        }
+        out << "\n";
+    }
+
+    // Scenario 10: replay of an ITCH capture (--replay), or of a synthetic
+    // queue capture at this depth. Every message of the busiest instrument
+    // goes to one queue, so an external capture is best filtered to a single
+    // price level, e.g. one side of a thin instrument.
+    if (run_scenario("replay")) {
+        std::string path = opts.replay;
+        if (path.empty()) {
+            path = (std::filesystem::temp_directory_path() /
+                    ("arr_list_replay_" + std::to_string(::getpid()) + ".itch"))
+                       .string();
+            write_queue_capture(path, capacity, churn_ops);
+        }
+        const itch::MappedFile file(path);
+        if (opts.replay.empty()) {
+            std::remove(path.c_str()); // the mapping stays valid
+        }
+        const itch::Profile prof = itch::profile(file.data(), file.size());
+        const std::size_t replay_capacity = std::max<std::size_t>(1, prof.peak_orders);
+
+        auto slow_result = run_best_and_worst(runs_per_case, [&] {
+            ReplayListBook<SlowArrayLinkedList<Order>> book(replay_capacity);
+            return bench_replay("slow aos replay", book, file, prof);
+        });
+        auto fast_result = run_best_and_worst(runs_per_case, [&] {
+            ReplayListBook<FastArrayLinkedList<Order>> book(replay_capacity);
+            return bench_replay("fast soa replay", book, file, prof);
+        });
+        auto hybrid_result = run_best_and_worst(runs_per_case, [&] {
+            ReplayListBook<HybridArrayLinkedList<Order>> book(replay_capacity);
+            return bench_replay("hybrid replay", book, file, prof);
+        });
+        auto compact_result = replay_capacity <= CompactArrayLinkedList<Order>::max_capacity()
+                                  ? run_best_and_worst(runs_per_case, [&] {
+                                        ReplayListBook<CompactArrayLinkedList<Order>> book(replay_capacity);
+                                        return bench_replay("compact 16+16 replay", book, file, prof);
+                                    })
+                                  : RunSummary();
+
+        out << "ITCH replay (" << (opts.replay.empty() ? "synthetic queue" : opts.replay) << ", locate "
+            << prof.locate << ": " << prof.events << " msgs, peak depth " << prof.peak_orders << ", best/worst of "
+            << runs_per_case << ")\n";
+        print(slow_result);
+        print(fast_result);
+        print(hybrid_result);
+        print(compact_result);
+        out << "\n";
+    }
+
+    // Scenario 11: warm restart of a churned fast soa list from a save()
+    // image: load() into a new list, or map the file and read it in place
+    // through an ImageView, against rebuilding it by replaying its messages.
+    if (run_scenario("snapshot")) {
+        using List = FastArrayLinkedList<Order>;
+        using Book = ArrayListBook<List>;
+        Book book(capacity);
+        bench_churn("", book, fill_orders, churn_steps);
+        const List& list = book.list();
+        const auto expected = static_cast<std::uint64_t>(list.sum_field(&Order::qty));
+        const std::string path = (std::filesystem::temp_directory_path() /
+                                  ("arr_list_snapshot_" + std::to_string(::getpid()) + ".img"))
+                                     .string();
+        auto open_image = [&](int flags) {
+            const int fd = ::open(path.c_str(), flags, 0644);
+            if (fd < 0) {
+                throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+            }
+            return fd;
+        };
+        auto result = [&](const std::string& name, std::chrono::steady_clock::duration elapsed, std::size_t depth,
+                          std::uint64_t checksum) {
+            if (checksum != expected || depth != list.size()) {
+                throw std::runtime_error(name + ": restored list differs from the saved one");
+            }
+            const double ms = std::chrono::duration<double, std::milli>(elapsed).count();
+            return BenchmarkResult{name, capacity, depth, ms, ms * 1e6 / static_cast<double>(capacity), checksum,
+                                   bench::LatencyHistogram()};
+        };
+
+        auto rebuild_result = run_best_and_worst(runs_per_case, [&] {
+            const auto start = std::chrono::steady_clock::now();
+            Book rebuilt(capacity);
+            bench_churn("", rebuilt, fill_orders, churn_steps);
+            const auto end = std::chrono::steady_clock::now();
+            return result("fast soa rebuild by replay", end - start, rebuilt.size(),
+                          static_cast<std::uint64_t>(rebuilt.list().sum_field(&Order::qty)));
+        });
+        auto save_result = run_best_and_worst(runs_per_case, [&] {
+            const int fd = open_image(O_WRONLY | O_CREAT | O_TRUNC);
+            const auto start = std::chrono::steady_clock::now();
+            list.save(fd);
+            const auto end = std::chrono::steady_clock::now();
+            ::close(fd);
+            return result("fast soa save", end - start, list.size(), expected);
+        });
+        auto load_result = run_best_and_worst(runs_per_case, [&] {
+            List restored(1);
+            const int fd = open_image(O_RDONLY);
+            const auto start = std::chrono::steady_clock::now();
+            restored.load(fd);
+            const auto end = std::chrono::steady_clock::now();
+            ::close(fd);
+            return result("fast soa load", end - start, restored.size(),
+                          static_cast<std::uint64_t>(restored.sum_field(&Order::qty)));
+        });
+        auto map_result = run_best_and_worst(runs_per_case, [&] {
+            const auto start = std::chrono::steady_clock::now();
+            const arrlist::MappedImage image(path);
+            const arrlist_fast::ImageView<List> view(image.data(), image.size());
+            const auto end = std::chrono::steady_clock::now();
+            std::uint64_t sum = 0;
+            view.for_each_value_unchecked([&](const Order& o) { sum += static_cast<std::uint64_t>(o.qty); });
+            return result("fast soa map + view", end - start, view.size(), sum);
+        });
+
+        // A restored list must keep going exactly like the original, free-slot
+        // order included.
+        List original = list;
+        List restored(1);
+        const int fd = open_image(O_RDONLY);
+        restored.load(fd);
+        ::close(fd);
+        if (original.push_back(Order{}).index != restored.push_back(Order{}).index) {
+            throw std::runtime_error("restored list reuses free slots in a different order");
+        }
+        const auto image_bytes = std::filesystem::file_size(path);
+        std::remove(path.c_str());
+
+        out << "Snapshot/restore (fast soa after " << churn_ops << " churn ops, image " << image_bytes
+            << " bytes, best/worst of " << runs_per_case << ")\n";
+        print(rebuild_result);
+        print(save_result);
+        print(load_result);
+        print(map_result);
+        out << "\n";
+    }
+
+    // Scenario 12: the same churn and post-churn traversal with the slot
+    // arrays on 4K pages, 2M pages and (when the hugetlb pool has any) 1G
+    // pages, against the default allocator. Only deep lists (--sizes=1M and
+    // up) outgrow the TLB's 4K reach.
+    if (run_scenario("pages")) {
+        auto linked_sum = [](const auto& book) { return book.iterate_sum(); };
+        std::vector<RunSummary> results;
+        std::vector<std::string> backings;
+        auto run = [&](const std::string& label, auto list_tag) {
+            using List = typename decltype(list_tag)::type;
+            const mem::PageStats before = mem::page_stats();
+            { List probe(capacity); }
+            const mem::PageStats got = mem::page_stats() - before;
+            backings.push_back(label + ": " + mem::describe(got));
+            results.push_back(run_best_and_worst(runs_per_case, [&] {
+                ArrayListBook<List> book(capacity);
+                return bench_churn(label + " churn", book, fill_orders, churn_steps);
+            }));
+            results.push_back(run_best_and_worst(runs_per_case, [&] {
+                ArrayListBook<List> book(capacity);
+                bench_churn("", book, fill_orders, churn_steps);
+                return bench_iterate_prepared(label + " iterate after churn", book, iterate_loops, linked_sum);
+            }));
+        };
+        const bool have_1g = mem::hugetlb_pages_free(mem::Pages::Huge1G) > 0;
+        run("slow aos std::allocator", TypeTag<SlowArrayLinkedList<Order>>{});
+        run("slow aos 4K pages", TypeTag<SlowPagedList<Order, mem::Pages::Base4K>>{});
+        run("slow aos 2M pages", TypeTag<SlowPagedList<Order, mem::Pages::Huge2M>>{});
+        if (have_1g) {
+            run("slow aos 1G pages", TypeTag<SlowPagedList<Order, mem::Pages::Huge1G>>{});
+        }
+        run("fast soa std::allocator", TypeTag<FastArrayLinkedList<Order>>{});
+        run("fast soa 4K pages", TypeTag<FastPagedList<Order, mem::Pages::Base4K>>{});
+        run("fast soa 2M pages", TypeTag<FastPagedList<Order, mem::Pages::Huge2M>>{});
+        if (have_1g) {
+            run("fast soa 1G pages", TypeTag<FastPagedList<Order, mem::Pages::Huge1G>>{});
+        }
+
+        out << "Page size sweep (" << churn_ops << " churn ops, " << iterate_loops << " traversals, best/worst of "
+            << runs_per_case << (have_1g ? "" : "; no free 1G hugetlb pages, 1G skipped") << ")\n";
+        for (const auto& b : backings) {
+            out << "  backing " << b << "\n";
+        }
+        for (const auto& r : results) {
+            print(r);
+        }
+        out << "\n";
+    }
+
+    // Scenario 13: modify-heavy flow from half depth, 60% modifies that lose
+    // priority (size increases re-queue at the back, price changes move to
+    // another level), 20% adds, 20% cancels. Erase + re-insert against the
+    // O(1) relinks that keep the node's slot and handle.
+    if (run_scenario("modify-heavy")) {
+        constexpr std::uint32_t kLevels = 16;
+        const std::size_t start_depth = std::max<std::size_t>(1, capacity / 2);
+        const std::vector<Order> half(fill_orders.begin(), fill_orders.begin() + static_cast<std::ptrdiff_t>(start_depth));
+        std::mt19937_64 rng(99);
+        std::uniform_real_distribution<double> op_dist(0.0, 1.0);
+        std::uniform_int_distribution<std::uint32_t> level_dist(0, kLevels - 1);
+        std::vector<ModifyStep> steps;
+        steps.reserve(churn_ops);
+        std::size_t live = start_depth;
+        for (std::size_t i = 0; i < churn_ops; ++i) {
+            const double u = op_dist(rng);
+            if (live == 0 || (u < 0.2 && live < capacity)) {
+                steps.push_back(ModifyStep{Op::Add, 0, 0, Order{2 * capacity + i + 1, qty_dist(rng_orders)}});
+                ++live;
+                continue;
+            }
+            const std::size_t pos = std::uniform_int_distribution<std::size_t>(0, live - 1)(rng);
+            if (u < 0.4) {
+                steps.push_back(ModifyStep{Op::Cancel, pos, 0, Order{}});
+                --live;
+            } else {
+                steps.push_back(ModifyStep{Op::Modify, pos, level_dist(rng), Order{}});
+            }
+        }
+
+        using FastBook = ArrayListBook<FastArrayLinkedList<Order>>;
+        using Pooled = MultiLevelBook<PooledArrayLinkedList<Order>>;
+        auto fast_requeue = run_best_and_worst(runs_per_case, [&] {
+            FastBook book(capacity);
+            return bench_modify("fast soa erase + push_back", book, half, steps,
+                                [](FastBook& b, const ModifyStep& st) { b.requeue_at_position(st.pos); });
+        });
+        auto fast_move = run_best_and_worst(runs_per_case, [&] {
+            FastBook book(capacity);
+            return bench_modify("fast soa move_to_back", book, half, steps,
+                                [](FastBook& b, const ModifyStep& st) { b.move_to_back_at_position(st.pos); });
+        });
+        auto pooled_requeue = run_best_and_worst(runs_per_case, [&] {
+            arrlist_pool::NodePool<Order> pool(capacity);
+            Pooled book(kLevels, capacity, [&] { return PooledArrayLinkedList<Order>(pool); });
+            return bench_modify("pooled erase + push_back to new level", book, half, steps,
+                                [](Pooled& b, const ModifyStep& st) { b.requeue_at_position(st.pos, st.level); });
+        });
+        auto pooled_splice = run_best_and_worst(runs_per_case, [&] {
+            arrlist_pool::NodePool<Order> pool(capacity);
+            Pooled book(kLevels, capacity, [&] { return PooledArrayLinkedList<Order>(pool); });
+            return bench_modify("pooled splice to new level", book, half, steps,
+                                [](Pooled& b, const ModifyStep& st) { b.splice_at_position(st.pos, st.level); });
+        });
+
+        out << "Modify-heavy (" << churn_ops << " ops from depth " << start_depth
+            << ": 60% modify to back, 20% add, 20% cancel; pooled: " << kLevels << " levels, best/worst of "
+            << runs_per_case << ")\n";
+        print(fast_requeue);
+        print(fast_move);
+        print(pooled_requeue);
+        print(pooled_splice);
+        out << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    bench::Options opts;
+    try {
+        opts = bench::parse_options(argc, argv);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n" << bench::usage();
+        return 2;
+    }
+    if (opts.help) {
+        std::cout << "scenarios: fill, erase, churn, iterate, multi-level, check-policy, batched, "
+                     "iterate-after-churn, reductions, replay, snapshot, pages, modify-heavy\n"
+                  << "sizes: list depth (default 32k); iters: churn ops (default 200000); reps: runs per case "
+                     "(default 5)\n"
+                  << bench::usage();
+        return 0;
+    }
+
+    try {
+        bench::Reporter report(opts);
+        bench::setup_runner(opts, report);
+        bench::print_timer_info(report.text());
+        report.text() << "\n";
+        for (std::size_t capacity : opts.sizes_or({32 * 1024})) {
+            run_scenarios(capacity, opts.iters_or(200'000), opts.reps_or(5), opts, report);
+        }
+        report.finish();
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
     return 0;
 }
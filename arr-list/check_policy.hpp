@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+namespace arrlist {
+
+// Compile-time validation policies for the ArrayLinkedList variants. Each
+// policy provides require<Error>(ok, what), called on every precondition of
+// the hot path (valid handle, free slot available, list not empty).
+
+// Throws Error(what) on a violated precondition. Default; matches the original
+// behaviour.
+struct ThrowChecks {
+    template <typename Error>
+    static void require(bool ok, const char* what) {
+        if (!ok) {
+            throw Error(what);
+        }
+    }
+};
+
+// assert() only: traps in debug builds, compiles to nothing under NDEBUG.
+struct AssertChecks {
+    template <typename Error>
+    static void require(bool ok, const char* what) {
+        assert(ok && what);
+        (void)ok;
+        (void)what;
+    }
+};
+
+// No validation at all. Violating a precondition is undefined behaviour; the
+// try_* APIs remain available for callers that need to handle errors.
+struct NoChecks {
+    template <typename Error>
+    static void require(bool, const char*) {}
+};
+
+// Result of try_erase and try_erase_after. The other try_* operations report
+// a full or empty list with an empty std::optional.
+enum class Status : std::uint8_t {
+    Ok,
+    InvalidHandle, // handle out of range or stale
+    NoNext,        // erase_after on the tail
+};
+
+} // namespace arrlist
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace arrlist {
+
+// Flat binary images of a list's arrays, for snapshot/restore (save(fd) and
+// load(fd) on the lists that support them). An image is a 64-byte header
+// followed by the list's arrays in a layout the list defines, each section
+// starting on a 64-byte boundary so a read-only mapping of the file can be
+// used in place. Images are in native byte order and only valid for the same
+// value type layout; load rejects anything else with std::runtime_error.
+
+constexpr std::size_t kImageAlign = 64;
+constexpr char kImageMagic[8] = {'A', 'R', 'R', 'L', 'I', 'S', 'T', '\0'};
+constexpr std::uint32_t kImageVersion = 1;
+
+// Which list layout wrote the image.
+enum class ImageLayout : std::uint32_t {
+    FastSoa = 1,
+};
+
+struct ImageHeader {
+    char magic[8];
+    std::uint32_t version;
+    ImageLayout layout;
+    std::uint32_t value_size;
+    std::uint32_t value_align;
+    std::uint32_t free_list; // FreeList::kImageTag of the writing list
+    std::uint32_t flags;     // kImageContiguous
+    std::uint64_t capacity;
+    std::uint64_t size;
+    std::int64_t head;
+    std::int64_t tail;
+};
+
+static_assert(sizeof(ImageHeader) == kImageAlign, "the header fills the first section");
+
+constexpr std::uint32_t kImageContiguous = 1;
+
+constexpr std::size_t image_align_up(std::size_t offset) {
+    return (offset + kImageAlign - 1) / kImageAlign * kImageAlign;
+}
+
+// Throws unless the header was written by `layout` for a value of this size
+// and alignment. The free-list tag is checked separately because read-only
+// views do not care which policy wrote the image.
+inline void check_image_header(const ImageHeader& h, ImageLayout layout, std::size_t value_size,
+                               std::size_t value_align) {
+    if (std::memcmp(h.magic, kImageMagic, sizeof(kImageMagic)) != 0) {
+        throw std::runtime_error("not a list image");
+    }
+    if (h.version != kImageVersion) {
+        throw std::runtime_error("unsupported list image version " + std::to_string(h.version));
+    }
+    if (h.layout != layout) {
+        throw std::runtime_error("list image was written by a different list layout");
+    }
+    if (h.value_size != value_size || h.value_align != value_align) {
+        throw std::runtime_error("list image value type does not match (size " + std::to_string(h.value_size) +
+                                 ", expected " + std::to_string(value_size) + ")");
+    }
+    if (h.capacity == 0 || h.size > h.capacity || h.head < -1 || h.tail < -1 ||
+        h.head >= static_cast<std::int64_t>(h.capacity) || h.tail >= static_cast<std::int64_t>(h.capacity) ||
+        (h.size == 0) != (h.head == -1) || (h.head == -1) != (h.tail == -1)) {
+        throw std::runtime_error("list image header is inconsistent");
+    }
+}
+
+// Sequential writer of image sections to a file descriptor. Retries short
+// writes and EINTR; any other failure throws.
+class ImageWriter {
+public:
+    explicit ImageWriter(int fd) : fd_(fd) {}
+
+    // Writes n elements and pads to the next section boundary.
+    template <typename T>
+    void array(const T* data, std::size_t n) {
+        write_bytes(data, n * sizeof(T));
+        static constexpr char kZeros[kImageAlign] = {};
+        write_bytes(kZeros, image_align_up(offset_) - offset_);
+    }
+
+    std::size_t offset() const { return offset_; }
+
+private:
+    void write_bytes(const void* data, std::size_t bytes) {
+        const char* p = static_cast<const char*>(data);
+        while (bytes != 0) {
+            const ssize_t n = ::write(fd_, p, bytes);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("cannot write list image: ") + std::strerror(errno));
+            }
+            p += n;
+            bytes -= static_cast<std::size_t>(n);
+            offset_ += static_cast<std::size_t>(n);
+        }
+    }
+
+    int fd_;
+    std::size_t offset_ = 0;
+};
+
+// Reader matching ImageWriter; a short file throws.
+class ImageReader {
+public:
+    explicit ImageReader(int fd) : fd_(fd) {}
+
+    template <typename T>
+    void array(T* data, std::size_t n) {
+        read_bytes(data, n * sizeof(T));
+        char padding[kImageAlign];
+        read_bytes(padding, image_align_up(offset_) - offset_);
+    }
+
+private:
+    void read_bytes(void* data, std::size_t bytes) {
+        char* p = static_cast<char*>(data);
+        while (bytes != 0) {
+            const ssize_t n = ::read(fd_, p, bytes);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("cannot read list image: ") + std::strerror(errno));
+            }
+            if (n == 0) {
+                throw std::runtime_error("list image is truncated");
+            }
+            p += n;
+            bytes -= static_cast<std::size_t>(n);
+            offset_ += static_cast<std::size_t>(n);
+        }
+    }
+
+    int fd_;
+    std::size_t offset_ = 0;
+};
+
+// Read-only mapping of an image file for the in-place views. Pages are
+// populated up front so the first traversal does not take the faults.
+class MappedImage {
+public:
+    explicit MappedImage(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            const int err = errno;
+            ::close(fd);
+            throw std::runtime_error("cannot stat " + path + ": " + std::strerror(err));
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ != 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+            if (p == MAP_FAILED) {
+                const int err = errno;
+                ::close(fd);
+                throw std::runtime_error("cannot map " + path + ": " + std::strerror(err));
+            }
+            data_ = p;
+        }
+        ::close(fd);
+    }
+
+    MappedImage(const MappedImage&) = delete;
+    MappedImage& operator=(const MappedImage&) = delete;
+
+    MappedImage(MappedImage&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+    MappedImage& operator=(MappedImage&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~MappedImage() { unmap(); }
+
+    const void* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    void unmap() {
+        if (data_ != nullptr) {
+            ::munmap(data_, size_);
+        }
+    }
+
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace arrlist
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace arrlist {
+
+// Compile-time statistics policies for arrlist_fast::ArrayLinkedList. The
+// list calls the hooks below from its hot paths; NoStats (the default)
+// leaves them empty so they compile away, CountingStats counts into
+// thread-local counters:
+//     arrlist_fast::ArrayLinkedList<Order, arrlist_fast::LifoFreeList, arrlist::ThrowChecks,
+//                                   std::allocator<Order>, arrlist::CountingStats> list(capacity);
+//     ... run the session ...
+//     const arrlist::ListCounters c = arrlist::CountingStats::snapshot();
+// The counters cover every counting list used by the thread, so a book
+// thread reads them for all its levels at once; one instance per thread on
+// its own cache line, so a worker counting never touches another's lines.
+
+struct alignas(64) ListCounters {
+    std::uint64_t high_water = 0;      // largest size any list reached
+    std::uint64_t acquires = 0;        // slots taken next to an existing node
+    std::uint64_t reuse_distance = 0;  // sum over those of |slot - neighbour's slot|
+    std::uint64_t traversals = 0;      // walks: for_each, reductions, visit_until
+    std::uint64_t traversed = 0;       // nodes those walks visited
+    std::uint64_t invalid_handles = 0; // stale or out-of-range handles rejected
+
+    double avg_reuse_distance() const {
+        return acquires == 0 ? 0.0 : static_cast<double>(reuse_distance) / static_cast<double>(acquires);
+    }
+    double avg_traversal() const {
+        return traversals == 0 ? 0.0 : static_cast<double>(traversed) / static_cast<double>(traversals);
+    }
+};
+
+struct NoStats {
+    static void on_acquire(int /*slot*/, int /*neighbour*/) {}
+    static void on_size(std::size_t /*size*/) {}
+    static void on_traverse(std::size_t /*nodes*/) {}
+    static void on_invalid_handle() {}
+};
+
+struct CountingStats {
+    // neighbour is the slot the new node is linked next to, -1 for the first
+    // node of an empty list (not a reuse, so not counted).
+    static void on_acquire(int slot, int neighbour) {
+        if (neighbour >= 0) {
+            ListCounters& c = counters();
+            ++c.acquires;
+            c.reuse_distance += static_cast<std::uint64_t>(slot > neighbour ? slot - neighbour : neighbour - slot);
+        }
+    }
+
+    static void on_size(std::size_t size) {
+        ListCounters& c = counters();
+        if (size > c.high_water) {
+            c.high_water = size;
+        }
+    }
+
+    static void on_traverse(std::size_t nodes) {
+        ListCounters& c = counters();
+        ++c.traversals;
+        c.traversed += nodes;
+    }
+
+    static void on_invalid_handle() { ++counters().invalid_handles; }
+
+    static ListCounters snapshot() { return counters(); }
+    static void reset() { counters() = ListCounters(); }
+
+private:
+    static ListCounters& counters() {
+        static thread_local ListCounters c;
+        return c;
+    }
+};
+
+} // namespace arrlist
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace arrlist {
+
+// Exchange order id -> list handle (or any small trivially copyable value)
+// index for the cancel path: open addressing with Robin Hood probing, the
+// value stored inline next to its key, and backward-shift deletion, so
+// erasing leaves no tombstones and lookups never slow down as a session
+// churns. The table is sized once for the expected number of live orders and
+// only rehashes if that is exceeded.
+//
+// Keys are hashed with a Fibonacci multiply, which spreads sequential and
+// strided ids (a feed's ids for one book are increasing with gaps) evenly over
+// the table. Robin Hood keeps every probe sequence short at the 80% maximum
+// load, typically one or two slots, so a lookup is one cache line in the
+// common case.
+template <typename Value>
+class OrderIndex {
+    static_assert(std::is_trivially_copyable_v<Value>, "OrderIndex values are moved by copying slots");
+
+public:
+    // Slots for `expected` live keys without rehashing.
+    explicit OrderIndex(std::size_t expected = 0) { reserve(expected); }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t slot_count() const { return slots_.size(); }
+
+    void reserve(std::size_t expected) {
+        const std::size_t needed = (expected * kMaxLoadDen + kMaxLoadNum - 1) / kMaxLoadNum + 1;
+        std::size_t wanted = kMinSlots;
+        while (wanted < needed) {
+            wanted *= 2;
+        }
+        if (wanted > slots_.size()) {
+            rehash(wanted);
+        }
+    }
+
+    void clear() {
+        for (Slot& s : slots_) {
+            s.dist = 0;
+        }
+        size_ = 0;
+    }
+
+    Value* find(std::uint64_t key) {
+        const std::size_t i = locate(key);
+        return i == kNotFound ? nullptr : &slots_[i].value;
+    }
+
+    const Value* find(std::uint64_t key) const {
+        const std::size_t i = locate(key);
+        return i == kNotFound ? nullptr : &slots_[i].value;
+    }
+
+    bool contains(std::uint64_t key) const { return locate(key) != kNotFound; }
+
+    // Returns false and leaves the table unchanged when the key is present.
+    bool insert(std::uint64_t key, const Value& value) {
+        if ((size_ + 1) * kMaxLoadDen > slots_.size() * kMaxLoadNum) {
+            rehash(slots_.size() * 2);
+        }
+        Slot carry{key, value, 1};
+        bool displaced = false;
+        std::size_t i = home(key);
+        while (true) {
+            Slot& s = slots_[i];
+            if (s.dist == 0) {
+                s = carry;
+                ++size_;
+                return true;
+            }
+            // A present key sits before the first slot poorer than us, so
+            // once carry holds a displaced entry there is nothing to compare.
+            if (!displaced && s.key == key) {
+                return false;
+            }
+            if (s.dist < carry.dist) {
+                std::swap(s, carry);
+                displaced = true;
+            }
+            ++carry.dist;
+            i = (i + 1) & mask_;
+        }
+    }
+
+    bool erase(std::uint64_t key) {
+        const std::size_t i = locate(key);
+        if (i == kNotFound) {
+            return false;
+        }
+        remove_at(i);
+        return true;
+    }
+
+    // Erase that hands back the value: the cancel path's single probe.
+    bool take(std::uint64_t key, Value& out) {
+        const std::size_t i = locate(key);
+        if (i == kNotFound) {
+            return false;
+        }
+        out = slots_[i].value;
+        remove_at(i);
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::uint64_t key;
+        Value value;
+        std::uint32_t dist; // probe length + 1; 0 marks an empty slot
+    };
+
+    static constexpr std::size_t kMinSlots = 16;
+    static constexpr std::size_t kMaxLoadNum = 4;
+    static constexpr std::size_t kMaxLoadDen = 5;
+    static constexpr std::size_t kNotFound = static_cast<std::size_t>(-1);
+
+    std::size_t home(std::uint64_t key) const {
+        return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+
+    // Robin Hood order: once a slot is closer to its home than we are to
+    // ours, the key cannot be further along.
+    std::size_t locate(std::uint64_t key) const {
+        std::size_t i = home(key);
+        for (std::uint32_t dist = 1;; ++dist) {
+            const Slot& s = slots_[i];
+            if (s.dist < dist) {
+                return kNotFound;
+            }
+            if (s.key == key) {
+                return i;
+            }
+            i = (i + 1) & mask_;
+        }
+    }
+
+    // Backward shift: pull the following displaced entries one slot closer
+    // to home until an empty slot or one already at home.
+    void remove_at(std::size_t i) {
+        std::size_t next = (i + 1) & mask_;
+        while (slots_[next].dist > 1) {
+            slots_[i] = slots_[next];
+            --slots_[i].dist;
+            i = next;
+            next = (next + 1) & mask_;
+        }
+        slots_[i].dist = 0;
+        --size_;
+    }
+
+    void rehash(std::size_t count) {
+        if (count > (std::size_t{1} << 62)) {
+            throw std::length_error("OrderIndex slot count out of range");
+        }
+        unsigned bits = 0;
+        while ((std::size_t{1} << bits) < count) {
+            ++bits;
+        }
+        std::vector<Slot> old(count, Slot{0, Value{}, 0});
+        old.swap(slots_);
+        mask_ = count - 1;
+        shift_ = 64 - bits;
+        size_ = 0;
+        for (const Slot& s : old) {
+            if (s.dist != 0) {
+                insert(s.key, s.value);
+            }
+        }
+    }
+
+    std::vector<Slot> slots_;
+    std::size_t mask_ = 0;
+    unsigned shift_ = 64;
+    std::size_t size_ = 0;
+};
+
+} // namespace arrlist
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "bench_harness.hpp"
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/utsname.h>
+#define BENCH_HAS_LINUX 1
+#else
+#define BENCH_HAS_LINUX 0
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// Runner settings from the --cpu/--fifo/--warmup/--mlock/--perf flags and a record
+// of the machine they ran on. setup_runner() is called once at the top of
+// main(), before any benchmark data is allocated:
+//     bench::Reporter report(opts);
+//     bench::setup_runner(opts, report);
+// Linux only; elsewhere the flags are reported as unsupported and ignored.
+
+namespace bench {
+
+// Context switches and page faults of the calling thread so far. The
+// difference across a run separates "the structure was slow" from "the run
+// was preempted or faulted".
+struct Interference {
+    std::uint64_t ctx_switches = 0;
+    std::uint64_t page_faults = 0;
+};
+
+inline Interference interference_now() {
+    Interference now;
+#if BENCH_HAS_LINUX
+    rusage usage{};
+    if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+        now.ctx_switches = static_cast<std::uint64_t>(usage.ru_nvcsw) + static_cast<std::uint64_t>(usage.ru_nivcsw);
+        now.page_faults = static_cast<std::uint64_t>(usage.ru_minflt) + static_cast<std::uint64_t>(usage.ru_majflt);
+    }
+#endif
+    return now;
+}
+
+inline Interference operator-(Interference a, Interference b) {
+    return Interference{a.ctx_switches - b.ctx_switches, a.page_faults - b.page_faults};
+}
+
+// Effective core clock in GHz: a dependent chain of register adds retires
+// one per cycle, so adds per ns is the frequency the core actually runs at
+// (turbo included), unlike the constant-rate TSC. Register rather than
+// immediate operands: recent cores fold add-immediate chains at rename.
+inline double measure_core_ghz(std::uint64_t adds = std::uint64_t{1} << 22) {
+    std::uint64_t x = 0;
+    std::uint64_t one = 1;
+    __asm__ volatile("" : "+r"(one));
+    const std::uint64_t t0 = rdtscp();
+    for (std::uint64_t i = 0; i < adds; i += 8) {
+#if defined(__x86_64__)
+        __asm__ volatile(
+            "add %1, %0\n\tadd %1, %0\n\tadd %1, %0\n\tadd %1, %0\n\t"
+            "add %1, %0\n\tadd %1, %0\n\tadd %1, %0\n\tadd %1, %0"
+            : "+r"(x)
+            : "r"(one));
+#else
+        __asm__ volatile("" : "+r"(x));
+        x += 8 * one;
+#endif
+    }
+    const std::uint64_t t1 = rdtscp();
+    const double ns = static_cast<double>(t1 - t0) * ns_per_tick();
+    return ns > 0.0 ? static_cast<double>(x) / ns : 0.0;
+}
+
+struct WarmupResult {
+    double ms = 0.0;
+    std::size_t rounds = 0;
+    bool stable = false;
+    double core_ghz = 0.0;
+};
+
+// Spins ~2 ms timed rounds until three in a row agree within 1% or max_ms
+// has passed, which takes the core out of idle and low P-states before the
+// first case is measured.
+inline WarmupResult warm_up(std::size_t max_ms) {
+    WarmupResult r;
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    const auto deadline = start + std::chrono::milliseconds(max_ms);
+    double previous = 0.0;
+    std::size_t agreeing = 0;
+    while (clock::now() < deadline) {
+        const double ghz = measure_core_ghz();
+        ++r.rounds;
+        agreeing = previous > 0.0 && ghz > previous * 0.99 && ghz < previous * 1.01 ? agreeing + 1 : 0;
+        previous = ghz;
+        r.core_ghz = ghz;
+        if (agreeing >= 2) {
+            r.stable = true;
+            break;
+        }
+    }
+    r.ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    return r;
+}
+
+// CPUs the calling thread may run on, ascending. Multi-threaded benchmarks
+// pick their cores from this before pinning (empty where unsupported).
+inline std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+#if BENCH_HAS_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+// Pins only the calling thread, for the extra threads of a benchmark (the
+// main thread goes through --cpu and setup_runner). False when not allowed.
+inline bool pin_this_thread(int cpu) {
+#if BENCH_HAS_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+namespace detail {
+
+inline std::string read_line(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    if (!in || !std::getline(in, line)) {
+        return "n/a";
+    }
+    return line;
+}
+
+// Field of /proc/cpuinfo for one processor ("model name", "cpu MHz").
+inline std::string cpuinfo_field(int cpu, const std::string& key) {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    int current = -1;
+    while (std::getline(in, line)) {
+        const std::string::size_type colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        std::string name = line.substr(0, colon);
+        name.erase(name.find_last_not_of(" \t") + 1);
+        const std::string value = colon + 2 <= line.size() ? line.substr(colon + 2) : std::string();
+        if (name == "processor") {
+            current = std::atoi(value.c_str());
+        } else if (name == key && (current == cpu || cpu < 0)) {
+            return value;
+        }
+    }
+    return "n/a";
+}
+
+inline std::string errno_text(const char* what) {
+    return std::string(what) + ": " + std::strerror(errno);
+}
+
+// Touches a stack region so the pages are mapped (and locked) up front.
+inline void prefault_stack() {
+    constexpr std::size_t kBytes = 256 * 1024;
+    char buf[kBytes];
+    for (std::size_t i = 0; i < kBytes; i += 4096) {
+        buf[i] = 0;
+    }
+    __asm__ volatile("" : : "r"(buf) : "memory");
+}
+
+} // namespace detail
+
+// Applies --cpu, --fifo, --mlock and --perf, warms up, and reports the environment
+// (text(), and the env block of json/csv reports). Pinning to a CPU that is
+// not available throws; SCHED_FIFO and mlockall are usually denied without
+// privileges, which is reported and the run continues. Under SCHED_FIFO the
+// kernel's RT throttling (sched_rt_runtime_us) still leaves 5% to others.
+inline void setup_runner(const Options& opts, Reporter& report) {
+    std::ostream& out = report.text();
+    auto note = [&](const std::string& key, const std::string& value) {
+        out << "env: " << key << " " << value << "\n";
+        report.set_env(key, value);
+    };
+
+#if BENCH_HAS_LINUX
+    std::string affinity = "unpinned";
+    if (opts.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(opts.cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            const std::string what = "sched_setaffinity(cpu " + std::to_string(opts.cpu) + ")";
+            throw std::runtime_error(detail::errno_text(what.c_str()));
+        }
+        affinity = "pinned";
+    }
+
+    std::string sched = "SCHED_OTHER";
+    if (opts.fifo_priority > 0) {
+        sched_param param{};
+        param.sched_priority = opts.fifo_priority;
+        if (sched_setscheduler(0, SCHED_FIFO, &param) == 0) {
+            sched = "SCHED_FIFO " + std::to_string(opts.fifo_priority);
+        } else {
+            sched += " (" + detail::errno_text("SCHED_FIFO denied") + ")";
+        }
+    }
+
+    std::string memory = "unlocked";
+    if (opts.lock_memory) {
+#if defined(__GLIBC__)
+        // Keep freed memory in the process: no trimming back to the kernel,
+        // no per-allocation mmap, so later allocations reuse locked pages.
+        mallopt(M_TRIM_THRESHOLD, -1);
+        mallopt(M_MMAP_MAX, 0);
+#endif
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+            detail::prefault_stack();
+            memory = "mlockall (current + future), stack prefaulted";
+        } else {
+            memory = detail::errno_text("mlockall failed");
+        }
+    }
+#else
+    const std::string affinity = opts.cpu >= 0 ? "unsupported" : "unpinned";
+    const std::string sched = opts.fifo_priority > 0 ? "unsupported" : "default";
+    const std::string memory = opts.lock_memory ? "unsupported" : "unlocked";
+#endif
+
+    WarmupResult warm;
+    if (opts.warmup_ms > 0) {
+        warm = warm_up(opts.warmup_ms);
+    }
+
+#if BENCH_HAS_LINUX
+    const int cpu = sched_getcpu();
+    utsname uts{};
+    note("cpu_model", detail::cpuinfo_field(cpu, "model name"));
+    note("cpu", std::to_string(cpu) + " (" + affinity + ")");
+    note("cpuinfo_mhz", detail::cpuinfo_field(cpu, "cpu MHz"));
+    const std::string cpufreq = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/";
+    note("governor", detail::read_line(cpufreq + "scaling_governor"));
+    note("scaling_cur_khz", detail::read_line(cpufreq + "scaling_cur_freq"));
+    note("no_turbo", detail::read_line("/sys/devices/system/cpu/intel_pstate/no_turbo"));
+    note("isolated_cpus", detail::read_line("/sys/devices/system/cpu/isolated"));
+    note("kernel", uname(&uts) == 0 ? uts.release : "n/a");
+#endif
+    note("sched", sched);
+    note("memory", memory);
+    std::ostringstream ghz;
+    ghz << 1.0 / ns_per_tick() << " GHz tsc, " << (warm.rounds > 0 ? warm.core_ghz : measure_core_ghz())
+        << " GHz core";
+    note("clock", ghz.str());
+    if (opts.warmup_ms > 0) {
+        std::ostringstream w;
+        w << warm.ms << " ms, " << warm.rounds << " rounds, " << (warm.stable ? "stable" : "not stable");
+        note("warmup", w.str());
+    }
+    if (opts.perf) {
+        // Opened here for the main thread; other threads open theirs on first use.
+        const PerfCounters& counters = thread_perf_counters();
+        perf_enabled() = counters.available();
+        note("perf", counters.available() ? "cache misses, cache references" : "unavailable (" + counters.error() + ")");
+    }
+    note("compiler", __VERSION__);
+}
+
+} // namespace bench
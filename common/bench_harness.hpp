@@ -0,0 +1,618 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC 1
+#else
+#define BENCH_HAS_TSC 0
+#endif
+
+#include "perf_counters.hpp"
+
+namespace bench {
+
+// Raw timestamp counter. rdtsc() is a cheap unordered read for start stamps,
+// rdtscp() waits for earlier instructions to finish so it closes an interval.
+// Falls back to steady_clock nanoseconds where there is no TSC.
+inline std::uint64_t rdtsc() {
+#if BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+inline std::uint64_t rdtscp() {
+#if BENCH_HAS_TSC
+    unsigned aux;
+    return __rdtscp(&aux);
+#else
+    return rdtsc();
+#endif
+}
+
+// TSC period, calibrated once against steady_clock over ~20 ms.
+inline double ns_per_tick() {
+    static const double value = [] {
+#if BENCH_HAS_TSC
+        using clock = std::chrono::steady_clock;
+        const auto t0 = clock::now();
+        const std::uint64_t c0 = rdtscp();
+        auto t1 = t0;
+        while (t1 - t0 < std::chrono::milliseconds(20)) {
+            t1 = clock::now();
+        }
+        const std::uint64_t c1 = rdtscp();
+        return std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(c1 - c0);
+#else
+        return 1.0;
+#endif
+    }();
+    return value;
+}
+
+// Median cost of one back-to-back rdtscp pair, in ticks. OpTimer subtracts it
+// from every interval; samples far below it are dominated by timer noise.
+inline std::uint64_t timer_overhead_ticks() {
+    static const std::uint64_t value = [] {
+        std::vector<std::uint64_t> samples(1001);
+        for (auto& s : samples) {
+            const std::uint64_t a = rdtscp();
+            s = rdtscp() - a;
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        return samples[samples.size() / 2];
+    }();
+    return value;
+}
+
+struct LatencySummary {
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+    double max = 0.0;
+    std::uint64_t samples = 0;
+};
+
+// HDR-style log-linear histogram of integer samples: values below 2^kSubBits
+// are exact, above that each power of two is split into 2^kSubBits linear
+// sub-buckets, so any reported percentile is within ~3% of the true value.
+// record() is a clz, a shift and an increment. ns_per_unit converts samples
+// to nanoseconds when reporting (e.g. ns_per_tick() / ops per sample).
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBits = 5;
+    static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBits;
+    static constexpr std::size_t kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+    explicit LatencyHistogram(double ns_per_unit = 1.0) : counts_(kBuckets, 0), ns_per_unit_(ns_per_unit) {}
+
+    void record(std::uint64_t value) {
+        ++counts_[bucket_of(value)];
+        ++count_;
+        max_ = std::max(max_, value);
+    }
+
+    // Adds another histogram's samples; both must use the same ns_per_unit.
+    void merge(const LatencyHistogram& other) {
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        count_ += other.count_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    std::uint64_t count() const { return count_; }
+    double ns_per_unit() const { return ns_per_unit_; }
+
+    // Smallest recorded-bucket upper bound covering fraction q of samples, in ns.
+    double percentile(double q) const {
+        if (count_ == 0) {
+            return 0.0;
+        }
+        const auto target = static_cast<std::uint64_t>(q * static_cast<double>(count_ - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            seen += counts_[i];
+            if (seen >= target) {
+                return static_cast<double>(std::min(upper_bound_of(i), max_)) * ns_per_unit_;
+            }
+        }
+        return static_cast<double>(max_) * ns_per_unit_;
+    }
+
+    LatencySummary summary() const {
+        return LatencySummary{percentile(0.50), percentile(0.90), percentile(0.99), percentile(0.999),
+                              static_cast<double>(max_) * ns_per_unit_, count_};
+    }
+
+private:
+    static std::size_t bucket_of(std::uint64_t v) {
+        if (v < kSubBuckets) {
+            return static_cast<std::size_t>(v);
+        }
+        const unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(v));
+        const unsigned shift = msb - kSubBits;
+        const std::size_t sub = static_cast<std::size_t>(v >> shift) - kSubBuckets;
+        return (static_cast<std::size_t>(shift) + 1) * kSubBuckets + sub;
+    }
+
+    static std::uint64_t upper_bound_of(std::size_t bucket) {
+        const std::size_t group = bucket >> kSubBits;
+        if (group == 0) {
+            return bucket;
+        }
+        const unsigned shift = static_cast<unsigned>(group - 1);
+        const std::uint64_t lower = static_cast<std::uint64_t>(kSubBuckets + (bucket & (kSubBuckets - 1))) << shift;
+        return lower + ((std::uint64_t{1} << shift) - 1);
+    }
+
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t count_ = 0;
+    std::uint64_t max_ = 0;
+    double ns_per_unit_;
+};
+
+// Operations per latency sample for OpTimers constructed while it is set. 0
+// (the default) disables sampling, so wall-clock runs carry no timer reads;
+// ScopedSampling turns it on for a dedicated latency run.
+inline std::size_t& ops_per_sample() {
+    static std::size_t value = 0;
+    return value;
+}
+
+class ScopedSampling {
+public:
+    explicit ScopedSampling(std::size_t ops) : saved_(ops_per_sample()) { ops_per_sample() = ops; }
+    ~ScopedSampling() { ops_per_sample() = saved_; }
+    ScopedSampling(const ScopedSampling&) = delete;
+    ScopedSampling& operator=(const ScopedSampling&) = delete;
+
+private:
+    std::size_t saved_;
+};
+
+// Timestamps a loop of operations into a histogram: lap() after every
+// operation records one interval per ops_per_sample operations, minus the
+// calibrated timer overhead. Per-operation sampling suits list and book
+// operations; nanosecond kernels use a larger period so the timer read is
+// amortised. A disabled timer (period 0) costs one predictable branch per lap.
+class OpTimer {
+public:
+    OpTimer() : OpTimer(ops_per_sample()) {}
+
+    explicit OpTimer(std::size_t ops_per_sample)
+        : hist_(ns_per_tick() / static_cast<double>(ops_per_sample == 0 ? 1 : ops_per_sample)),
+          ops_per_sample_(ops_per_sample),
+          overhead_(ops_per_sample == 0 ? 0 : timer_overhead_ticks()) {}
+
+    bool enabled() const { return ops_per_sample_ != 0; }
+
+    void start() {
+        if (perf_enabled()) {
+            thread_perf_counters().start();
+        }
+        if (enabled()) {
+            pending_ = 0;
+            last_ = rdtscp();
+        }
+    }
+
+    void lap() {
+        if (enabled() && ++pending_ == ops_per_sample_) {
+            hist_.record(interval());
+            pending_ = 0;
+        }
+    }
+
+    // Closes an interval covering a whole batch of `ops` operations and
+    // records its per-operation average.
+    void lap_batch(std::size_t ops) {
+        if (enabled()) {
+            hist_.record(interval() * ops_per_sample_ / (ops == 0 ? 1 : ops));
+        }
+    }
+
+    const LatencyHistogram& histogram() const { return hist_; }
+    // Also closes the --perf region opened by start().
+    LatencyHistogram take() {
+        if (perf_enabled()) {
+            last_perf_sample() = thread_perf_counters().stop();
+        }
+        return std::move(hist_);
+    }
+
+private:
+    std::uint64_t interval() {
+        const std::uint64_t now = rdtscp();
+        const std::uint64_t ticks = now - last_;
+        last_ = now;
+        return ticks > overhead_ ? ticks - overhead_ : 0;
+    }
+
+    LatencyHistogram hist_;
+    std::size_t ops_per_sample_;
+    std::uint64_t overhead_;
+    std::size_t pending_ = 0;
+    std::uint64_t last_ = 0;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const LatencySummary& s) {
+    return os << "p50 " << s.p50 << " / p90 " << s.p90 << " / p99 " << s.p99 << " / p99.9 " << s.p999 << " / max "
+              << s.max << " ns";
+}
+
+// One-line description of the timing source, for benchmark headers.
+inline void print_timer_info(std::ostream& os) {
+    os << "timer: " << (BENCH_HAS_TSC ? "rdtscp" : "steady_clock") << ", " << 1.0 / ns_per_tick()
+       << " ticks/ns, overhead ~" << static_cast<double>(timer_overhead_ticks()) * ns_per_tick()
+       << " ns per sample (subtracted)\n";
+}
+
+// Command line shared by the benchmark binaries:
+//     --filter=churn,erase   run only scenarios whose name contains one of these
+//     --sizes=1k..1M         depth/working-set sweep: a list (4k,64k) or a
+//                            doubling range; k and M are binary (1k = 1024)
+//     --reps=N               runs per case (best/worst are reported)
+//     --iters=N              operations per timed case, where the binary has one
+//     --format=text|json|csv output; json/csv replace the text report
+//     --out=PATH             write the report to PATH instead of stdout
+//     --cpu=N                pin the benchmark thread to CPU N
+//     --fifo=PRIO            run at SCHED_FIFO priority PRIO (1-99)
+//     --warmup=MS            spin up to MS ms until timing is stable
+//     --mlock                mlockall and prefault before measuring
+//     --perf                 count cache misses around each timed loop
+// Zero/empty means "binary default". parse_options throws
+// std::invalid_argument on anything it does not recognise; bench_env.hpp
+// applies the runner settings.
+enum class Format { Text, Json, Csv };
+
+struct Options {
+    std::vector<std::string> filters;
+    std::vector<std::size_t> sizes;
+    std::size_t reps = 0;
+    std::size_t iters = 0;
+    Format format = Format::Text;
+    std::string out;
+    bool help = false;
+    int cpu = -1;
+    int fifo_priority = 0;
+    std::size_t warmup_ms = 0;
+    bool lock_memory = false;
+    bool perf = false;
+    std::string replay; // ITCH 5.0 capture for the replay scenarios
+
+    bool selected(const std::string& scenario) const {
+        if (filters.empty()) {
+            return true;
+        }
+        return std::any_of(filters.begin(), filters.end(),
+                           [&](const std::string& f) { return scenario.find(f) != std::string::npos; });
+    }
+
+    std::vector<std::size_t> sizes_or(std::vector<std::size_t> defaults) const {
+        return sizes.empty() ? defaults : sizes;
+    }
+    std::size_t reps_or(std::size_t value) const { return reps == 0 ? value : reps; }
+    std::size_t iters_or(std::size_t value) const { return iters == 0 ? value : iters; }
+};
+
+namespace detail {
+
+inline std::vector<std::string> split(const std::string& text, char sep) {
+    std::vector<std::string> parts;
+    std::string::size_type begin = 0;
+    while (true) {
+        const std::string::size_type end = text.find(sep, begin);
+        parts.push_back(text.substr(begin, end - begin));
+        if (end == std::string::npos) {
+            return parts;
+        }
+        begin = end + 1;
+    }
+}
+
+// "4096", "4k" or "1M"; k and M are binary multiples.
+inline std::size_t parse_count(const std::string& text) {
+    std::size_t value = 0;
+    std::size_t i = 0;
+    for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+        const auto digit = static_cast<std::size_t>(text[i] - '0');
+        if (value > (std::numeric_limits<std::size_t>::max() - digit) / 10) {
+            throw std::invalid_argument("number too large: " + text);
+        }
+        value = value * 10 + digit;
+    }
+    std::size_t multiplier = 1;
+    if (i + 1 == text.size() && (text[i] == 'k' || text[i] == 'K')) {
+        multiplier = std::size_t{1} << 10;
+        ++i;
+    } else if (i + 1 == text.size() && text[i] == 'M') {
+        multiplier = std::size_t{1} << 20;
+        ++i;
+    }
+    if (i == 0 || i != text.size() || value == 0 || value > std::numeric_limits<std::size_t>::max() / multiplier) {
+        throw std::invalid_argument("expected a positive count like 4096, 4k or 1M: '" + text + "'");
+    }
+    return value * multiplier;
+}
+
+inline std::vector<std::size_t> parse_sizes(const std::string& text) {
+    std::vector<std::size_t> sizes;
+    const std::string::size_type range = text.find("..");
+    if (range != std::string::npos) {
+        const std::size_t lo = parse_count(text.substr(0, range));
+        const std::size_t hi = parse_count(text.substr(range + 2));
+        if (lo > hi) {
+            throw std::invalid_argument("empty size range: " + text);
+        }
+        for (std::size_t n = lo; n <= hi && n != 0; n *= 2) {
+            sizes.push_back(n);
+        }
+        return sizes;
+    }
+    for (const auto& part : split(text, ',')) {
+        sizes.push_back(parse_count(part));
+    }
+    return sizes;
+}
+
+} // namespace detail
+
+inline const char* usage() {
+    return "options:\n"
+           "  --filter=a,b            run scenarios whose name contains a or b\n"
+           "  --sizes=1k..1M | 4k,64k depth/working-set sweep (k = 1024, M = 1024k)\n"
+           "  --reps=N                runs per case\n"
+           "  --iters=N               operations per timed case\n"
+           "  --format=text|json|csv  report format\n"
+           "  --out=PATH              write the report to PATH\n"
+           "  --cpu=N                 pin to CPU N\n"
+           "  --fifo=PRIO             SCHED_FIFO at priority PRIO (needs CAP_SYS_NICE)\n"
+           "  --warmup=MS             warm up for at most MS ms, until timing is stable\n"
+           "  --mlock                 lock and prefault memory\n"
+           "  --perf                  count cache misses around each timed loop (perf_event_open)\n"
+           "  --replay=PATH           ITCH 5.0 capture for the replay scenario\n";
+}
+
+inline Options parse_options(int argc, char** argv) {
+    Options opts;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const std::string::size_type eq = arg.find('=');
+        const std::string key = arg.substr(0, eq);
+        const std::string value = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+        if (key == "--help" || key == "-h") {
+            opts.help = true;
+        } else if (arg == "--mlock") {
+            opts.lock_memory = true;
+        } else if (arg == "--perf") {
+            opts.perf = true;
+        } else if (eq == std::string::npos || value.empty()) {
+            throw std::invalid_argument("expected --name=value: '" + arg + "'");
+        } else if (key == "--filter") {
+            opts.filters = detail::split(value, ',');
+        } else if (key == "--sizes") {
+            opts.sizes = detail::parse_sizes(value);
+        } else if (key == "--reps") {
+            opts.reps = detail::parse_count(value);
+        } else if (key == "--iters") {
+            opts.iters = detail::parse_count(value);
+        } else if (key == "--format") {
+            if (value == "text") {
+                opts.format = Format::Text;
+            } else if (value == "json") {
+                opts.format = Format::Json;
+            } else if (value == "csv") {
+                opts.format = Format::Csv;
+            } else {
+                throw std::invalid_argument("unknown format: " + value);
+            }
+        } else if (key == "--out") {
+            opts.out = value;
+        } else if (key == "--cpu") {
+            opts.cpu = value == "0" ? 0 : static_cast<int>(detail::parse_count(value));
+        } else if (key == "--fifo") {
+            const std::size_t prio = detail::parse_count(value);
+            if (prio > 99) {
+                throw std::invalid_argument("SCHED_FIFO priority must be 1-99: " + value);
+            }
+            opts.fifo_priority = static_cast<int>(prio);
+        } else if (key == "--warmup") {
+            opts.warmup_ms = detail::parse_count(value);
+        } else if (key == "--replay") {
+            opts.replay = value;
+        } else {
+            throw std::invalid_argument("unknown option: " + arg);
+        }
+    }
+    return opts;
+}
+
+// One benchmark case for the machine-readable report: ns_per_op is the best
+// run, worst_ns_per_op the worst (equal for single runs), size the depth or
+// working-set parameter of the sweep. ctx_switches and page_faults are
+// counted over all runs (bench_env.hpp), so a bad worst run can be told apart
+// from a preempted one. counters are extra named values some cases export
+// (--perf cache misses, list or overflow statistics).
+struct Record {
+    std::string scenario;
+    std::string name;
+    std::size_t size = 0;
+    std::size_t ops = 0;
+    std::size_t runs = 1;
+    double ns_per_op = 0.0;
+    double worst_ns_per_op = 0.0;
+    LatencySummary latency;
+    std::uint64_t ctx_switches = 0;
+    std::uint64_t page_faults = 0;
+    std::vector<std::pair<std::string, double>> counters = {};
+};
+
+// Collects Records and writes them as JSON or CSV at the end of the run. In
+// text mode text() is the usual report stream; in json/csv mode it discards,
+// so the existing human-readable printing needs no branches.
+class Reporter {
+public:
+    explicit Reporter(const Options& opts) : format_(opts.format), path_(opts.out) {
+        if (format_ == Format::Text && !path_.empty()) {
+            file_.open(path_);
+            if (!file_) {
+                throw std::runtime_error("cannot open " + path_);
+            }
+        }
+    }
+
+    Format format() const { return format_; }
+
+    std::ostream& text() {
+        if (format_ != Format::Text) {
+            return null_;
+        }
+        return file_.is_open() ? static_cast<std::ostream&>(file_) : std::cout;
+    }
+
+    void add(Record record) { records_.push_back(std::move(record)); }
+    const std::vector<Record>& records() const { return records_; }
+
+    // Machine and runner settings written ahead of the results (the "env"
+    // object in json, "# key: value" lines in csv).
+    void set_env(std::string key, std::string value) { env_.emplace_back(std::move(key), std::move(value)); }
+    const std::vector<std::pair<std::string, std::string>>& env() const { return env_; }
+
+    // Writes the json/csv report (nothing in text mode) to --out or stdout.
+    void finish() {
+        if (format_ == Format::Text) {
+            return;
+        }
+        if (path_.empty()) {
+            write(std::cout);
+            return;
+        }
+        std::ofstream file(path_);
+        if (!file) {
+            throw std::runtime_error("cannot open " + path_);
+        }
+        write(file);
+    }
+
+    void write(std::ostream& os) const {
+        if (format_ == Format::Json) {
+            write_json(os);
+        } else if (format_ == Format::Csv) {
+            write_csv(os);
+        }
+    }
+
+private:
+    static std::string json_string(const std::string& s) {
+        std::string out = "\"";
+        for (char c : s) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+        return out + "\"";
+    }
+
+    static std::string csv_field(const std::string& s) {
+        if (s.find_first_of(",\"\n") == std::string::npos) {
+            return s;
+        }
+        std::string out = "\"";
+        for (char c : s) {
+            out += c;
+            if (c == '"') {
+                out += '"';
+            }
+        }
+        return out + "\"";
+    }
+
+    void write_json(std::ostream& os) const {
+        std::ostringstream body;
+        body << std::setprecision(6) << "{\"env\": {";
+        for (std::size_t i = 0; i < env_.size(); ++i) {
+            body << (i == 0 ? "" : ", ") << json_string(env_[i].first) << ": " << json_string(env_[i].second);
+        }
+        body << "},\n\"results\": [";
+        for (std::size_t i = 0; i < records_.size(); ++i) {
+            const Record& r = records_[i];
+            body << (i == 0 ? "\n" : ",\n") << "  {\"scenario\": " << json_string(r.scenario)
+                 << ", \"name\": " << json_string(r.name) << ", \"size\": " << r.size << ", \"ops\": " << r.ops
+                 << ", \"runs\": " << r.runs << ", \"ns_per_op\": " << r.ns_per_op
+                 << ", \"worst_ns_per_op\": " << r.worst_ns_per_op << ", \"p50_ns\": " << r.latency.p50
+                 << ", \"p90_ns\": " << r.latency.p90 << ", \"p99_ns\": " << r.latency.p99
+                 << ", \"p999_ns\": " << r.latency.p999 << ", \"max_ns\": " << r.latency.max
+                 << ", \"samples\": " << r.latency.samples << ", \"ctx_switches\": " << r.ctx_switches
+                 << ", \"page_faults\": " << r.page_faults;
+            if (!r.counters.empty()) {
+                body << ", \"counters\": {";
+                for (std::size_t c = 0; c < r.counters.size(); ++c) {
+                    body << (c == 0 ? "" : ", ") << json_string(r.counters[c].first) << ": " << r.counters[c].second;
+                }
+                body << "}";
+            }
+            body << "}";
+        }
+        body << "\n]}\n";
+        os << body.str();
+    }
+
+    void write_csv(std::ostream& os) const {
+        std::ostringstream body;
+        body << std::setprecision(6);
+        for (const auto& kv : env_) {
+            body << "# " << kv.first << ": " << kv.second << "\n";
+        }
+        body << "scenario,name,size,ops,runs,ns_per_op,worst_ns_per_op,p50_ns,p90_ns,p99_ns,p999_ns,max_ns,samples,"
+                "ctx_switches,page_faults,counters\n";
+        for (const Record& r : records_) {
+            body << csv_field(r.scenario) << ',' << csv_field(r.name) << ',' << r.size << ',' << r.ops << ','
+                 << r.runs << ',' << r.ns_per_op << ',' << r.worst_ns_per_op << ',' << r.latency.p50 << ','
+                 << r.latency.p90 << ',' << r.latency.p99 << ',' << r.latency.p999 << ',' << r.latency.max << ','
+                 << r.latency.samples << ',' << r.ctx_switches << ',' << r.page_faults << ',';
+            // name=value pairs separated by ';' keep the column count fixed.
+            std::ostringstream counters;
+            counters << std::setprecision(6);
+            for (std::size_t c = 0; c < r.counters.size(); ++c) {
+                counters << (c == 0 ? "" : ";") << r.counters[c].first << '=' << r.counters[c].second;
+            }
+            body << csv_field(counters.str()) << '\n';
+        }
+        os << body.str();
+    }
+
+    Format format_;
+    std::string path_;
+    std::ofstream file_;
+    std::ostream null_{nullptr};
+    std::vector<Record> records_;
+    std::vector<std::pair<std::string, std::string>> env_;
+};
+
+} // namespace bench
@@ -0,0 +1,381 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Order messages of a NASDAQ TotalView-ITCH 5.0 capture, read in place from a
+// memory-mapped file. The file layout is the one NASDAQ distributes: every
+// message is prefixed by a 2-byte big-endian length. Only the messages that
+// change the order book are decoded (A, F, E, C, X, D, U); everything else
+// (system events, trades, imbalances, ...) is skipped by its length.
+//
+//     itch::MappedFile file("01302019.NASDAQ_ITCH50");
+//     itch::for_each_event(file.data(), file.size(), [&](const itch::Event& e) { ... });
+//
+// Fields are decoded straight from the mapping into a small Event on the
+// stack; nothing is copied or buffered between the file and the handler.
+namespace itch {
+
+// ITCH prices are unsigned integers with four implied decimals.
+constexpr std::uint32_t kPriceScale = 10000;
+
+enum class Kind : std::uint8_t {
+    Add,     // A and F: new resting order
+    Execute, // E and C: shares traded against a resting order
+    Cancel,  // X: shares removed from a resting order, which stays if any are left
+    Delete,  // D: order removed
+    Replace, // U: order replaced by new_order_id at a new price/size, losing priority
+};
+
+struct Event {
+    Kind kind;
+    char side;                  // 'B' or 'S'; Add only
+    std::uint16_t locate;       // instrument (stock locate code)
+    std::uint64_t timestamp;    // ns since midnight
+    std::uint64_t order_id;
+    std::uint64_t new_order_id; // Replace only
+    std::uint32_t shares;       // Add/Replace: size; Execute/Cancel: shares removed
+    std::uint32_t price;        // Add/Replace
+};
+
+struct Stats {
+    std::size_t messages = 0; // all framed messages
+    std::size_t events = 0;   // book messages passed to the handler
+};
+
+namespace detail {
+
+inline std::uint64_t load_be(const unsigned char* p, std::size_t bytes) {
+    std::uint64_t v = 0;
+    for (std::size_t i = 0; i < bytes; ++i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+inline std::uint16_t be16(const unsigned char* p) { return static_cast<std::uint16_t>((p[0] << 8) | p[1]); }
+
+inline std::uint32_t be32(const unsigned char* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return __builtin_bswap32(v);
+}
+
+inline std::uint64_t be64(const unsigned char* p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return __builtin_bswap64(v);
+}
+
+// Body length of each decoded message type, 0 for types that are skipped.
+constexpr std::size_t body_length(unsigned char type) {
+    switch (type) {
+    case 'A': return 36;
+    case 'F': return 40;
+    case 'E': return 31;
+    case 'C': return 36;
+    case 'X': return 23;
+    case 'D': return 19;
+    case 'U': return 35;
+    default: return 0;
+    }
+}
+
+inline void put_be(std::vector<unsigned char>& out, std::uint64_t v, std::size_t bytes) {
+    for (std::size_t i = bytes; i-- > 0;) {
+        out.push_back(static_cast<unsigned char>(v >> (8 * i)));
+    }
+}
+
+} // namespace detail
+
+// Calls fn(const Event&) for every book message in [data, data + size) and
+// returns the message counts. Throws std::runtime_error on a truncated frame
+// or a book message shorter than its type requires.
+template <typename Fn>
+Stats for_each_event(const void* data, std::size_t size, Fn&& fn) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    const unsigned char* const end = p + size;
+    Stats stats;
+    while (p != end) {
+        if (end - p < 2) {
+            throw std::runtime_error("ITCH capture ends inside a length prefix");
+        }
+        const std::size_t length = detail::be16(p);
+        p += 2;
+        if (static_cast<std::size_t>(end - p) < length || length == 0) {
+            throw std::runtime_error("ITCH capture ends inside a message");
+        }
+        const unsigned char* m = p;
+        p += length;
+        ++stats.messages;
+
+        const std::size_t needed = detail::body_length(m[0]);
+        if (needed == 0) {
+            continue;
+        }
+        if (length < needed) {
+            throw std::runtime_error(std::string("short ITCH '") + static_cast<char>(m[0]) + "' message");
+        }
+        Event e{};
+        e.locate = detail::be16(m + 1);
+        e.timestamp = detail::load_be(m + 5, 6);
+        e.order_id = detail::be64(m + 11);
+        switch (m[0]) {
+        case 'A':
+        case 'F':
+            e.kind = Kind::Add;
+            e.side = static_cast<char>(m[19]);
+            e.shares = detail::be32(m + 20);
+            e.price = detail::be32(m + 32);
+            break;
+        case 'E':
+        case 'C':
+            e.kind = Kind::Execute;
+            e.shares = detail::be32(m + 19);
+            break;
+        case 'X':
+            e.kind = Kind::Cancel;
+            e.shares = detail::be32(m + 19);
+            break;
+        case 'D':
+            e.kind = Kind::Delete;
+            break;
+        case 'U':
+            e.kind = Kind::Replace;
+            e.new_order_id = detail::be64(m + 19);
+            e.shares = detail::be32(m + 27);
+            e.price = detail::be32(m + 31);
+            break;
+        }
+        ++stats.events;
+        fn(static_cast<const Event&>(e));
+    }
+    return stats;
+}
+
+// Read-only private mapping of a whole file, populated up front so page
+// faults land in the constructor rather than in the timed replay.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            const int err = errno;
+            ::close(fd);
+            throw std::runtime_error("cannot stat " + path + ": " + std::strerror(err));
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ != 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+            if (p == MAP_FAILED) {
+                const int err = errno;
+                ::close(fd);
+                throw std::runtime_error("cannot map " + path + ": " + std::strerror(err));
+            }
+            ::madvise(p, size_, MADV_SEQUENTIAL);
+            data_ = p;
+        }
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile() { unmap(); }
+
+    const void* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    void unmap() {
+        if (data_ != nullptr) {
+            ::munmap(data_, size_);
+        }
+    }
+
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// Shape of one instrument (stock locate) in a capture: its message counts,
+// peak number of resting orders and the distinct prices it used, which bound
+// the book a replay needs.
+struct Profile {
+    std::uint16_t locate = 0;
+    std::size_t adds = 0;
+    std::size_t events = 0;
+    std::size_t peak_orders = 0;
+    std::size_t prices = 0;
+};
+
+// Profiles of every locate in one untimed pass, indexed by locate (65536
+// entries; unused locates have events == 0).
+inline std::vector<Profile> profile_all(const void* data, std::size_t size) {
+    struct Live {
+        std::uint16_t locate;
+        std::uint32_t shares;
+    };
+    std::vector<Profile> profiles(std::size_t{1} << 16);
+    std::vector<std::size_t> resting(profiles.size());
+    std::vector<std::unordered_set<std::uint32_t>> prices(profiles.size());
+    std::unordered_map<std::uint64_t, Live> live;
+    auto retire = [&](std::unordered_map<std::uint64_t, Live>::iterator it) {
+        --resting[it->second.locate];
+        live.erase(it);
+    };
+    for_each_event(data, size, [&](const Event& e) {
+        Profile& p = profiles[e.locate];
+        ++p.events;
+        switch (e.kind) {
+        case Kind::Add:
+            ++p.adds;
+            if (live.emplace(e.order_id, Live{e.locate, e.shares}).second) {
+                ++resting[e.locate];
+            }
+            prices[e.locate].insert(e.price);
+            break;
+        case Kind::Replace: {
+            auto it = live.find(e.order_id);
+            if (it != live.end()) {
+                retire(it);
+                if (live.emplace(e.new_order_id, Live{e.locate, e.shares}).second) {
+                    ++resting[e.locate];
+                }
+                prices[e.locate].insert(e.price);
+            }
+            break;
+        }
+        case Kind::Delete: {
+            auto it = live.find(e.order_id);
+            if (it != live.end()) {
+                retire(it);
+            }
+            break;
+        }
+        case Kind::Execute:
+        case Kind::Cancel: {
+            auto it = live.find(e.order_id);
+            if (it != live.end()) {
+                if (e.shares >= it->second.shares) {
+                    retire(it);
+                } else {
+                    it->second.shares -= e.shares;
+                }
+            }
+            break;
+        }
+        }
+        p.peak_orders = std::max(p.peak_orders, resting[e.locate]);
+    });
+    for (std::size_t locate = 0; locate < profiles.size(); ++locate) {
+        profiles[locate].locate = static_cast<std::uint16_t>(locate);
+        profiles[locate].prices = prices[locate].size();
+    }
+    return profiles;
+}
+
+// Profile of the busiest instrument (most adds).
+inline Profile profile(const void* data, std::size_t size) {
+    const std::vector<Profile> all = profile_all(data, size);
+    return *std::max_element(all.begin(), all.end(),
+                             [](const Profile& a, const Profile& b) { return a.adds < b.adds; });
+}
+
+// Writes ITCH 5.0 book messages with the same framing, for synthetic captures
+// and tests of the replay path. Unused fields (tracking number, stock,
+// match number, attribution) are filled with fixed values.
+class Writer {
+public:
+    void add(std::uint16_t locate, std::uint64_t ts, std::uint64_t id, char side, std::uint32_t shares,
+             std::uint32_t price) {
+        begin('A', locate, ts);
+        detail::put_be(buf_, id, 8);
+        buf_.push_back(static_cast<unsigned char>(side));
+        detail::put_be(buf_, shares, 4);
+        buf_.insert(buf_.end(), {'S', 'Y', 'N', 'T', 'H', ' ', ' ', ' '});
+        detail::put_be(buf_, price, 4);
+    }
+
+    void execute(std::uint16_t locate, std::uint64_t ts, std::uint64_t id, std::uint32_t shares) {
+        begin('E', locate, ts);
+        detail::put_be(buf_, id, 8);
+        detail::put_be(buf_, shares, 4);
+        detail::put_be(buf_, ++match_, 8);
+    }
+
+    void cancel(std::uint16_t locate, std::uint64_t ts, std::uint64_t id, std::uint32_t shares) {
+        begin('X', locate, ts);
+        detail::put_be(buf_, id, 8);
+        detail::put_be(buf_, shares, 4);
+    }
+
+    void remove(std::uint16_t locate, std::uint64_t ts, std::uint64_t id) {
+        begin('D', locate, ts);
+        detail::put_be(buf_, id, 8);
+    }
+
+    void replace(std::uint16_t locate, std::uint64_t ts, std::uint64_t id, std::uint64_t new_id,
+                 std::uint32_t shares, std::uint32_t price) {
+        begin('U', locate, ts);
+        detail::put_be(buf_, id, 8);
+        detail::put_be(buf_, new_id, 8);
+        detail::put_be(buf_, shares, 4);
+        detail::put_be(buf_, price, 4);
+    }
+
+    const std::vector<unsigned char>& bytes() const { return buf_; }
+
+    void save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(buf_.data()), static_cast<std::streamsize>(buf_.size()));
+        if (!out) {
+            throw std::runtime_error("cannot write " + path);
+        }
+    }
+
+private:
+    void begin(unsigned char type, std::uint16_t locate, std::uint64_t ts) {
+        detail::put_be(buf_, detail::body_length(type), 2);
+        buf_.push_back(type);
+        detail::put_be(buf_, locate, 2);
+        detail::put_be(buf_, 0, 2);
+        detail::put_be(buf_, ts, 6);
+    }
+
+    std::vector<unsigned char> buf_;
+    std::uint64_t match_ = 0;
+};
+
+} // namespace itch
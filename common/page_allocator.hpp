@@ -0,0 +1,243 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <string>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define MEM_HAS_LINUX 1
+#else
+#define MEM_HAS_LINUX 0
+#endif
+
+// Allocator for large, long-lived buffers (list slot arrays at 1M-order
+// depth, benchmark tick arrays) that controls the page size behind them and
+// the NUMA node they live on, and faults every page in at allocation so the
+// first pass over the data does not pay for it:
+//     arrlist_fast::ArrayLinkedList<Order, arrlist_fast::LifoFreeList, arrlist::ThrowChecks,
+//                                   mem::PageAllocator<Order, mem::Pages::Huge2M>> list(1 << 20);
+// Huge pages come from the hugetlbfs pool (MAP_HUGETLB, reserve with
+// vm.nr_hugepages or hugepages= on the kernel command line); when the pool
+// is empty the mapping falls back to transparent huge pages via
+// madvise(MADV_HUGEPAGE), which needs THP "madvise" or "always". Pages::Base4K
+// opts out of THP explicitly, as the 4K baseline. Linux only; elsewhere, and
+// for requests below kMinMappedBytes, it is plain operator new.
+
+namespace mem {
+
+enum class Pages : std::uint8_t { Base4K, Huge2M, Huge1G };
+
+// Node of the CPU the allocating thread runs on (so pin before allocating).
+constexpr int kLocalNode = -1;
+
+// Smaller requests are not worth a mapping; they go to operator new.
+constexpr std::size_t kMinMappedBytes = 64 * 1024;
+
+constexpr std::size_t page_bytes(Pages pages) {
+    return pages == Pages::Base4K ? std::size_t{4} << 10
+                                  : (pages == Pages::Huge2M ? std::size_t{2} << 20 : std::size_t{1} << 30);
+}
+
+// What the allocations so far actually got, in bytes, process-wide.
+struct PageStats {
+    std::uint64_t hugetlb = 0;       // MAP_HUGETLB mappings
+    std::uint64_t thp = 0;           // MADV_HUGEPAGE fallback (THP may still split or decline)
+    std::uint64_t base = 0;          // 4K mappings
+    std::uint64_t heap = 0;          // operator new
+    std::uint64_t bind_failures = 0; // mappings mbind() refused (left on the default policy)
+};
+
+inline PageStats operator-(PageStats a, PageStats b) {
+    return PageStats{a.hugetlb - b.hugetlb, a.thp - b.thp, a.base - b.base, a.heap - b.heap,
+                     a.bind_failures - b.bind_failures};
+}
+
+namespace detail {
+
+struct Counters {
+    std::atomic<std::uint64_t> hugetlb{0};
+    std::atomic<std::uint64_t> thp{0};
+    std::atomic<std::uint64_t> base{0};
+    std::atomic<std::uint64_t> heap{0};
+    std::atomic<std::uint64_t> bind_failures{0};
+};
+
+inline Counters& counters() {
+    static Counters c;
+    return c;
+}
+
+inline std::size_t round_up(std::size_t bytes, std::size_t unit) { return (bytes + unit - 1) / unit * unit; }
+
+#if MEM_HAS_LINUX
+inline int current_node() {
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+        return -1;
+    }
+    return static_cast<int>(node);
+}
+
+// MPOL_BIND to one node, without linking libnuma.
+inline bool bind_to_node(void* p, std::size_t len, int node) {
+    if (node < 0 || node >= 64) {
+        return false;
+    }
+    constexpr int kMpolBind = 2;
+    const unsigned long mask = 1UL << node;
+    return ::syscall(SYS_mbind, p, len, kMpolBind, &mask, sizeof(mask) * 8, 0) == 0;
+}
+
+// Maps len bytes (a multiple of the page size) backed as requested, falling
+// back from hugetlb to THP; nullptr when even that fails.
+inline void* map_pages(std::size_t len, Pages pages) {
+    constexpr int kProt = PROT_READ | PROT_WRITE;
+    constexpr int kFlags = MAP_PRIVATE | MAP_ANONYMOUS;
+    Counters& c = counters();
+    if (pages == Pages::Base4K) {
+        void* p = ::mmap(nullptr, len, kProt, kFlags, -1, 0);
+        if (p == MAP_FAILED) {
+            return nullptr;
+        }
+        ::madvise(p, len, MADV_NOHUGEPAGE);
+        c.base += len;
+        return p;
+    }
+    const int huge_shift = pages == Pages::Huge2M ? 21 : 30;
+    void* p = ::mmap(nullptr, len, kProt, kFlags | MAP_HUGETLB | (huge_shift << MAP_HUGE_SHIFT), -1, 0);
+    if (p != MAP_FAILED) {
+        c.hugetlb += len;
+        return p;
+    }
+    // THP only backs 2M-aligned ranges: over-map by one huge page and trim.
+    constexpr std::size_t kThp = std::size_t{2} << 20;
+    void* raw = ::mmap(nullptr, len + kThp, kProt, kFlags, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    const auto start = reinterpret_cast<std::uintptr_t>(raw);
+    const std::uintptr_t aligned = round_up(start, kThp);
+    if (aligned != start) {
+        ::munmap(raw, aligned - start);
+    }
+    ::munmap(reinterpret_cast<void*>(aligned + len), start + kThp - aligned);
+    p = reinterpret_cast<void*>(aligned);
+    ::madvise(p, len, MADV_HUGEPAGE);
+    c.thp += len;
+    return p;
+}
+#endif
+
+} // namespace detail
+
+inline PageStats page_stats() {
+    const detail::Counters& c = detail::counters();
+    return PageStats{c.hugetlb.load(), c.thp.load(), c.base.load(), c.heap.load(), c.bind_failures.load()};
+}
+
+// What a PageStats delta got, for benchmark output: "24 MB hugetlb, 1 MB heap".
+inline std::string describe(const PageStats& s) {
+    auto mb = [](std::uint64_t bytes) { return std::to_string((bytes + (1 << 19)) >> 20) + " MB"; };
+    std::string text;
+    auto part = [&](const char* what, std::uint64_t bytes) {
+        if (bytes != 0) {
+            text += (text.empty() ? "" : ", ") + mb(bytes) + " " + what;
+        }
+    };
+    part("hugetlb", s.hugetlb);
+    part("THP (madvise)", s.thp);
+    part("4K", s.base);
+    part("heap", s.heap);
+    if (text.empty()) {
+        text = "default allocator";
+    }
+    if (s.bind_failures != 0) {
+        text += " (" + std::to_string(s.bind_failures) + " mappings not NUMA-bound)";
+    }
+    return text;
+}
+
+// Free pages in the hugetlbfs pool of this size (0 when none are reserved).
+inline std::size_t hugetlb_pages_free(Pages pages) {
+    const std::string kb = std::to_string(page_bytes(pages) >> 10);
+    std::ifstream in("/sys/kernel/mm/hugepages/hugepages-" + kb + "kB/free_hugepages");
+    std::size_t n = 0;
+    return in >> n ? n : 0;
+}
+
+// Stateless, so every instance compares equal and containers move freely.
+// Node is a NUMA node id or kLocalNode.
+template <typename T, Pages PageSize = Pages::Huge2M, int Node = kLocalNode>
+class PageAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = PageAllocator<U, PageSize, Node>;
+    };
+
+    PageAllocator() = default;
+
+    template <typename U>
+    PageAllocator(const PageAllocator<U, PageSize, Node>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (n > static_cast<std::size_t>(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const std::size_t bytes = n * sizeof(T);
+#if MEM_HAS_LINUX
+        if (bytes >= kMinMappedBytes) {
+            const std::size_t len = detail::round_up(bytes, page_bytes(PageSize));
+            void* p = detail::map_pages(len, PageSize);
+            if (p == nullptr) {
+                throw std::bad_alloc();
+            }
+            // Bind before the first touch; the prefault then allocates every
+            // page on the node, so later accesses never fault or go remote.
+            if (!detail::bind_to_node(p, len, Node == kLocalNode ? detail::current_node() : Node)) {
+                ++detail::counters().bind_failures;
+            }
+            auto* touch = static_cast<volatile char*>(p);
+            for (std::size_t off = 0; off < bytes; off += page_bytes(Pages::Base4K)) {
+                touch[off] = 0;
+            }
+            return static_cast<T*>(p);
+        }
+#endif
+        detail::counters().heap += bytes;
+        return static_cast<T*>(::operator new(bytes, std::align_val_t{alignof(T)}));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        const std::size_t bytes = n * sizeof(T);
+#if MEM_HAS_LINUX
+        if (bytes >= kMinMappedBytes) {
+            ::munmap(p, detail::round_up(bytes, page_bytes(PageSize)));
+            return;
+        }
+#endif
+        ::operator delete(p, std::align_val_t{alignof(T)});
+    }
+
+    template <typename U>
+    bool operator==(const PageAllocator<U, PageSize, Node>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PageAllocator<U, PageSize, Node>&) const noexcept {
+        return false;
+    }
+};
+
+} // namespace mem
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define BENCH_HAS_PERF 1
+#else
+#define BENCH_HAS_PERF 0
+#endif
+
+// Hardware cache events of the calling thread around the timed loop of a
+// benchmark, so a slow or unstable case can be told apart as "more misses"
+// or "same misses, something else" (--perf). OpTimer::start() opens the
+// region and OpTimer::take() closes it into last_perf_sample(), so every
+// benchmark that uses an OpTimer is covered without changes. Needs
+// perf_event_paranoid <= 2 and a PMU the kernel exposes (many VMs have none);
+// otherwise the counters report unavailable and the samples stay invalid.
+
+namespace bench {
+
+struct PerfSample {
+    std::uint64_t cache_misses = 0;     // PERF_COUNT_HW_CACHE_MISSES (last-level misses on x86)
+    std::uint64_t cache_references = 0; // PERF_COUNT_HW_CACHE_REFERENCES
+    bool valid = false;
+};
+
+// One event group (misses as leader, references alongside) on the calling
+// thread, user space only. Not copyable: it owns the file descriptors.
+class PerfCounters {
+public:
+    PerfCounters() {
+#if BENCH_HAS_PERF
+        leader_ = open_event(PERF_COUNT_HW_CACHE_MISSES, -1);
+        if (leader_ < 0) {
+            error_ = std::string("perf_event_open: ") + std::strerror(errno);
+            return;
+        }
+        refs_ = open_event(PERF_COUNT_HW_CACHE_REFERENCES, leader_);
+        if (refs_ < 0) {
+            error_ = std::string("perf_event_open: ") + std::strerror(errno);
+            ::close(leader_);
+            leader_ = -1;
+        }
+#else
+        error_ = "not supported on this platform";
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#if BENCH_HAS_PERF
+        if (refs_ >= 0) {
+            ::close(refs_);
+        }
+        if (leader_ >= 0) {
+            ::close(leader_);
+        }
+#endif
+    }
+
+    bool available() const { return leader_ >= 0; }
+    const std::string& error() const { return error_; }
+
+    void start() {
+#if BENCH_HAS_PERF
+        if (available()) {
+            ::ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ::ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    PerfSample stop() {
+        PerfSample s;
+#if BENCH_HAS_PERF
+        if (!available()) {
+            return s;
+        }
+        ::ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        // PERF_FORMAT_GROUP: the event count, then one value per event.
+        std::uint64_t values[3] = {};
+        if (::read(leader_, values, sizeof(values)) == static_cast<ssize_t>(sizeof(values)) && values[0] == 2) {
+            s.cache_misses = values[1];
+            s.cache_references = values[2];
+            s.valid = true;
+        }
+#endif
+        return s;
+    }
+
+private:
+#if BENCH_HAS_PERF
+    static int open_event(std::uint64_t config, int group) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = group < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+    }
+#endif
+
+    int leader_ = -1;
+    int refs_ = -1;
+    std::string error_;
+};
+
+// Set by setup_runner() from --perf; off, the OpTimer hooks are one untaken
+// branch outside the timed loop.
+inline bool& perf_enabled() {
+    static bool value = false;
+    return value;
+}
+
+inline PerfCounters& thread_perf_counters() {
+    static thread_local PerfCounters counters;
+    return counters;
+}
+
+// Counts of the most recent OpTimer region on this thread.
+inline PerfSample& last_perf_sample() {
+    static thread_local PerfSample sample;
+    return sample;
+}
+
+} // namespace bench
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include "fixed_point.hpp"
+
+// Batch kernels over SoA arrays of FixedPoint values, e.g. recomputing mid,
+// spread and notional for a whole book snapshot:
+//     fixed::add<FixedDouble>(bid, ask, mid);
+//     fixed::div_by_const<FixedDouble>(mid, FixedDouble::from_int(2), mid);
+//     fixed::sub<FixedDouble>(ask, bid, spread);
+//     fixed::mul_scaled<FixedDouble>(bid, bid_qty, notional);
+// Results are bit-identical to the scalar operators under the type's overflow
+// policy (add/sub are only vectorised for policies that wrap). out may be the
+// same span as an input. C++20 (span), so it is kept out of fixed_point.hpp.
+//
+// With AVX-512F or AVX2 enabled (-march=native) each call processes 8 or 4
+// int64 lanes at a time. Neither has a 64x64->128 multiply, so the product is
+// one 32x32->64 multiply when the operands allow it and four otherwise, and
+// the division by the constant is Divider64's magic multiply-high, emulated
+// the same way. Lanes whose product does not fit in 64 bits (or whose quotient
+// saturates) are rare and redone with the scalar operator. batch::add<Isa>
+// etc. pick the instruction set explicitly.
+
+// GCC 12's AVX-512 headers trip -Wmaybe-uninitialized once inlined
+// (_mm512_undefined_epi32); the values are never read.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace fixed {
+
+namespace batch {
+
+// Instruction set selectors; native is the widest one compiled in.
+struct Scalar {
+    static constexpr std::size_t lanes = 1;
+};
+
+#if defined(__AVX2__)
+struct Avx2 {
+    using reg = __m256i;
+    static constexpr std::size_t lanes = 4;
+
+    static reg load(const void* p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+    static void store(void* p, reg v) { _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+    static reg set1(std::uint64_t v) { return _mm256_set1_epi64x(static_cast<long long>(v)); }
+    static reg add(reg a, reg b) { return _mm256_add_epi64(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_epi64(a, b); }
+    static reg and_(reg a, reg b) { return _mm256_and_si256(a, b); }
+    static reg or_(reg a, reg b) { return _mm256_or_si256(a, b); }
+    static reg xor_(reg a, reg b) { return _mm256_xor_si256(a, b); }
+    template <int N>
+    static reg srli(reg a) { return _mm256_srli_epi64(a, N); }
+    template <int N>
+    static reg slli(reg a) { return _mm256_slli_epi64(a, N); }
+    static reg srl(reg a, unsigned n) { return _mm256_srl_epi64(a, _mm_cvtsi32_si128(static_cast<int>(n))); }
+    static reg mul_epu32(reg a, reg b) { return _mm256_mul_epu32(a, b); }
+    static reg sign_mask(reg a) { return _mm256_cmpgt_epi64(_mm256_setzero_si256(), a); }
+    static bool any(reg a) { return !_mm256_testz_si256(a, a); }
+};
+#endif
+
+#if defined(__AVX512F__)
+struct Avx512 {
+    using reg = __m512i;
+    static constexpr std::size_t lanes = 8;
+
+    static reg load(const void* p) { return _mm512_loadu_si512(p); }
+    static void store(void* p, reg v) { _mm512_storeu_si512(p, v); }
+    static reg set1(std::uint64_t v) { return _mm512_set1_epi64(static_cast<long long>(v)); }
+    static reg add(reg a, reg b) { return _mm512_add_epi64(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_epi64(a, b); }
+    static reg and_(reg a, reg b) { return _mm512_and_si512(a, b); }
+    static reg or_(reg a, reg b) { return _mm512_or_si512(a, b); }
+    static reg xor_(reg a, reg b) { return _mm512_xor_si512(a, b); }
+    template <int N>
+    static reg srli(reg a) { return _mm512_srli_epi64(a, N); }
+    template <int N>
+    static reg slli(reg a) { return _mm512_slli_epi64(a, N); }
+    static reg srl(reg a, unsigned n) { return _mm512_srl_epi64(a, _mm_cvtsi32_si128(static_cast<int>(n))); }
+    static reg mul_epu32(reg a, reg b) { return _mm512_mul_epu32(a, b); }
+    static reg sign_mask(reg a) { return _mm512_srai_epi64(a, 63); }
+    static bool any(reg a) { return _mm512_test_epi64_mask(a, a) != 0; }
+};
+using native = Avx512;
+#elif defined(__AVX2__)
+using native = Avx2;
+#else
+using native = Scalar;
+#endif
+
+namespace detail {
+
+// Unsigned 64x64 -> 128 per lane from 32-bit halves: lo is returned, the
+// high word goes to hi.
+template <typename V>
+typename V::reg mul_wide(typename V::reg a, typename V::reg b, typename V::reg& hi) {
+    const auto low32 = V::set1(0xFFFFFFFFull);
+    const auto a_hi = V::template srli<32>(a);
+    const auto b_hi = V::template srli<32>(b);
+    const auto ll = V::mul_epu32(a, b);
+    const auto lh = V::mul_epu32(a, b_hi);
+    const auto hl = V::mul_epu32(a_hi, b);
+    const auto hh = V::mul_epu32(a_hi, b_hi);
+    const auto mid = V::add(V::add(V::template srli<32>(ll), V::and_(lh, low32)), V::and_(hl, low32));
+    hi = V::add(V::add(hh, V::template srli<32>(lh)), V::add(V::template srli<32>(hl), V::template srli<32>(mid)));
+    return V::or_(V::and_(ll, low32), V::template slli<32>(mid));
+}
+
+// |a| * |b| as (lo, hi). When every lane of both is below 2^32 (raw prices
+// and quantities almost always are) that is one 32x32->64 multiply and hi is
+// zero; otherwise the full emulated product.
+template <typename V>
+typename V::reg mul_magnitudes(typename V::reg a, typename V::reg b, typename V::reg& hi) {
+    if (!V::any(V::template srli<32>(V::or_(a, b)))) {
+        hi = V::set1(0);
+        return V::mul_epu32(a, b);
+    }
+    return mul_wide<V>(a, b, hi);
+}
+
+// Divider64::divide per lane.
+template <typename V>
+typename V::reg divide(const Divider64& d, typename V::reg n) {
+    if (d.magic() == 0) {
+        return V::srl(n, d.shift());
+    }
+    typename V::reg q;
+    mul_wide<V>(n, V::set1(d.magic()), q);
+    if (d.needs_add()) {
+        q = V::add(V::template srli<1>(V::sub(n, q)), q);
+    }
+    return V::srl(q, d.shift());
+}
+
+// |a| and the all-ones mask of negative lanes; |INT64_MIN| is 2^63 as an
+// unsigned lane.
+template <typename V>
+typename V::reg magnitude(typename V::reg a, typename V::reg& sign) {
+    sign = V::sign_mask(a);
+    return V::sub(V::xor_(a, sign), sign);
+}
+
+template <typename Fixed>
+void check_sizes(std::size_t a, std::size_t b, std::size_t out) {
+    static_assert(sizeof(Fixed) == sizeof(typename Fixed::storage_type) && std::is_standard_layout<Fixed>::value,
+                  "batch kernels treat spans of Fixed as arrays of raw values");
+    if (a != out || b != out) {
+        throw std::invalid_argument("fixed batch kernel: span sizes differ");
+    }
+}
+
+template <typename Isa, typename Fixed>
+constexpr bool vectorised() {
+    return !std::is_same<Isa, Scalar>::value && std::is_same<typename Fixed::storage_type, std::int64_t>::value;
+}
+
+// A vector add/sub wraps, which only some overflow policies allow; * and /
+// redo every lane that could overflow with the scalar operator anyway.
+template <typename Isa, typename Fixed>
+constexpr bool vectorised_add() {
+    return vectorised<Isa, Fixed>() && Fixed::overflow_policy::add_wraps;
+}
+
+} // namespace detail
+
+template <typename Isa = native, typename Fixed>
+void add(std::span<const Fixed> a, std::span<const Fixed> b, std::span<Fixed> out) {
+    detail::check_sizes<Fixed>(a.size(), b.size(), out.size());
+    std::size_t i = 0;
+    if constexpr (detail::vectorised_add<Isa, Fixed>()) {
+        for (; i + Isa::lanes <= out.size(); i += Isa::lanes) {
+            Isa::store(&out[i], Isa::add(Isa::load(&a[i]), Isa::load(&b[i])));
+        }
+    }
+    for (; i < out.size(); ++i) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+template <typename Isa = native, typename Fixed>
+void sub(std::span<const Fixed> a, std::span<const Fixed> b, std::span<Fixed> out) {
+    detail::check_sizes<Fixed>(a.size(), b.size(), out.size());
+    std::size_t i = 0;
+    if constexpr (detail::vectorised_add<Isa, Fixed>()) {
+        for (; i + Isa::lanes <= out.size(); i += Isa::lanes) {
+            Isa::store(&out[i], Isa::sub(Isa::load(&a[i]), Isa::load(&b[i])));
+        }
+    }
+    for (; i < out.size(); ++i) {
+        out[i] = a[i] - b[i];
+    }
+}
+
+// out[i] = a[i] * b[i], rescaled by the compile-time scale.
+template <typename Isa = native, typename Fixed>
+void mul_scaled(std::span<const Fixed> a, std::span<const Fixed> b, std::span<Fixed> out) {
+    detail::check_sizes<Fixed>(a.size(), b.size(), out.size());
+    std::size_t i = 0;
+    if constexpr (detail::vectorised<Isa, Fixed>()) {
+        constexpr Divider64 kScale(static_cast<std::uint64_t>(Fixed::scale));
+        for (; i + Isa::lanes <= out.size(); i += Isa::lanes) {
+            typename Isa::reg sign_a;
+            typename Isa::reg sign_b;
+            typename Isa::reg hi;
+            const auto lo = detail::mul_magnitudes<Isa>(detail::magnitude<Isa>(Isa::load(&a[i]), sign_a),
+                                                        detail::magnitude<Isa>(Isa::load(&b[i]), sign_b), hi);
+            const auto q = detail::divide<Isa>(kScale, lo);
+            // Fast path only while |a * b| < 2^64 and the quotient fits.
+            if (Isa::any(Isa::or_(hi, Isa::template srli<63>(q)))) {
+                for (std::size_t j = i; j < i + Isa::lanes; ++j) {
+                    out[j] = a[j] * b[j];
+                }
+                continue;
+            }
+            const auto sign = Isa::xor_(sign_a, sign_b);
+            Isa::store(&out[i], Isa::sub(Isa::xor_(q, sign), sign));
+        }
+    }
+    for (; i < out.size(); ++i) {
+        out[i] = a[i] * b[i];
+    }
+}
+
+// out[i] = in[i] / den for one runtime denominator, the operator/ result
+// without a hardware divide. Throws std::overflow_error when den is zero.
+template <typename Isa = native, typename Fixed>
+void div_by_const(std::span<const Fixed> in, Fixed den, std::span<Fixed> out) {
+    detail::check_sizes<Fixed>(in.size(), in.size(), out.size());
+    const FixedDivisor<Fixed> divisor(den);
+    std::size_t i = 0;
+    if constexpr (detail::vectorised<Isa, Fixed>()) {
+        const Divider64 divider(static_cast<std::uint64_t>(fixed::detail::magnitude(den.raw_value())));
+        const auto scale = Isa::set1(static_cast<std::uint64_t>(Fixed::scale));
+        const auto den_sign = Isa::set1(den.raw_value() < 0 ? ~std::uint64_t{0} : 0);
+        for (; i + Isa::lanes <= out.size(); i += Isa::lanes) {
+            typename Isa::reg sign;
+            typename Isa::reg hi;
+            const auto lo = detail::mul_magnitudes<Isa>(detail::magnitude<Isa>(Isa::load(&in[i]), sign), scale, hi);
+            const auto q = detail::divide<Isa>(divider, lo);
+            if (Isa::any(Isa::or_(hi, Isa::template srli<63>(q)))) {
+                for (std::size_t j = i; j < i + Isa::lanes; ++j) {
+                    out[j] = in[j] / divisor;
+                }
+                continue;
+            }
+            sign = Isa::xor_(sign, den_sign);
+            Isa::store(&out[i], Isa::sub(Isa::xor_(q, sign), sign));
+        }
+    }
+    for (; i < out.size(); ++i) {
+        out[i] = in[i] / divisor;
+    }
+}
+
+// Sum of a[i] * b[i], rescaled once (see FixedAccumulator). Scalar on
+// purpose: the 64x64->128 multiply that keeps it exact has no vector form,
+// and a hardware mul per element already runs at one per cycle. Two partial
+// sums keep the 128-bit add chains from serialising.
+template <typename Fixed>
+Fixed dot(std::span<const Fixed> a, std::span<const Fixed> b) {
+    detail::check_sizes<Fixed>(a.size(), b.size(), a.size());
+    FixedAccumulator<Fixed> even;
+    FixedAccumulator<Fixed> odd;
+    std::size_t i = 0;
+    for (; i + 2 <= a.size(); i += 2) {
+        even.add_product(a[i], b[i]);
+        odd.add_product(a[i + 1], b[i + 1]);
+    }
+    if (i < a.size()) {
+        even.add_product(a[i], b[i]);
+    }
+    even += odd;
+    return even.result();
+}
+
+} // namespace batch
+
+// The kernels with the widest instruction set compiled in.
+template <typename Fixed>
+void add(std::span<const Fixed> a, std::span<const Fixed> b, std::span<Fixed> out) {
+    batch::add<batch::native>(a, b, out);
+}
+
+template <typename Fixed>
+void sub(std::span<const Fixed> a, std::span<const Fixed> b, std::span<Fixed> out) {
+    batch::sub<batch::native>(a, b, out);
+}
+
+template <typename Fixed>
+void mul_scaled(std::span<const Fixed> a, std::span<const Fixed> b, std::span<Fixed> out) {
+    batch::mul_scaled<batch::native>(a, b, out);
+}
+
+template <typename Fixed>
+void div_by_const(std::span<const Fixed> in, Fixed den, std::span<Fixed> out) {
+    batch::div_by_const<batch::native>(in, den, out);
+}
+
+using batch::dot;
+
+} // namespace fixed
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
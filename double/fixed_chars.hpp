@@ -0,0 +1,341 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <system_error>
+
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+// Digit-level kernels behind FixedPoint::parse / fixed::from_chars /
+// fixed::to_chars. They work on the unsigned magnitude scaled by 10^FracDigits
+// and know nothing about FixedPoint, so fixed_point.hpp can include them.
+
+namespace fixed {
+
+namespace detail {
+
+inline constexpr std::uint64_t kPow10Table[20] = {
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+    1000000000ull,
+    10000000000ull,
+    100000000000ull,
+    1000000000000ull,
+    10000000000000ull,
+    100000000000000ull,
+    1000000000000000ull,
+    10000000000000000ull,
+    100000000000000000ull,
+    1000000000000000000ull,
+    10000000000000000000ull,
+};
+
+// Number of decimal digits d with 10^d == scale, or -1 if scale is not a
+// power of ten.
+constexpr int pow10_exponent(std::int64_t scale) {
+    for (int d = 0; d < 19; ++d) {
+        if (static_cast<std::uint64_t>(scale) == kPow10Table[d]) {
+            return d;
+        }
+    }
+    return -1;
+}
+
+inline constexpr bool is_digit(char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+// SWAR ("SIMD within a register") digit handling, eight ASCII bytes at a
+// time: one load, a range check and three multiplies instead of eight
+// dependent multiply-adds. Bytes are taken in memory order, which needs a
+// little-endian load; other targets use the scalar loops only. With SSE4.1
+// (-march=native) short fields take the 16-byte window path below instead.
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+inline constexpr bool kSwarDigits = true;
+#else
+inline constexpr bool kSwarDigits = false;
+#endif
+
+// True while the compiler evaluates a constant expression (what C++20 calls
+// std::is_constant_evaluated; the builtin also works in C++17). The parse
+// entry points are constexpr and leave the SWAR and SSE paths, which load
+// through memcpy and intrinsics, to run time.
+constexpr bool is_constant_evaluated() { return __builtin_is_constant_evaluated(); }
+
+constexpr bool use_swar_digits() { return kSwarDigits && !is_constant_evaluated(); }
+
+inline std::uint64_t load8(const char* p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint32_t load4(const char* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline bool is_eight_digits(std::uint64_t v) {
+    return (((v & 0xF0F0F0F0F0F0F0F0ull) | (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) ==
+            0x3333333333333333ull);
+}
+
+inline std::uint32_t parse_eight_digits(std::uint64_t v) {
+    constexpr std::uint64_t kMask = 0x000000FF000000FFull;
+    constexpr std::uint64_t kMul1 = 100 + (1000000ull << 32);
+    constexpr std::uint64_t kMul2 = 1 + (10000ull << 32);
+    v -= 0x3030303030303030ull;
+    v = (v * 10) + (v >> 8); // pairs of digits
+    v = (((v & kMask) * kMul1) + (((v >> 16) & kMask) * kMul2)) >> 32;
+    return static_cast<std::uint32_t>(v);
+}
+
+// The first min(len, 16) bytes at p, zero-padded, without reading outside
+// [p, p + len): short fields are assembled from two overlapping loads.
+inline void load_window(const char* p, std::size_t len, std::uint64_t& lo, std::uint64_t& hi) {
+    lo = 0;
+    hi = 0;
+    if (len >= 16) {
+        lo = load8(p);
+        hi = load8(p + 8);
+    } else if (len >= 8) {
+        lo = load8(p);
+        hi = len == 8 ? 0 : load8(p + len - 8) >> (8 * (16 - len));
+    } else if (len >= 4) {
+        lo = load4(p) | (static_cast<std::uint64_t>(load4(p + len - 4)) << (8 * (len - 4)));
+    } else if (len > 0) {
+        const auto byte = [p](std::size_t i) { return static_cast<std::uint64_t>(static_cast<unsigned char>(p[i])); };
+        lo = byte(0) | (byte(len / 2) << (8 * (len / 2))) | (byte(len - 1) << (8 * (len - 1)));
+    }
+}
+
+struct DecimalParse {
+    const char* ptr;          // first character not consumed
+    std::uint64_t magnitude;  // |value| * 10^FracDigits, rounded; valid unless overflow
+    bool negative;
+    bool valid;               // at least one digit
+    bool overflow;            // magnitude does not fit in 64 bits
+};
+
+// General case of parse_decimal below, one digit (or eight, SWAR) at a time;
+// p is past the sign.
+template <unsigned FracDigits>
+constexpr DecimalParse parse_decimal_loop(const char* first, const char* p, const char* last, bool negative) {
+    constexpr std::uint64_t kFracScale = kPow10Table[FracDigits];
+
+    DecimalParse out{first, 0, negative, false, false};
+
+    // Integer part; overflow is sticky and the digits are still consumed.
+    std::uint64_t int_part = 0;
+    bool overflow = false;
+    const char* const int_begin = p;
+    if (use_swar_digits()) {
+        while (last - p >= 8 && is_eight_digits(load8(p))) {
+            overflow |= __builtin_mul_overflow(int_part, std::uint64_t{100000000}, &int_part);
+            overflow |= __builtin_add_overflow(int_part, parse_eight_digits(load8(p)), &int_part);
+            p += 8;
+        }
+    }
+    while (p != last && is_digit(*p)) {
+        overflow |= __builtin_mul_overflow(int_part, std::uint64_t{10}, &int_part);
+        overflow |= __builtin_add_overflow(int_part, static_cast<std::uint64_t>(*p - '0'), &int_part);
+        ++p;
+    }
+    bool any_digits = p != int_begin;
+
+    // Fractional part: the first FracDigits digits, one more for rounding,
+    // the rest skipped.
+    std::uint64_t frac = 0;
+    unsigned frac_digits = 0;
+    bool round_up = false;
+    if (p != last && *p == '.') {
+        const char* const frac_begin = ++p;
+        if (FracDigits >= 8 && use_swar_digits()) {
+            while (frac_digits + 8 <= FracDigits && last - p >= 8 && is_eight_digits(load8(p))) {
+                frac = frac * 100000000 + parse_eight_digits(load8(p));
+                p += 8;
+                frac_digits += 8;
+            }
+        }
+        while (frac_digits < FracDigits && p != last && is_digit(*p)) {
+            frac = frac * 10 + static_cast<std::uint64_t>(*p - '0');
+            ++p;
+            ++frac_digits;
+        }
+        if (p != last && is_digit(*p)) {
+            round_up = *p >= '5';
+            ++p;
+            if (use_swar_digits()) {
+                while (last - p >= 8 && is_eight_digits(load8(p))) {
+                    p += 8;
+                }
+            }
+            while (p != last && is_digit(*p)) {
+                ++p;
+            }
+        }
+        any_digits |= p != frac_begin;
+    }
+    if (!any_digits) {
+        return out; // not a number; ptr stays at first
+    }
+
+    frac *= kPow10Table[FracDigits - frac_digits];
+    std::uint64_t mag = 0;
+    overflow |= __builtin_mul_overflow(int_part, kFracScale, &mag);
+    overflow |= __builtin_add_overflow(mag, frac + (round_up ? 1 : 0), &mag);
+
+    out.ptr = p;
+    out.magnitude = mag;
+    out.valid = true;
+    out.overflow = overflow;
+    return out;
+}
+
+#if defined(__SSE4_1__)
+// Fast path for numbers that end within the first 16 bytes at p: a short feed
+// or JSON field (at most 16 digits once the fraction is cut to FracDigits + 1)
+// is one 16-byte window, two compare masks to find the '.' and the end, a
+// pshufb that drops the '.' and right-aligns the digits, and three
+// multiply-add steps for the 16-digit value, with no per-character branches.
+// Returns false when the field does not fit; the caller takes the loop.
+template <unsigned FracDigits>
+bool parse_decimal_window(const char* first, const char* p, const char* last, bool negative, DecimalParse& out) {
+    constexpr unsigned kKeep = FracDigits + 1; // fraction digits that matter
+    const auto len = static_cast<std::size_t>(last - p);
+    __m128i bytes;
+    if (len >= 16) {
+        bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    } else {
+        std::uint64_t lo;
+        std::uint64_t hi;
+        load_window(p, len, lo, hi);
+        bytes = _mm_set_epi64x(static_cast<long long>(hi), static_cast<long long>(lo));
+    }
+    const __m128i values = _mm_sub_epi8(bytes, _mm_set1_epi8('0'));
+    const __m128i is_digit_v = _mm_cmpeq_epi8(_mm_min_epu8(values, _mm_set1_epi8(9)), values);
+    // Bit 16 stands for everything past the window.
+    const unsigned nondigit = (~static_cast<unsigned>(_mm_movemask_epi8(is_digit_v)) & 0xFFFFu) | 0x10000u;
+    const auto dots = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('.'))));
+
+    const auto int_len = static_cast<unsigned>(__builtin_ctz(nondigit));
+    if (int_len >= 15) {
+        return false; // no room left for a fraction
+    }
+    const unsigned has_dot = (dots >> int_len) & 1u;
+    const unsigned frac_begin = int_len + has_dot;
+    const unsigned frac_len = has_dot != 0 ? static_cast<unsigned>(__builtin_ctz(nondigit >> frac_begin)) : 0;
+    const unsigned end = frac_begin + frac_len;
+    const unsigned kept = frac_len < kKeep ? frac_len : kKeep;
+    const unsigned digits = int_len + kept;
+    if ((end >= 16 && len > 16) || digits > 16) {
+        return false;
+    }
+    if (digits == 0) {
+        out = DecimalParse{first, 0, negative, false, false};
+        return true;
+    }
+
+    // Output byte j takes digit t = j - (16 - digits) of int digits followed
+    // by the kept fraction digits, skipping the '.'; negative t (leading
+    // padding) has its top bit set, which pshufb turns into a zero.
+    const __m128i iota = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i index = _mm_sub_epi8(iota, _mm_set1_epi8(static_cast<char>(16 - digits)));
+    index = _mm_sub_epi8(index, _mm_cmpgt_epi8(index, _mm_set1_epi8(static_cast<char>(int_len - 1))));
+    const __m128i aligned = _mm_shuffle_epi8(values, index);
+
+    const __m128i pairs = _mm_maddubs_epi16(aligned, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+    const __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    const __m128i packed = _mm_packus_epi32(quads, quads);
+    const __m128i octets = _mm_madd_epi16(packed, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+    std::uint64_t n = static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_cvtsi128_si32(octets))) * 100000000 +
+                      static_cast<std::uint32_t>(_mm_extract_epi32(octets, 1));
+
+    bool round_up = false;
+    unsigned scale_digits = kept;
+    if (kept == kKeep) {
+        round_up = n % 10 >= 5;
+        n /= 10;
+        scale_digits = FracDigits;
+    }
+    std::uint64_t mag = 0;
+    bool overflow = __builtin_mul_overflow(n, kPow10Table[FracDigits - scale_digits], &mag);
+    overflow |= __builtin_add_overflow(mag, std::uint64_t{round_up}, &mag);
+    out = DecimalParse{p + end, mag, negative, true, overflow};
+    return true;
+}
+#endif
+
+// Parses [-]digits[.digits] (either digit run may be empty, not both) into
+// |value| * 10^FracDigits. Digits past FracDigits round half away from zero,
+// as from_double's llround does; they are consumed either way. No leading
+// whitespace, '+', exponent, "inf" or "nan", the same as std::from_chars
+// with chars_format::fixed.
+template <unsigned FracDigits>
+constexpr DecimalParse parse_decimal(const char* first, const char* last) {
+    static_assert(FracDigits <= 18, "at most 18 fractional digits");
+    const char* p = first;
+    const bool negative = p != last && *p == '-';
+    p += negative ? 1 : 0;
+#if defined(__SSE4_1__)
+    if constexpr (FracDigits <= 8) {
+        if (!is_constant_evaluated()) {
+            DecimalParse out{};
+            if (parse_decimal_window<FracDigits>(first, p, last, negative, out)) {
+                return out;
+            }
+        }
+    }
+#endif
+    return parse_decimal_loop<FracDigits>(first, p, last, negative);
+}
+
+// Writes [-]int.frac with exactly FracDigits fractional digits (no '.' when
+// FracDigits is 0). Returns nullptr when [first, last) is too small.
+template <unsigned FracDigits>
+char* format_decimal(char* first, char* last, bool negative, std::uint64_t magnitude) {
+    static_assert(FracDigits <= 18, "at most 18 fractional digits");
+    constexpr std::uint64_t kFracScale = kPow10Table[FracDigits];
+
+    char* p = first;
+    if (negative) {
+        if (p == last) {
+            return nullptr;
+        }
+        *p++ = '-';
+    }
+    const auto int_res = std::to_chars(p, last, magnitude / kFracScale);
+    if (int_res.ec != std::errc()) {
+        return nullptr;
+    }
+    p = int_res.ptr;
+    if constexpr (FracDigits > 0) {
+        if (last - p < static_cast<std::ptrdiff_t>(FracDigits) + 1) {
+            return nullptr;
+        }
+        *p = '.';
+        std::uint64_t frac = magnitude % kFracScale;
+        for (unsigned i = FracDigits; i > 0; --i) {
+            p[i] = static_cast<char>('0' + frac % 10);
+            frac /= 10;
+        }
+        p += FracDigits + 1;
+    }
+    return p;
+}
+
+} // namespace detail
+
+} // namespace fixed
@@ -0,0 +1,827 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "fixed_chars.hpp"
+
+// consteval where the compiler has it (C++20), so the literal operators can
+// only run at compile time; constexpr before that, which still evaluates them
+// at compile time in any constant expression.
+#if defined(__cpp_consteval)
+#define FIXED_CONSTEVAL consteval
+#else
+#define FIXED_CONSTEVAL constexpr
+#endif
+
+namespace fixed {
+
+// 10^n as a compile-time constant, e.g. FixedPoint<fixed::pow10(8)> for eight
+// decimals.
+constexpr std::int64_t pow10(unsigned n) {
+    std::int64_t result = 1;
+    while (n-- > 0) {
+        result *= 10;
+    }
+    return result;
+}
+
+namespace detail {
+
+// Double-width type used for intermediate products.
+template <typename Storage>
+struct wide;
+
+template <>
+struct wide<std::int32_t> {
+    using type = std::int64_t;
+};
+
+template <>
+struct wide<std::int64_t> {
+    using type = __int128;
+};
+
+template <typename Storage, typename Wide>
+constexpr Storage saturate(Wide value) {
+    constexpr Storage kMax = std::numeric_limits<Storage>::max();
+    constexpr Storage kMin = std::numeric_limits<Storage>::min();
+    if (value > static_cast<Wide>(kMax)) {
+        return kMax;
+    }
+    if (value < static_cast<Wide>(kMin)) {
+        return kMin;
+    }
+    return static_cast<Storage>(value);
+}
+
+// Magnitude of a signed double-width value, for the unsigned fast paths.
+template <typename Wide>
+constexpr unsigned __int128 magnitude(Wide value) {
+    return value < 0 ? static_cast<unsigned __int128>(0) - static_cast<unsigned __int128>(value)
+                     : static_cast<unsigned __int128>(value);
+}
+
+} // namespace detail
+
+// Unsigned 64-bit division by an invariant divisor (libdivide's round-up
+// scheme): divide() is one multiply-high, an optional add-and-halve fixup and
+// a shift, instead of a 30-90 cycle div. Construction does the one real
+// division, so it pays off for divisors reused many times; a constexpr
+// instance makes the magic a compile-time constant.
+class Divider64 {
+public:
+    constexpr Divider64() = default;
+
+    explicit constexpr Divider64(std::uint64_t d) : divisor_(d) {
+        if (d == 0) {
+            throw std::overflow_error("FixedPoint divide by zero");
+        }
+        const unsigned floor_log2 = 63u - static_cast<unsigned>(__builtin_clzll(d));
+        shift_ = floor_log2;
+        if ((d & (d - 1)) == 0) {
+            return; // power of two: shift only
+        }
+        const unsigned __int128 num = static_cast<unsigned __int128>(1) << (64 + floor_log2);
+        std::uint64_t m = static_cast<std::uint64_t>(num / d);
+        const std::uint64_t rem = static_cast<std::uint64_t>(num % d);
+        if (d - rem >= (std::uint64_t{1} << floor_log2)) {
+            // 2^(64+floor_log2)/d is not precise enough; use one more bit of
+            // magic, which no longer fits and needs the add fixup.
+            m += m;
+            const std::uint64_t twice_rem = rem + rem;
+            if (twice_rem >= d || twice_rem < rem) {
+                m += 1;
+            }
+            add_ = true;
+        }
+        magic_ = m + 1;
+    }
+
+    constexpr std::uint64_t divisor() const { return divisor_; }
+
+    // The parameters of divide(), for vectorised kernels that replay it per
+    // lane: magic 0 means a plain shift.
+    constexpr std::uint64_t magic() const { return magic_; }
+    constexpr unsigned shift() const { return shift_; }
+    constexpr bool needs_add() const { return add_; }
+
+    constexpr std::uint64_t divide(std::uint64_t n) const {
+        if (magic_ == 0) {
+            return n >> shift_;
+        }
+        const auto q = static_cast<std::uint64_t>((static_cast<unsigned __int128>(magic_) * n) >> 64);
+        if (add_) {
+            return (((n - q) >> 1) + q) >> shift_;
+        }
+        return q >> shift_;
+    }
+
+private:
+    std::uint64_t divisor_ = 1;
+    std::uint64_t magic_ = 0;
+    unsigned shift_ = 0;
+    bool add_ = false;
+};
+
+namespace detail {
+
+// Truncating out = value / divisor (sign of value, flipped when negate), when
+// |value| and the quotient fit in 64 bits. Returns false so callers fall back
+// to a full double-width division; that only happens near the storage limits.
+template <typename Storage, typename Wide>
+constexpr bool divide_fast(Wide value, bool negate, const Divider64& divider, Storage& out) {
+    const unsigned __int128 mag = magnitude(value);
+    if ((mag >> 64) != 0) {
+        return false;
+    }
+    const std::uint64_t q = divider.divide(static_cast<std::uint64_t>(mag));
+    if (q > static_cast<std::uint64_t>(std::numeric_limits<Storage>::max())) {
+        return false;
+    }
+    const auto signed_q = static_cast<Storage>(q);
+    out = (value < 0) != negate ? static_cast<Storage>(-signed_q) : signed_q;
+    return true;
+}
+
+} // namespace detail
+
+// Overflow policies for FixedPoint arithmetic. add/sub get the two operands;
+// narrow gets the exact result of *, / or a scalar multiply in a wider type
+// and brings it to the storage width. Division by zero throws under every
+// policy, and conversions (from_int, from_double, parse, fixed_cast) always
+// saturate. add_wraps tells the batch kernels that a plain vector add is the
+// policy's own result. Wrap, Saturate, Throw and DefaultOverflow are
+// constexpr, so FixedPoint arithmetic on them works in constant expressions
+// (an overflow under Throw, like a division by zero, is then a compile
+// error); CheckedFlag and Counted write per-thread state and are runtime only.
+
+// Two's-complement wrap-around everywhere: the cheapest, for paths where the
+// ranges are known (matching, book updates).
+struct Wrap {
+    static constexpr bool add_wraps = true;
+
+    template <typename Storage>
+    static constexpr Storage add(Storage a, Storage b) {
+        Storage r = 0;
+        __builtin_add_overflow(a, b, &r);
+        return r;
+    }
+
+    template <typename Storage>
+    static constexpr Storage sub(Storage a, Storage b) {
+        Storage r = 0;
+        __builtin_sub_overflow(a, b, &r);
+        return r;
+    }
+
+    template <typename Storage, typename Wide>
+    static constexpr Storage narrow(Wide value) {
+        return static_cast<Storage>(value);
+    }
+};
+
+// Clamp to the storage limits.
+struct Saturate {
+    static constexpr bool add_wraps = false;
+
+    template <typename Storage>
+    static constexpr Storage add(Storage a, Storage b) {
+        Storage r = 0;
+        if (__builtin_add_overflow(a, b, &r)) {
+            return b < 0 ? std::numeric_limits<Storage>::min() : std::numeric_limits<Storage>::max();
+        }
+        return r;
+    }
+
+    template <typename Storage>
+    static constexpr Storage sub(Storage a, Storage b) {
+        Storage r = 0;
+        if (__builtin_sub_overflow(a, b, &r)) {
+            return b < 0 ? std::numeric_limits<Storage>::max() : std::numeric_limits<Storage>::min();
+        }
+        return r;
+    }
+
+    template <typename Storage, typename Wide>
+    static constexpr Storage narrow(Wide value) {
+        return detail::saturate<Storage>(value);
+    }
+};
+
+// Wrap like Wrap, and record any overflow in a sticky per-thread flag that is
+// checked once after a batch:
+//     fixed::CheckedFlag::clear();
+//     ... risk calculation ...
+//     if (fixed::CheckedFlag::overflowed()) { ... }
+struct CheckedFlag {
+    static constexpr bool add_wraps = false;
+
+    static bool overflowed() { return flag(); }
+    static void clear() { flag() = false; }
+
+    template <typename Storage>
+    static Storage add(Storage a, Storage b) {
+        Storage r;
+        flag() |= __builtin_add_overflow(a, b, &r);
+        return r;
+    }
+
+    template <typename Storage>
+    static Storage sub(Storage a, Storage b) {
+        Storage r;
+        flag() |= __builtin_sub_overflow(a, b, &r);
+        return r;
+    }
+
+    template <typename Storage, typename Wide>
+    static Storage narrow(Wide value) {
+        const auto r = static_cast<Storage>(value);
+        flag() |= static_cast<Wide>(r) != value;
+        return r;
+    }
+
+private:
+    static bool& flag() {
+        static thread_local bool value = false;
+        return value;
+    }
+};
+
+// Throw std::overflow_error.
+struct Throw {
+    static constexpr bool add_wraps = false;
+
+    template <typename Storage>
+    static constexpr Storage add(Storage a, Storage b) {
+        Storage r = 0;
+        if (__builtin_add_overflow(a, b, &r)) {
+            throw std::overflow_error("FixedPoint addition overflow");
+        }
+        return r;
+    }
+
+    template <typename Storage>
+    static constexpr Storage sub(Storage a, Storage b) {
+        Storage r = 0;
+        if (__builtin_sub_overflow(a, b, &r)) {
+            throw std::overflow_error("FixedPoint subtraction overflow");
+        }
+        return r;
+    }
+
+    template <typename Storage, typename Wide>
+    static constexpr Storage narrow(Wide value) {
+        const auto r = static_cast<Storage>(value);
+        if (static_cast<Wide>(r) != value) {
+            throw std::overflow_error("FixedPoint result out of range");
+        }
+        return r;
+    }
+};
+
+// What FixedDouble has always done: + and - wrap, everything else saturates.
+struct DefaultOverflow {
+    static constexpr bool add_wraps = true;
+
+    template <typename Storage>
+    static constexpr Storage add(Storage a, Storage b) {
+        return Wrap::add(a, b);
+    }
+
+    template <typename Storage>
+    static constexpr Storage sub(Storage a, Storage b) {
+        return Wrap::sub(a, b);
+    }
+
+    template <typename Storage, typename Wide>
+    static constexpr Storage narrow(Wide value) {
+        return Saturate::narrow<Storage>(value);
+    }
+};
+
+// Per-thread overflow hit counts kept by Counted, on their own cache line.
+struct alignas(64) OverflowCounters {
+    std::uint64_t add = 0;    // + overflowed
+    std::uint64_t sub = 0;    // - overflowed
+    std::uint64_t narrow = 0; // *, / or a scalar multiply result out of range
+
+    std::uint64_t total() const { return add + sub + narrow; }
+};
+
+inline OverflowCounters& overflow_counters() {
+    static thread_local OverflowCounters counters;
+    return counters;
+}
+
+// Base's results (wrapped, saturated, ...), plus a count of every overflow
+// in overflow_counters(), for production builds that want to know how often
+// a limit is hit without changing what happens when it is:
+//     using CountedFixed = FixedPoint<1000, std::int64_t, fixed::Counted<>>;
+//     const std::uint64_t saturations = fixed::overflow_counters().narrow;
+// add_wraps is false even over a wrapping Base so batch adds take the
+// counting scalar path. Conversions saturate outside the policy and are
+// not counted.
+template <typename Base = DefaultOverflow>
+struct Counted {
+    static constexpr bool add_wraps = false;
+
+    template <typename Storage>
+    static Storage add(Storage a, Storage b) {
+        Storage r;
+        if (__builtin_add_overflow(a, b, &r)) {
+            ++overflow_counters().add;
+            return Base::add(a, b);
+        }
+        return r;
+    }
+
+    template <typename Storage>
+    static Storage sub(Storage a, Storage b) {
+        Storage r;
+        if (__builtin_sub_overflow(a, b, &r)) {
+            ++overflow_counters().sub;
+            return Base::sub(a, b);
+        }
+        return r;
+    }
+
+    template <typename Storage, typename Wide>
+    static Storage narrow(Wide value) {
+        if (static_cast<Wide>(static_cast<Storage>(value)) != value) {
+            ++overflow_counters().narrow;
+        }
+        return Base::template narrow<Storage>(value);
+    }
+};
+
+} // namespace fixed
+
+// FixedPoint implements a signed fixed-decimal number: values are stored as
+// Storage scaled by Scale (value * Scale), so Scale = 1000 gives three
+// fractional digits. The scale is a compile-time constant, which lets the
+// compiler turn every division by it (or by a power of ten) into a
+// multiply-shift sequence. Overflow is one of the fixed:: policies above.
+template <std::int64_t Scale, typename Storage = std::int64_t, typename Overflow = fixed::DefaultOverflow>
+class FixedPoint {
+    static_assert(std::is_same<Storage, std::int32_t>::value || std::is_same<Storage, std::int64_t>::value,
+                  "FixedPoint storage must be int32_t or int64_t");
+    static_assert(Scale > 0 && Scale <= std::numeric_limits<Storage>::max(), "scale must fit in the storage type");
+
+public:
+    using storage_type = Storage;
+    using overflow_policy = Overflow;
+
+    static constexpr storage_type scale = static_cast<storage_type>(Scale);
+    static constexpr double inv_scale = 1.0 / static_cast<double>(scale);
+
+    constexpr FixedPoint() = default;
+
+    static constexpr FixedPoint from_raw(storage_type raw) { return FixedPoint(raw); }
+
+    static constexpr FixedPoint from_int(std::int64_t value) {
+        return FixedPoint(saturate(static_cast<__int128>(value) * scale));
+    }
+
+    // Rounds half away from zero (std::llround's rule), written out so it is
+    // constexpr: constexpr FixedDouble kFee = FixedDouble::from_double(0.0002);
+    static constexpr FixedPoint from_double(double value) {
+        if (!(value >= -std::numeric_limits<double>::max() && value <= std::numeric_limits<double>::max())) {
+            throw std::invalid_argument("FixedPoint cannot represent NaN or infinity");
+        }
+        const double scaled = value * static_cast<double>(scale);
+        // The truncating conversion is undefined past the int64 range;
+        // saturate first.
+        if (scaled >= static_cast<double>(kMaxRaw)) {
+            return FixedPoint(kMaxRaw);
+        }
+        if (scaled <= static_cast<double>(kMinRaw)) {
+            return FixedPoint(kMinRaw);
+        }
+        // Exact: below 2^53 the truncation is representable, above it scaled
+        // is already an integer.
+        const auto truncated = static_cast<std::int64_t>(scaled);
+        const double frac = scaled - static_cast<double>(truncated);
+        wide_type rounded = truncated;
+        if (frac >= 0.5) {
+            ++rounded;
+        } else if (frac <= -0.5) {
+            --rounded;
+        }
+        return FixedPoint(saturate(rounded));
+    }
+
+    // Decimal text straight to raw units, without a trip through double:
+    // "101.25", "-0.5", ".5", "3." are accepted; digits past the scale round
+    // half away from zero like from_double, out-of-range values saturate.
+    // Throws std::invalid_argument unless the whole of text is a number. See
+    // fixed::from_chars for a non-throwing, std::from_chars-style variant.
+    // constexpr: a constant argument parses at compile time, through the
+    // scalar loop.
+    static constexpr FixedPoint parse(std::string_view text) {
+        const char* const last = text.data() + text.size();
+        const auto d = fixed::detail::parse_decimal<kFracDigits>(text.data(), last);
+        if (!d.valid || d.ptr != last) {
+            throw std::invalid_argument("FixedPoint::parse: not a decimal number");
+        }
+        return from_parsed(d);
+    }
+
+    constexpr double to_double() const { return static_cast<double>(raw_) * inv_scale; }
+    constexpr std::int64_t to_int64() const { return raw_ / scale; }
+    constexpr storage_type raw_value() const { return raw_; }
+
+    // Arithmetic: constexpr under the constexpr overflow policies.
+    constexpr FixedPoint operator-() const { return from_raw(Overflow::sub(storage_type{0}, raw_)); }
+
+    constexpr FixedPoint& operator+=(FixedPoint other) {
+        raw_ = Overflow::add(raw_, other.raw_);
+        return *this;
+    }
+
+    constexpr FixedPoint& operator-=(FixedPoint other) {
+        raw_ = Overflow::sub(raw_, other.raw_);
+        return *this;
+    }
+
+    constexpr FixedPoint& operator*=(FixedPoint other) {
+        raw_ = scaled_mul(raw_, other.raw_);
+        return *this;
+    }
+
+    constexpr FixedPoint& operator/=(FixedPoint other) {
+        raw_ = scaled_div(raw_, other.raw_);
+        return *this;
+    }
+
+    friend constexpr FixedPoint operator+(FixedPoint lhs, FixedPoint rhs) {
+        lhs += rhs;
+        return lhs;
+    }
+
+    friend constexpr FixedPoint operator-(FixedPoint lhs, FixedPoint rhs) {
+        lhs -= rhs;
+        return lhs;
+    }
+
+    constexpr FixedPoint operator/(int k) const {
+        if (k == 0) {
+            throw std::overflow_error("FixedPoint divide by zero");
+        }
+        if (k == -1) {
+            return from_raw(narrow(-static_cast<wide_type>(raw_))); // the only quotient that can overflow
+        }
+        return from_raw(static_cast<storage_type>(raw_ / k));
+    }
+
+    constexpr FixedPoint operator*(std::int64_t k) const {
+        const wide_type prod = static_cast<wide_type>(raw_) * static_cast<wide_type>(k);
+        return from_raw(narrow(prod));
+    }
+
+    // Multiplication/division by 10^N with N fixed at compile time; the divisor
+    // is a constant of the storage width, so no runtime divide is emitted.
+    template <unsigned N>
+    constexpr FixedPoint mul_pow10() const {
+        static_assert(fixed::pow10(N) <= std::numeric_limits<storage_type>::max(), "10^N must fit in the storage type");
+        return from_raw(narrow(static_cast<wide_type>(raw_) * static_cast<wide_type>(fixed::pow10(N))));
+    }
+
+    template <unsigned N>
+    constexpr FixedPoint div_pow10() const {
+        static_assert(fixed::pow10(N) <= std::numeric_limits<storage_type>::max(), "10^N must fit in the storage type");
+        return from_raw(static_cast<storage_type>(raw_ / static_cast<storage_type>(fixed::pow10(N))));
+    }
+
+    friend constexpr FixedPoint operator*(FixedPoint lhs, FixedPoint rhs) {
+        lhs *= rhs;
+        return lhs;
+    }
+
+    friend constexpr FixedPoint operator/(FixedPoint lhs, FixedPoint rhs) {
+        lhs /= rhs;
+        return lhs;
+    }
+
+    // Comparisons use the signed interpretation of the raw bits.
+    friend constexpr bool operator==(FixedPoint lhs, FixedPoint rhs) { return lhs.raw_ == rhs.raw_; }
+    friend constexpr bool operator!=(FixedPoint lhs, FixedPoint rhs) { return !(lhs == rhs); }
+    friend constexpr bool operator<(FixedPoint lhs, FixedPoint rhs) { return lhs.raw_ < rhs.raw_; }
+    friend constexpr bool operator<=(FixedPoint lhs, FixedPoint rhs) { return lhs.raw_ <= rhs.raw_; }
+    friend constexpr bool operator>(FixedPoint lhs, FixedPoint rhs) { return rhs < lhs; }
+    friend constexpr bool operator>=(FixedPoint lhs, FixedPoint rhs) { return rhs <= lhs; }
+
+    // Convenience values and limits.
+    static constexpr FixedPoint zero() { return FixedPoint(); }
+    static constexpr FixedPoint one() { return from_int(1); }
+    static constexpr double max_value() { return static_cast<double>(kMaxRaw) * inv_scale; }
+    static constexpr double min_value() { return static_cast<double>(kMinRaw) * inv_scale; }
+
+    // Number of fractional decimal digits; text conversion needs Scale = 10^n.
+    static constexpr int decimal_digits = fixed::detail::pow10_exponent(Scale);
+
+private:
+    using wide_type = typename fixed::detail::wide<storage_type>::type;
+
+    static constexpr storage_type kMaxRaw = std::numeric_limits<storage_type>::max();
+    static constexpr storage_type kMinRaw = std::numeric_limits<storage_type>::min();
+    static constexpr unsigned kFracDigits = decimal_digits < 0 ? 0u : static_cast<unsigned>(decimal_digits);
+
+    explicit constexpr FixedPoint(storage_type raw) : raw_(raw) {}
+
+    static constexpr FixedPoint from_parsed(const fixed::detail::DecimalParse& d) {
+        static_assert(decimal_digits >= 0, "text conversion needs a power-of-ten scale");
+        if (d.overflow) {
+            return FixedPoint(d.negative ? kMinRaw : kMaxRaw);
+        }
+        const wide_type mag = static_cast<wide_type>(d.magnitude);
+        return FixedPoint(saturate(d.negative ? -mag : mag));
+    }
+
+    // Conversions saturate; arithmetic results go through the policy.
+    template <typename Wide>
+    static constexpr storage_type saturate(Wide value) {
+        return fixed::detail::saturate<storage_type>(value);
+    }
+
+    template <typename Wide>
+    static constexpr storage_type narrow(Wide value) {
+        return Overflow::template narrow<storage_type>(value);
+    }
+
+    static constexpr storage_type scaled_mul(storage_type a, storage_type b) {
+        const wide_type prod = static_cast<wide_type>(a) * static_cast<wide_type>(b);
+        if constexpr (std::is_same<wide_type, __int128>::value) {
+            // GCC/Clang emit a __divti3 call for any 128-bit division, even by
+            // a constant; a product below 2^64 (every realistic price x qty)
+            // is divided by a compile-time magic multiply instead.
+            constexpr fixed::Divider64 kScaleDivider(static_cast<std::uint64_t>(scale));
+            storage_type q = 0;
+            if (fixed::detail::divide_fast(prod, false, kScaleDivider, q)) {
+                return q;
+            }
+        }
+        return narrow(prod / static_cast<wide_type>(scale));
+    }
+
+    static constexpr storage_type scaled_div(storage_type num, storage_type den) {
+        if (den == 0) {
+            throw std::overflow_error("FixedPoint divide by zero");
+        }
+        const wide_type numerator = static_cast<wide_type>(num) * static_cast<wide_type>(scale);
+        if constexpr (std::is_same<wide_type, __int128>::value) {
+            // A 64-bit hardware divide is several times cheaper than __divti3.
+            const unsigned __int128 mag = fixed::detail::magnitude(numerator);
+            const auto den_mag = static_cast<std::uint64_t>(fixed::detail::magnitude(static_cast<wide_type>(den)));
+            if ((mag >> 64) == 0) {
+                const std::uint64_t q = static_cast<std::uint64_t>(mag) / den_mag;
+                if (q <= static_cast<std::uint64_t>(kMaxRaw)) {
+                    const auto signed_q = static_cast<storage_type>(q);
+                    return (numerator < 0) != (den < 0) ? -signed_q : signed_q;
+                }
+            }
+        }
+        return narrow(numerator / static_cast<wide_type>(den));
+    }
+
+    storage_type raw_{0};
+};
+
+// Precomputed reciprocal of a runtime FixedPoint denominator (a contract
+// multiplier, a lot size) that is divided by many times:
+//     const FixedDivisor<FixedDouble> per_lot(lot_size);
+//     lots = qty / per_lot;
+// Same truncation and overflow handling as operator/, without a hardware divide
+// whenever |num * scale| fits in 64 bits.
+template <typename Fixed>
+class FixedDivisor {
+public:
+    using storage_type = typename Fixed::storage_type;
+
+    explicit constexpr FixedDivisor(Fixed den)
+        : den_(den),
+          negative_(den.raw_value() < 0),
+          divider_(static_cast<std::uint64_t>(fixed::detail::magnitude(den.raw_value()))) {}
+
+    constexpr Fixed divisor() const { return den_; }
+
+    constexpr Fixed divide(Fixed num) const {
+        using wide_type = typename fixed::detail::wide<storage_type>::type;
+        const wide_type numerator = static_cast<wide_type>(num.raw_value()) * static_cast<wide_type>(Fixed::scale);
+        storage_type q = 0;
+        if (fixed::detail::divide_fast(numerator, negative_, divider_, q)) {
+            return Fixed::from_raw(q);
+        }
+        return Fixed::from_raw(Fixed::overflow_policy::template narrow<storage_type>(
+            numerator / static_cast<wide_type>(den_.raw_value())));
+    }
+
+    friend constexpr Fixed operator/(Fixed num, const FixedDivisor& d) { return d.divide(num); }
+
+private:
+    Fixed den_;
+    bool negative_;
+    fixed::Divider64 divider_;
+};
+
+// Exact sum of products (notional, VWAP numerator) that rescales once at the
+// end instead of after every multiply:
+//     FixedAccumulator<FixedDouble> notional;
+//     FixedDouble volume = FixedDouble::zero();
+//     for (const auto& t : trades) { notional.add_product(t.price, t.qty); volume += t.qty; }
+//     const FixedDouble vwap = notional.divided_by(volume);
+// The running sum is the raw products in __int128 (scale^2 units): one 64x64
+// multiply and a 128-bit add per element, and the only rounding is the final
+// truncation toward zero. Each FixedDouble product with |raw| < 2^53 is below
+// 2^106, so 2^21 of them cannot overflow the sum; that is not checked. The
+// final narrowing follows the type's overflow policy.
+template <typename Fixed>
+class FixedAccumulator {
+public:
+    using storage_type = typename Fixed::storage_type;
+
+    void add_product(Fixed a, Fixed b) { sum_ += static_cast<__int128>(a.raw_value()) * b.raw_value(); }
+    void add(Fixed value) { sum_ += static_cast<__int128>(value.raw_value()) * Fixed::scale; }
+
+    FixedAccumulator& operator+=(const FixedAccumulator& other) {
+        sum_ += other.sum_;
+        return *this;
+    }
+
+    void reset() { sum_ = 0; }
+
+    // Sum in scale^2 units.
+    __int128 raw_sum() const { return sum_; }
+
+    Fixed result() const { return from_wide(sum_ / Fixed::scale); }
+
+    // sum / den with a single truncation, e.g. notional / volume.
+    Fixed divided_by(Fixed den) const {
+        if (den.raw_value() == 0) {
+            throw std::overflow_error("FixedAccumulator divide by zero");
+        }
+        return from_wide(sum_ / den.raw_value());
+    }
+
+private:
+    static Fixed from_wide(__int128 value) {
+        return Fixed::from_raw(Fixed::overflow_policy::template narrow<storage_type>(value));
+    }
+
+    __int128 sum_ = 0;
+};
+
+// Explicit conversion between scales/storage widths, e.g.
+//     fixed_cast<FixedPoint<100>>(price_1e8)
+// Precision is truncated toward zero when the target scale is coarser;
+// out-of-range values saturate. The ratio is reduced at compile time.
+template <typename To, std::int64_t Scale, typename Storage, typename Overflow>
+constexpr To fixed_cast(FixedPoint<Scale, Storage, Overflow> value) {
+    using target_storage = typename To::storage_type;
+    constexpr std::int64_t g = std::gcd(Scale, static_cast<std::int64_t>(To::scale));
+    constexpr std::int64_t num = static_cast<std::int64_t>(To::scale) / g;
+    constexpr std::int64_t den = Scale / g;
+    __int128 raw = static_cast<__int128>(value.raw_value());
+    if constexpr (num != 1) {
+        raw *= num;
+    }
+    if constexpr (den != 1) {
+        raw /= den;
+    }
+    return To::from_raw(fixed::detail::saturate<target_storage>(raw));
+}
+
+// Mixed-scale multiply with a compile-time result scale, e.g. price x qty ->
+// notional:
+//     multiply<fixed::pow10(4)>(FixedPoint<100>{...}, FixedPoint<fixed::pow10(8)>{...})
+// The exact product has scale S1 * S2; ResultScale must not exceed it, so the
+// only rounding is one truncating division by S1 * S2 / ResultScale. The
+// result keeps the operands' overflow policy.
+template <std::int64_t ResultScale, std::int64_t S1, std::int64_t S2, typename Storage, typename Overflow>
+constexpr FixedPoint<ResultScale, Storage, Overflow> multiply(FixedPoint<S1, Storage, Overflow> a,
+                                                    FixedPoint<S2, Storage, Overflow> b) {
+    using Result = FixedPoint<ResultScale, Storage, Overflow>;
+    constexpr __int128 exact_scale = static_cast<__int128>(S1) * S2;
+    static_assert(exact_scale % ResultScale == 0, "result scale must divide the product scale S1 * S2");
+    constexpr __int128 divisor = exact_scale / ResultScale;
+    using wide_type = typename fixed::detail::wide<Storage>::type;
+    const wide_type prod = static_cast<wide_type>(a.raw_value()) * static_cast<wide_type>(b.raw_value());
+    if constexpr (divisor == 1) {
+        return Result::from_raw(Overflow::template narrow<Storage>(prod));
+    } else {
+        static_assert(divisor <= std::numeric_limits<std::uint64_t>::max(), "rescale divisor must fit in 64 bits");
+        constexpr fixed::Divider64 kRescale(static_cast<std::uint64_t>(divisor));
+        Storage q = 0;
+        if (fixed::detail::divide_fast(prod, false, kRescale, q)) {
+            return Result::from_raw(q);
+        }
+        return Result::from_raw(Overflow::template narrow<Storage>(static_cast<__int128>(prod) / divisor));
+    }
+}
+
+namespace fixed {
+
+// std::from_chars/std::to_chars counterparts for decimal FixedPoint values.
+// from_chars follows the std contract: errc::invalid_argument when no number
+// starts at first, errc::result_out_of_range when it does not fit; value is
+// only written on success. to_chars always prints every fractional digit
+// ("101.250" for FixedDouble) and returns errc::value_too_large with ptr ==
+// last when the buffer is too small.
+template <std::int64_t Scale, typename Storage, typename Overflow>
+std::from_chars_result from_chars(const char* first, const char* last, FixedPoint<Scale, Storage, Overflow>& value) {
+    constexpr int kDigits = FixedPoint<Scale, Storage, Overflow>::decimal_digits;
+    static_assert(kDigits >= 0, "text conversion needs a power-of-ten scale");
+    const auto d = detail::parse_decimal<static_cast<unsigned>(kDigits)>(first, last);
+    if (!d.valid) {
+        return {first, std::errc::invalid_argument};
+    }
+    // |min| is one more than max.
+    const std::uint64_t limit = static_cast<std::uint64_t>(std::numeric_limits<Storage>::max()) + (d.negative ? 1 : 0);
+    if (d.overflow || d.magnitude > limit) {
+        return {d.ptr, std::errc::result_out_of_range};
+    }
+    const auto mag = static_cast<__int128>(d.magnitude);
+    value = FixedPoint<Scale, Storage, Overflow>::from_raw(static_cast<Storage>(d.negative ? -mag : mag));
+    return {d.ptr, std::errc()};
+}
+
+// Exact FixedPoint value of the characters of a numeric literal, for
+// user-defined literals (FixedDouble's _fx in fixed_double.hpp). Digit
+// separators are skipped and zeros past the scale are fine; anything other
+// than digits and one '.', a nonzero digit past the scale or a value out of
+// range throws instead of rounding or saturating, which in a constant
+// expression fails the build.
+template <typename Fixed, char... Chars>
+FIXED_CONSTEVAL Fixed literal() {
+    using Storage = typename Fixed::storage_type;
+    constexpr int kDigits = Fixed::decimal_digits;
+    static_assert(kDigits >= 0, "literals need a power-of-ten scale");
+    constexpr char text[] = {Chars...};
+    std::uint64_t mag = 0;
+    int frac_digits = -1; // -1 until the '.'
+    bool any_digits = false;
+    for (const char c : text) {
+        if (c == '\'') {
+            continue;
+        }
+        if (c == '.' && frac_digits < 0) {
+            frac_digits = 0;
+            continue;
+        }
+        if (!detail::is_digit(c)) {
+            throw std::invalid_argument("FixedPoint literal: decimal digits and one '.' only");
+        }
+        any_digits = true;
+        if (frac_digits >= kDigits) {
+            if (c != '0') {
+                throw std::invalid_argument("FixedPoint literal: more fractional digits than the scale");
+            }
+            continue;
+        }
+        frac_digits += frac_digits >= 0 ? 1 : 0;
+        if (__builtin_mul_overflow(mag, std::uint64_t{10}, &mag) ||
+            __builtin_add_overflow(mag, static_cast<std::uint64_t>(c - '0'), &mag)) {
+            throw std::out_of_range("FixedPoint literal out of range");
+        }
+    }
+    if (!any_digits) {
+        throw std::invalid_argument("FixedPoint literal: no digits");
+    }
+    for (int d = frac_digits < 0 ? 0 : frac_digits; d < kDigits; ++d) {
+        if (__builtin_mul_overflow(mag, std::uint64_t{10}, &mag)) {
+            throw std::out_of_range("FixedPoint literal out of range");
+        }
+    }
+    if (mag > static_cast<std::uint64_t>(std::numeric_limits<Storage>::max())) {
+        throw std::out_of_range("FixedPoint literal out of range");
+    }
+    return Fixed::from_raw(static_cast<Storage>(mag));
+}
+
+template <std::int64_t Scale, typename Storage, typename Overflow>
+std::to_chars_result to_chars(char* first, char* last, FixedPoint<Scale, Storage, Overflow> value) {
+    using Fixed = FixedPoint<Scale, Storage, Overflow>;
+    static_assert(Fixed::decimal_digits >= 0, "text conversion needs a power-of-ten scale");
+    constexpr auto kDigits = static_cast<unsigned>(Fixed::decimal_digits);
+    const Storage raw = value.raw_value();
+    const auto mag = static_cast<std::uint64_t>(detail::magnitude(static_cast<__int128>(raw)));
+    char* const end = detail::format_decimal<kDigits>(first, last, raw < 0, mag);
+    if (end == nullptr) {
+        return {last, std::errc::value_too_large};
+    }
+    return {end, std::errc()};
+}
+
+} // namespace fixed
+
+template <std::int64_t Scale, typename Storage, typename Overflow>
+inline std::ostream& operator<<(std::ostream& os, const FixedPoint<Scale, Storage, Overflow>& v) {
+    return os << v.to_double();
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+#include "fixed_point.hpp"
+
+namespace fixed {
+
+namespace detail {
+
+// Signed storage filling exactly Bits bits.
+template <unsigned Bits>
+using q_storage = std::conditional_t<Bits == 32, std::int32_t, std::int64_t>;
+
+// q = (hi:lo) / d for a 128-bit dividend whose quotient fits in 64 bits
+// (hi < d). On x86-64 this is one divq instead of a __udivti3 call.
+inline std::uint64_t udiv128by64(std::uint64_t hi, std::uint64_t lo, std::uint64_t d) {
+#if defined(__x86_64__)
+    std::uint64_t q;
+    std::uint64_t r;
+    __asm__("divq %[d]" : "=a"(q), "=d"(r) : [d] "r"(d), "a"(lo), "d"(hi));
+    (void)r;
+    return q;
+#else
+    return static_cast<std::uint64_t>(((static_cast<unsigned __int128>(hi) << 64) | lo) / d);
+#endif
+}
+
+} // namespace detail
+
+} // namespace fixed
+
+// FixedQ implements a signed binary fixed-point number in Q(IntBits).(FracBits)
+// format: values are stored as an integer scaled by 2^FracBits, so rescaling
+// after a multiply is a shift instead of a division. Binary fractions cannot
+// represent most decimals exactly, so this is meant for internal analytics
+// (EMAs, signals, fair value) rather than prices on the wire; convert at the
+// boundary with from_fixed()/to_fixed(), which round-trip a FixedPoint value
+// exactly whenever 2^FracBits > Scale.
+//
+// Same interface and overflow behaviour as FixedDouble: + and - wrap, * and /
+// saturate. Multiplication truncates toward negative infinity (arithmetic
+// shift), division toward zero.
+template <unsigned IntBits, unsigned FracBits>
+class FixedQ {
+    static_assert(IntBits + FracBits == 32 || IntBits + FracBits == 64,
+                  "FixedQ must fill exactly an int32_t or int64_t");
+    static_assert(IntBits >= 2 && FracBits > 0, "FixedQ needs a sign bit, an integer bit and fractional bits");
+
+public:
+    using storage_type = fixed::detail::q_storage<IntBits + FracBits>;
+
+    static constexpr unsigned frac_bits = FracBits;
+    static constexpr storage_type scale = static_cast<storage_type>(std::uint64_t{1} << FracBits);
+    static constexpr double inv_scale = 1.0 / static_cast<double>(std::uint64_t{1} << FracBits);
+
+    constexpr FixedQ() = default;
+
+    static constexpr FixedQ from_raw(storage_type raw) { return FixedQ(raw); }
+
+    static constexpr FixedQ from_int(std::int64_t value) {
+        return FixedQ(saturate(static_cast<__int128>(value) * (static_cast<__int128>(1) << FracBits)));
+    }
+
+    static FixedQ from_double(double value) {
+        if (!std::isfinite(value)) {
+            throw std::invalid_argument("FixedQ cannot represent NaN or infinity");
+        }
+        const double scaled = std::ldexp(value, FracBits);
+        if (scaled >= static_cast<double>(kMaxRaw)) {
+            return FixedQ(kMaxRaw);
+        }
+        if (scaled <= static_cast<double>(kMinRaw)) {
+            return FixedQ(kMinRaw);
+        }
+        return FixedQ(saturate(static_cast<wide_type>(std::llround(scaled))));
+    }
+
+    // Nearest binary value to a decimal FixedPoint (ties away from zero).
+    template <std::int64_t Scale, typename Storage, typename Overflow>
+    static FixedQ from_fixed(FixedPoint<Scale, Storage, Overflow> value) {
+        const __int128 num = static_cast<__int128>(value.raw_value()) * (static_cast<__int128>(1) << FracBits);
+        return FixedQ(saturate(round_div(num, Scale)));
+    }
+
+    // Nearest decimal FixedPoint value (ties away from zero).
+    template <typename Fixed>
+    Fixed to_fixed() const {
+        const __int128 num = static_cast<__int128>(raw_) * static_cast<__int128>(Fixed::scale);
+        return Fixed::from_raw(
+            fixed::detail::saturate<typename Fixed::storage_type>(round_div(num, __int128{1} << FracBits)));
+    }
+
+    double to_double() const { return static_cast<double>(raw_) * inv_scale; }
+    std::int64_t to_int64() const { return raw_ / scale; }
+    storage_type raw_value() const { return raw_; }
+
+    // Arithmetic
+    FixedQ& operator+=(FixedQ other) {
+        raw_ = static_cast<storage_type>(raw_ + other.raw_);
+        return *this;
+    }
+
+    FixedQ& operator-=(FixedQ other) {
+        raw_ = static_cast<storage_type>(raw_ - other.raw_);
+        return *this;
+    }
+
+    FixedQ& operator*=(FixedQ other) {
+        raw_ = saturating_mul(raw_, other.raw_);
+        return *this;
+    }
+
+    FixedQ& operator/=(FixedQ other) {
+        raw_ = saturating_div(raw_, other.raw_);
+        return *this;
+    }
+
+    friend FixedQ operator+(FixedQ lhs, FixedQ rhs) {
+        lhs += rhs;
+        return lhs;
+    }
+
+    friend FixedQ operator-(FixedQ lhs, FixedQ rhs) {
+        lhs -= rhs;
+        return lhs;
+    }
+
+    FixedQ operator/(int k) const {
+        if (k == 0) {
+            throw std::overflow_error("FixedQ divide by zero");
+        }
+        return from_raw(static_cast<storage_type>(raw_ / k));
+    }
+
+    FixedQ operator*(std::int64_t k) const {
+        const wide_type prod = static_cast<wide_type>(raw_) * static_cast<wide_type>(k);
+        return from_raw(saturate(prod));
+    }
+
+    friend FixedQ operator*(FixedQ lhs, FixedQ rhs) {
+        lhs *= rhs;
+        return lhs;
+    }
+
+    friend FixedQ operator/(FixedQ lhs, FixedQ rhs) {
+        lhs /= rhs;
+        return lhs;
+    }
+
+    friend bool operator==(FixedQ lhs, FixedQ rhs) { return lhs.raw_ == rhs.raw_; }
+    friend bool operator!=(FixedQ lhs, FixedQ rhs) { return !(lhs == rhs); }
+    friend bool operator<(FixedQ lhs, FixedQ rhs) { return lhs.raw_ < rhs.raw_; }
+    friend bool operator<=(FixedQ lhs, FixedQ rhs) { return lhs.raw_ <= rhs.raw_; }
+    friend bool operator>(FixedQ lhs, FixedQ rhs) { return rhs < lhs; }
+    friend bool operator>=(FixedQ lhs, FixedQ rhs) { return rhs <= lhs; }
+
+    // Convenience values and limits.
+    static constexpr FixedQ zero() { return FixedQ(); }
+    static constexpr FixedQ one() { return from_int(1); }
+    static constexpr double max_value() { return static_cast<double>(kMaxRaw) * inv_scale; }
+    static constexpr double min_value() { return static_cast<double>(kMinRaw) * inv_scale; }
+
+private:
+    using wide_type = typename fixed::detail::wide<storage_type>::type;
+
+    static constexpr storage_type kMaxRaw = std::numeric_limits<storage_type>::max();
+    static constexpr storage_type kMinRaw = std::numeric_limits<storage_type>::min();
+
+    explicit constexpr FixedQ(storage_type raw) : raw_(raw) {}
+
+    template <typename Wide>
+    static constexpr storage_type saturate(Wide value) {
+        return fixed::detail::saturate<storage_type>(value);
+    }
+
+    static __int128 round_div(__int128 num, __int128 den) {
+        const __int128 half = den / 2;
+        return (num >= 0 ? num + half : num - half) / den;
+    }
+
+    static storage_type saturating_mul(storage_type a, storage_type b) {
+        const wide_type prod = static_cast<wide_type>(a) * static_cast<wide_type>(b);
+        return saturate(prod >> FracBits);
+    }
+
+    static storage_type saturating_div(storage_type num, storage_type den) {
+        if (den == 0) {
+            throw std::overflow_error("FixedQ divide by zero");
+        }
+        if constexpr (std::is_same<storage_type, std::int64_t>::value) {
+            // |num| << FracBits is up to 127 bits; when the quotient fits in
+            // 64 bits a single 128/64 hardware divide does the job.
+            const std::uint64_t n = static_cast<std::uint64_t>(fixed::detail::magnitude(num));
+            const std::uint64_t d = static_cast<std::uint64_t>(fixed::detail::magnitude(den));
+            const std::uint64_t hi = n >> (64 - FracBits);
+            const std::uint64_t lo = n << FracBits;
+            if (hi < d) {
+                const std::uint64_t q = fixed::detail::udiv128by64(hi, lo, d);
+                if (q <= static_cast<std::uint64_t>(kMaxRaw)) {
+                    const auto signed_q = static_cast<storage_type>(q);
+                    return (num < 0) != (den < 0) ? -signed_q : signed_q;
+                }
+            }
+        }
+        const wide_type numerator = static_cast<wide_type>(num) * (static_cast<wide_type>(1) << FracBits);
+        return saturate(numerator / static_cast<wide_type>(den));
+    }
+
+    storage_type raw_{0};
+};
+
+template <unsigned IntBits, unsigned FracBits>
+inline std::ostream& operator<<(std::ostream& os, const FixedQ<IntBits, FracBits>& v) {
+    return os << v.to_double();
+}
+
+using FixedQ32_32 = FixedQ<32, 32>;
+using FixedQ16_16 = FixedQ<16, 16>;
@@ -1,12 +1,28 @@
+#include "fixed_batch.hpp"
 #include "fixed_double.hpp"
+#include "fixed_q.hpp"
+#include "tick_price.hpp"
+#include "../common/bench_env.hpp"
+#include "../common/bench_harness.hpp"
+#include "../common/page_allocator.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
+#include <charconv>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <cstdint>
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <random>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace {
@@ -27,12 +43,15 @@ struct TickD {
     double qty;
 };
 
-struct TickF {
-    FixedDouble bid;
-    FixedDouble ask;
-    FixedDouble qty;
+template <typename Fixed>
+struct TickFixed {
+    Fixed bid;
+    Fixed ask;
+    Fixed qty;
 };
 
+using TickF = TickFixed<FixedDouble>;
+
 std::vector<TickD> make_ticks(std::size_t n) {
     std::vector<TickD> ticks;
     ticks.reserve(n);
@@ -47,13 +66,12 @@ std::vector<TickD> make_ticks(std::size_t n) {
     return ticks;
 }
 
-std::vector<TickF> to_fixed(const std::vector<TickD>& src) {
-    std::vector<TickF> out;
+template <typename Fixed = FixedDouble>
+std::vector<TickFixed<Fixed>> to_fixed(const std::vector<TickD>& src) {
+    std::vector<TickFixed<Fixed>> out;
     out.reserve(src.size());
     for (const auto& t : src) {
-        out.push_back(TickF{FixedDouble::from_double(t.bid),
-                            FixedDouble::from_double(t.ask),
-                            FixedDouble::from_double(t.qty)});
+        out.push_back(TickFixed<Fixed>{Fixed::from_double(t.bid), Fixed::from_double(t.ask), Fixed::from_double(t.qty)});
     }
     return out;
 }
@@ -64,12 +82,15 @@ struct DatumD {
     double recip;
 };
 
-struct DatumF {
-    FixedDouble num;
-    FixedDouble den;
-    FixedDouble recip;
+template <typename Fixed>
+struct DatumFixed {
+    Fixed num;
+    Fixed den;
+    Fixed recip;
 };
 
+using DatumF = DatumFixed<FixedDouble>;
+
 std::vector<DatumD> make_double_data(std::size_t n) {
     std::vector<DatumD> data;
     data.reserve(n);
@@ -84,13 +105,12 @@ std::vector<DatumD> make_double_data(std::size_t n) {
     return data;
 }
 
-std::vector<DatumF> make_fixed_data(const std::vector<DatumD>& src) {
-    std::vector<DatumF> out;
+template <typename Fixed = FixedDouble>
+std::vector<DatumFixed<Fixed>> make_fixed_data(const std::vector<DatumD>& src) {
+    std::vector<DatumFixed<Fixed>> out;
     out.reserve(src.size());
     for (const auto& d : src) {
-        out.push_back(DatumF{FixedDouble::from_double(d.num),
-                             FixedDouble::from_double(d.den),
-                             FixedDouble::from_double(d.recip)});
+        out.push_back(DatumFixed<Fixed>{Fixed::from_double(d.num), Fixed::from_double(d.den), Fixed::from_double(d.recip)});
     }
     return out;
 }
@@ -99,154 +119,251 @@ struct Result {
     std::string name;
     double ms = 0.0;
     double ns_per_op = 0.0;
+    double worst_ns_per_op = 0.0;
+    std::size_t ops = 0;
+    bench::LatencyHistogram latency;
+    bench::Interference interference;
 };
 
+// Runs per case (--reps). Each case reports its best run and keeps the worst;
+// the latency histogram merges every run.
+std::size_t g_runs = 1;
+
+// Calls run_once(timer) g_runs times; it returns the run's wall time in ms.
+template <typename RunOnce>
+Result best_of_runs(std::string name, std::size_t ops, std::size_t ops_per_sample, RunOnce&& run_once) {
+    Result r{std::move(name), 0.0, 0.0, 0.0, ops, bench::LatencyHistogram(bench::ns_per_tick() /
+                                                                        static_cast<double>(ops_per_sample)), {}};
+    const bench::Interference before = bench::interference_now();
+    for (std::size_t run = 0; run < g_runs; ++run) {
+        bench::OpTimer timer(ops_per_sample);
+        const double ms = run_once(timer);
+        r.latency.merge(timer.histogram());
+        const double ns_per_op = (ms * 1e6) / static_cast<double>(ops);
+        if (run == 0 || ms < r.ms) {
+            r.ms = ms;
+            r.ns_per_op = ns_per_op;
+        }
+        r.worst_ns_per_op = std::max(r.worst_ns_per_op, ns_per_op);
+    }
+    r.interference = bench::interference_now() - before;
+    return r;
+}
+
+// Operations per latency sample. A single op is ~1 ns, far below the cost of
+// a timer read, so the distribution is over per-op averages of 1024-op blocks.
+constexpr std::size_t kSampleBlock = 1024;
+
+// Runs body(i) for i in [0, iters) in blocks of kSampleBlock, timestamping
+// each block; the inner loop is left exactly as the benchmark wrote it.
+template <typename Body>
+Result run_timed(std::string name, std::size_t iters, Body&& body) {
+    return best_of_runs(std::move(name), iters, kSampleBlock, [&](bench::OpTimer& timer) {
+        const auto start = std::chrono::steady_clock::now();
+        timer.start();
+        for (std::size_t i = 0; i < iters;) {
+            const std::size_t block_end = std::min(iters, i + kSampleBlock);
+            const std::size_t n = block_end - i;
+            for (; i < block_end; ++i) {
+                body(i);
+            }
+            timer.lap_batch(n);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    });
+}
+
 template <Operation Op>
 Result bench_double_t(const std::vector<TickD>& ticks, std::size_t iters, std::string name) {
     double acc = 0.0;
-    const auto start = std::chrono::steady_clock::now();
-    for (std::size_t i = 0; i < iters; ++i) {
+    Result r = run_timed(std::move(name), iters, [&](std::size_t i) {
         const auto& t = ticks[i & (ticks.size() - 1)];
         if constexpr (Op == Operation::Add) acc += (t.bid + t.ask);
         if constexpr (Op == Operation::Sub) acc += (t.ask - t.bid);
         if constexpr (Op == Operation::Mul) acc += (t.bid * t.qty);
         if constexpr (Op == Operation::Div) acc += (t.ask / t.qty);
-    }
-    const auto end = std::chrono::steady_clock::now();
+    });
     g_double_sink = acc;
-    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
-    return Result{std::move(name), ms, (ms * 1e6) / static_cast<double>(iters)};
+    return r;
 }
 
-template <Operation Op>
-Result bench_fixed_t(const std::vector<TickF>& ticks, std::size_t iters, std::string name) {
-    FixedDouble acc = FixedDouble::zero();
-    const auto start = std::chrono::steady_clock::now();
-    for (std::size_t i = 0; i < iters; ++i) {
+template <Operation Op, typename Fixed>
+Result bench_fixed_t(const std::vector<TickFixed<Fixed>>& ticks, std::size_t iters, std::string name) {
+    Fixed acc = Fixed::zero();
+    Result r = run_timed(std::move(name), iters, [&](std::size_t i) {
         const auto& t = ticks[i & (ticks.size() - 1)];
         if constexpr (Op == Operation::Add) acc += (t.bid + t.ask);
         if constexpr (Op == Operation::Sub) acc += (t.ask - t.bid);
         if constexpr (Op == Operation::Mul) acc += (t.bid * t.qty);
         if constexpr (Op == Operation::Div) acc += (t.ask / t.qty);
-    }
-    const auto end = std::chrono::steady_clock::now();
+    });
     g_fixed_sink = acc.raw_value();
-    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
-    return Result{std::move(name), ms, (ms * 1e6) / static_cast<double>(iters)};
+    return r;
 }
 
 Result bench_double_div(const std::vector<DatumD>& data, std::size_t iters) {
     double acc = 0.0;
     const std::size_t mask = data.size() - 1;
-    const auto start = std::chrono::steady_clock::now();
-    for (std::size_t i = 0; i < iters; ++i) {
+    Result r = run_timed("double: a/b", iters, [&](std::size_t i) {
         const auto& d = data[i & mask];
         acc += d.num / d.den;
-    }
-    const auto end = std::chrono::steady_clock::now();
+    });
     g_double_sink = acc;
-    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
-    return Result{"double: a/b", ms, (ms * 1e6) / static_cast<double>(iters)};
+    return r;
 }
 
 Result bench_double_mul_recip(const std::vector<DatumD>& data, std::size_t iters) {
     double acc = 0.0;
     const std::size_t mask = data.size() - 1;
-    const auto start = std::chrono::steady_clock::now();
-    for (std::size_t i = 0; i < iters; ++i) {
+    Result r = run_timed("double: a*(1/b)", iters, [&](std::size_t i) {
         const auto& d = data[i & mask];
         acc += d.num * d.recip;
-    }
-    const auto end = std::chrono::steady_clock::now();
+    });
     g_double_sink = acc;
-    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
-    return Result{"double: a*(1/b)", ms, (ms * 1e6) / static_cast<double>(iters)};
+    return r;
 }
 
 Result bench_double_div_const(const std::vector<DatumD>& data, std::size_t iters) {
     double acc = 0.0;
     const std::size_t mask = data.size() - 1;
     constexpr double den = 1000.0;
-    const auto start = std::chrono::steady_clock::now();
-    for (std::size_t i = 0; i < iters; ++i) {
-        acc += data[i & mask].num / den;
-    }
-    const auto end = std::chrono::steady_clock::now();
+    Result r = run_timed("double: a/1000", iters, [&](std::size_t i) { acc += data[i & mask].num / den; });
     g_double_sink = acc;
-    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
-    return Result{"double: a/1000", ms, (ms * 1e6) / static_cast<double>(iters)};
+    return r;
 }
 
 Result bench_double_mul_const_small(const std::vector<DatumD>& data, std::size_t iters) {
     double acc = 0.0;
     const std::size_t mask = data.size() - 1;
     constexpr double factor = 0.001;
-    const auto start = std::chrono::steady_clock::now();
-    for (std::size_t i = 0; i < iters; ++i) {
-        acc += data[i & mask].num * factor;
-    }
-    const auto end = std::chrono::steady_clock::now();
+    Result r = run_timed("double: a*0.001", iters, [&](std::size_t i) { acc += data[i & mask].num * factor; });
     g_double_sink = acc;
-    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
-    return Result{"double: a*0.001", ms, (ms * 1e6) / static_cast<double>(iters)};
+    return r;
 }
 
-Result bench_fixed_div(const std::vector<DatumF>& data, std::size_t iters) {
-    FixedDouble acc = FixedDouble::zero();
+template <typename Fixed>
+Result bench_fixed_div(const std::vector<DatumFixed<Fixed>>& data, std::size_t iters, const std::string& type_name) {
+    Fixed acc = Fixed::zero();
     const std::size_t mask = data.size() - 1;
-    const auto start = std::chrono::steady_clock::now();
-    for (std::size_t i = 0; i < iters; ++i) {
+    Result r = run_timed(type_name + ": a/b", iters, [&](std::size_t i) {
         const auto& d = data[i & mask];
         acc += d.num / d.den;
-    }
-    const auto end = std::chrono::steady_clock::now();
+    });
     g_fixed_sink = acc.raw_value();
-    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
-    return Result{"FixedDouble: a/b", ms, (ms * 1e6) / static_cast<double>(iters)};
+    return r;
 }
 
-Result bench_fixed_mul_recip(const std::vector<DatumF>& data, std::size_t iters) {
-    FixedDouble acc = FixedDouble::zero();
+template <typename Fixed>
+Result bench_fixed_mul_recip(const std::vector<DatumFixed<Fixed>>& data, std::size_t iters, const std::string& type_name) {
+    Fixed acc = Fixed::zero();
     const std::size_t mask = data.size() - 1;
-    const auto start = std::chrono::steady_clock::now();
-    for (std::size_t i = 0; i < iters; ++i) {
+    Result r = run_timed(type_name + ": a*(1/b)", iters, [&](std::size_t i) {
         const auto& d = data[i & mask];
         acc += d.num * d.recip;
-    }
-    const auto end = std::chrono::steady_clock::now();
+    });
+    g_fixed_sink = acc.raw_value();
+    return r;
+}
+
+template <typename Fixed>
+Result bench_fixed_div_const(const std::vector<DatumFixed<Fixed>>& data, std::size_t iters, const std::string& type_name) {
+    Fixed acc = Fixed::zero();
+    const std::size_t mask = data.size() - 1;
+    Result r = run_timed(type_name + ": a/1000", iters, [&](std::size_t i) { acc += data[i & mask].num / 1000; });
+    g_fixed_sink = acc.raw_value();
+    return r;
+}
+
+// One runtime denominator (a lot size) reused for every division, plain
+// operator/ vs a precomputed FixedDivisor.
+Result bench_fixed_div_lot(const std::vector<DatumF>& data, std::size_t iters, FixedDouble lot) {
+    FixedDouble acc = FixedDouble::zero();
+    const std::size_t mask = data.size() - 1;
+    Result r = run_timed("FixedDouble: a/lot", iters, [&](std::size_t i) { acc += data[i & mask].num / lot; });
+    g_fixed_sink = acc.raw_value();
+    return r;
+}
+
+Result bench_fixed_divisor_lot(const std::vector<DatumF>& data, std::size_t iters, FixedDouble lot) {
+    FixedDouble acc = FixedDouble::zero();
+    const std::size_t mask = data.size() - 1;
+    const FixedDivisor<FixedDouble> per_lot(lot);
+    Result r = run_timed("FixedDouble: a/FixedDivisor(lot)", iters, [&](std::size_t i) { acc += data[i & mask].num / per_lot; });
     g_fixed_sink = acc.raw_value();
-    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
-    return Result{"FixedDouble: a*(1/b)", ms, (ms * 1e6) / static_cast<double>(iters)};
+    return r;
 }
 
-Result bench_fixed_div_const(const std::vector<DatumF>& data, std::size_t iters) {
+Result bench_fixed_div_pow10(const std::vector<DatumF>& data, std::size_t iters) {
     FixedDouble acc = FixedDouble::zero();
     const std::size_t mask = data.size() - 1;
-    const auto start = std::chrono::steady_clock::now();
-    for (std::size_t i = 0; i < iters; ++i) {
-        acc += data[i & mask].num / 1000;
+    Result r = run_timed("FixedDouble: a.div_pow10<3>()", iters,
+                         [&](std::size_t i) { acc += data[i & mask].num.div_pow10<3>(); });
+    g_fixed_sink = acc.raw_value();
+    return r;
+}
+
+// price (2 decimals) x qty (8 decimals) -> notional (4 decimals).
+Result bench_fixed_notional(const std::vector<DatumF>& data, std::size_t iters) {
+    std::vector<FixedPoint<100>> prices;
+    std::vector<FixedPoint<fixed::pow10(8)>> qtys;
+    for (const auto& d : data) {
+        prices.push_back(fixed_cast<FixedPoint<100>>(d.num));
+        qtys.push_back(fixed_cast<FixedPoint<fixed::pow10(8)>>(d.den));
     }
-    const auto end = std::chrono::steady_clock::now();
+    FixedPoint<fixed::pow10(4)> acc = FixedPoint<fixed::pow10(4)>::zero();
+    const std::size_t mask = data.size() - 1;
+    Result r = run_timed("FixedPoint: multiply<1e4>(1e2, 1e8)", iters,
+                         [&](std::size_t i) { acc += multiply<fixed::pow10(4)>(prices[i & mask], qtys[i & mask]); });
     g_fixed_sink = acc.raw_value();
-    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
-    return Result{"FixedDouble: a/1000", ms, (ms * 1e6) / static_cast<double>(iters)};
+    return r;
 }
 
 Result bench_fixed_mul_const_small(const std::vector<DatumF>& data, std::size_t iters) {
     FixedDouble acc = FixedDouble::zero();
     const std::size_t mask = data.size() - 1;
-    constexpr int64_t k = static_cast<std::int64_t>(std::llround(std::ldexp(0.001, 32 /*fractional_bits*/)));
-    const auto start = std::chrono::steady_clock::now();
-    for (std::size_t i = 0; i < iters; ++i) {
-        acc += data[i & mask].num * k;
-    }
-    const auto end = std::chrono::steady_clock::now();
+    using namespace fixed::literals;
+    constexpr FixedDouble k = 0.001_fx;
+    Result r = run_timed("FixedDouble: a*0.001", iters, [&](std::size_t i) { acc += data[i & mask].num * k; });
     g_fixed_sink = acc.raw_value();
-    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
-    return Result{"FixedDouble: a*0.001", ms, (ms * 1e6) / static_cast<double>(iters)};
+    return r;
+}
+
+// Times reps calls of body(), each over a batch of elements; ns/op and the
+// latency samples are per element (one sample per call).
+template <typename Body>
+Result run_batched(std::string name, std::size_t reps, std::size_t batch, Body&& body) {
+    return best_of_runs(std::move(name), reps * batch, batch, [&](bench::OpTimer& timer) {
+        const auto start = std::chrono::steady_clock::now();
+        timer.start();
+        for (std::size_t r = 0; r < reps; ++r) {
+            body();
+            timer.lap_batch(batch);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    });
 }
 
-void run_fixed_double_tests() {
+// Prints a group's results and adds them to the json/csv report; size is the
+// group's working-set parameter (the --sizes value it ran with).
+void print_results(bench::Reporter& report, const char* scenario, std::size_t size,
+                   const std::vector<Result>& results) {
+    std::ostream& out = report.text();
+    for (const auto& r : results) {
+        out << "  " << r.name << ": " << r.ms << " ms, " << r.ns_per_op << " ns/op\n"
+            << "    latency: " << r.latency.summary() << "\n";
+        if (r.interference.ctx_switches != 0 || r.interference.page_faults != 0) {
+            out << "    interrupted: " << r.interference.ctx_switches << " ctx switches, "
+                << r.interference.page_faults << " page faults\n";
+        }
+        report.add(bench::Record{scenario, r.name, size, r.ops, g_runs, r.ns_per_op, r.worst_ns_per_op,
+                                 r.latency.summary(), r.interference.ctx_switches,
+                                 r.interference.page_faults});
+    }
+}
+
+void run_fixed_double_tests(std::ostream& os) {
     const auto a = FixedDouble::from_double(1.5);
     const auto b = FixedDouble::from_int(2);
 
@@ -272,15 +389,228 @@ void run_fixed_double_tests() {
     const auto huge = FixedDouble::from_double(1e16);
     assert(approx(huge.to_double(), FixedDouble::max_value(), 1.0));
 
-    std::cout << "All FixedDouble checks passed\n";
+    // Scale-generic FixedPoint: compile-time powers of ten, cross-scale casts
+    // and mixed-scale multiply.
+    using Price2 = FixedPoint<100>;
+    using Qty8 = FixedPoint<fixed::pow10(8)>;
+    using Notional4 = FixedPoint<fixed::pow10(4)>;
+
+    assert(d.div_pow10<3>() == d / 1000);
+    assert(d.mul_pow10<2>().raw_value() == d.raw_value() * 100);
+
+    const auto qty = Qty8::from_double(0.12345678);
+    assert(fixed_cast<FixedDouble>(qty).raw_value() == 123);                   // truncated
+    assert(fixed_cast<Qty8>(fixed_cast<FixedDouble>(qty)).raw_value() == 12'300'000);
+    using Narrow = FixedPoint<1000, std::int32_t>;
+    assert(fixed_cast<Narrow>(huge).raw_value() == std::numeric_limits<std::int32_t>::max());
+
+    const auto px = Price2::from_double(101.25);
+    const auto notional = multiply<fixed::pow10(4)>(px, Qty8::from_double(2.5));
+    static_assert(std::is_same<decltype(notional), const Notional4>::value, "result scale is compile-time");
+    assert(notional.raw_value() == 2'531'250);                                 // 253.125
+    assert(multiply<100 * fixed::pow10(8)>(px, qty).raw_value() == px.raw_value() * qty.raw_value());
+
+    // Binary Q formats: shift-based rescaling and exact decimal round trips.
+    const auto q = FixedQ32_32::from_double(1.5) * FixedQ32_32::from_int(2);
+    assert(q == FixedQ32_32::from_int(3));
+    assert(approx((FixedQ32_32::from_int(1) / FixedQ32_32::from_int(3)).to_double(), 1.0 / 3.0, 1e-9));
+    assert((FixedQ16_16::from_double(-2.25) / FixedQ16_16::from_double(1.5)).to_double() == -1.5);
+    assert(FixedQ32_32::from_double(1e12).to_double() == FixedQ32_32::max_value());
+    for (std::int64_t raw : {0LL, 1LL, -1LL, 999LL, 123'456'789LL, -987'654'321LL, 2'147'483'000'000LL}) {
+        const auto v = FixedDouble::from_raw(raw);
+        assert(FixedQ32_32::from_fixed(v).to_fixed<FixedDouble>() == v);
+    }
+
+    // Tick/lot grids: integer units with exact conversion to FixedDouble.
+    const ticks::Grid<ticks::TickPrice> tick(FixedDouble::from_double(0.05));
+    const ticks::StaticGrid<ticks::LotQty, 100> lot; // 0.1
+    const ticks::TickPrice p = tick.to_units(FixedDouble::from_double(101.25));
+    assert(p.count() == 2025 && tick.to_fixed(p) == FixedDouble::from_double(101.25));
+    assert(tick.to_units(FixedDouble::from_double(-0.12)).count() == -2);
+    assert(!tick.on_grid(FixedDouble::from_double(0.12)) && lot.on_grid(FixedDouble::from_double(2.5)));
+    assert(ticks::notional(p, ticks::LotQty(25), tick, lot) == FixedDouble::from_double(253.125));
+
+    // Decimal text: no double round-trip, rounding past the third decimal.
+    assert(FixedDouble::parse("101.25") == FixedDouble::from_double(101.25));
+    assert(FixedDouble::parse("-1.0005").raw_value() == -1001 && FixedDouble::parse("1.00049999").raw_value() == 1000);
+    assert(FixedDouble::parse("0.9995") == FixedDouble::one() && FixedDouble::parse(".5").raw_value() == 500);
+    assert(FixedDouble::parse("99999999999999999999").raw_value() == std::numeric_limits<std::int64_t>::max());
+    for (const char* bad : {"", "-", ".", "1.2.3", "+1", " 1", "1e3"}) {
+        bool threw = false;
+        try {
+            FixedDouble::parse(bad);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    const std::string_view text = "12.5,7";
+    FixedDouble parsed = FixedDouble::zero();
+    const auto pr = fixed::from_chars(text.data(), text.data() + text.size(), parsed);
+    assert(pr.ec == std::errc() && *pr.ptr == ',' && parsed.raw_value() == 12'500);
+    char text_buf[32];
+    const std::int64_t text_raws[] = {0, -5, 101'250, std::numeric_limits<std::int64_t>::min(),
+                                      std::numeric_limits<std::int64_t>::max()};
+    for (std::int64_t raw : text_raws) {
+        const auto tr = fixed::to_chars(text_buf, text_buf + sizeof(text_buf), FixedDouble::from_raw(raw));
+        assert(tr.ec == std::errc());
+        assert(FixedDouble::parse(std::string_view(text_buf, static_cast<std::size_t>(tr.ptr - text_buf))).raw_value() == raw);
+    }
+    assert(std::string_view(text_buf, static_cast<std::size_t>(
+                                          fixed::to_chars(text_buf, text_buf + sizeof(text_buf), d).ptr - text_buf)) ==
+           "3.250");
+    assert(fixed::to_chars(text_buf, text_buf + 4, d).ec == std::errc::value_too_large);
+
+    // Compile-time values: exact literals, and from_double, parse and the
+    // arithmetic fold the same as at run time.
+    using namespace fixed::literals;
+    static_assert(100.125_fx == FixedDouble::from_raw(100'125) && 1'000.5_fx == FixedDouble::from_raw(1'000'500));
+    static_assert(-2.5_fx == FixedDouble::from_raw(-2'500) && 3_fx == FixedDouble::from_int(3) &&
+                  .5_fx == FixedDouble::from_raw(500) && 1.2500_fx == FixedDouble::from_raw(1'250));
+    static_assert(FixedDouble::from_double(0.0625).raw_value() == 63 && FixedDouble::from_double(-0.0625).raw_value() == -63);
+    static_assert(FixedDouble::from_double(1e300) == FixedDouble::from_raw(std::numeric_limits<std::int64_t>::max()));
+    static_assert(FixedDouble::parse("101.25") == 101.25_fx && FixedDouble::parse("-0.0005") == -0.001_fx);
+    static_assert(101.25_fx * 2_fx == 202.5_fx && (1_fx / 3_fx).raw_value() == 333 && 7.5_fx / 2 == 3.75_fx);
+    static_assert(FixedDivisor<FixedDouble>(0.25_fx).divide(1_fx) == 4_fx &&
+                  fixed_cast<FixedPoint<100>>(1.259_fx).raw_value() == 125);
+    constexpr ticks::Grid<ticks::TickPrice> const_tick(0.05_fx);
+    static_assert(const_tick.to_units(101.25_fx).count() == 2025 && const_tick.to_fixed(ticks::TickPrice(3)) == 0.15_fx);
+    std::mt19937_64 round_rng(7);
+    std::uniform_real_distribution<double> round_dist(-1e6, 1e6);
+    for (int i = 0; i < 100'000; ++i) {
+        // Random values and exact halves of a raw unit.
+        const double v = i % 2 == 0 ? round_dist(round_rng) : static_cast<double>(i - 50'000) / 2000.0;
+        assert(FixedDouble::from_double(v).raw_value() == std::llround(v * 1000.0));
+    }
+
+    // Batch kernels agree with the scalar operators, including the lanes
+    // that fall back near the limits.
+    const std::vector<FixedDouble> lhs = {FixedDouble::from_double(101.25), FixedDouble::from_double(-3.5),
+                                          FixedDouble::from_raw(std::numeric_limits<std::int64_t>::max()),
+                                          FixedDouble::from_double(0.001), FixedDouble::from_double(-7.125)};
+    const std::vector<FixedDouble> rhs = {FixedDouble::from_double(2.5), FixedDouble::from_double(1.5),
+                                          FixedDouble::from_int(3), FixedDouble::from_double(-0.5),
+                                          FixedDouble::from_double(-2.0)};
+    std::vector<FixedDouble> out(lhs.size());
+    fixed::mul_scaled<FixedDouble>(lhs, rhs, out);
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        assert(out[i] == lhs[i] * rhs[i]);
+    }
+    fixed::div_by_const<FixedDouble>(lhs, FixedDouble::from_double(-0.3), out);
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        assert(out[i] == lhs[i] / FixedDouble::from_double(-0.3));
+    }
+    fixed::add<FixedDouble>(rhs, rhs, out);
+    assert(out[0] == FixedDouble::from_int(5));
+
+    // Overflow policies. The default keeps the historical behaviour: + and -
+    // wrap, * and / saturate.
+    constexpr std::int64_t kMax = std::numeric_limits<std::int64_t>::max();
+    constexpr std::int64_t kMin = std::numeric_limits<std::int64_t>::min();
+    const auto top = FixedDouble::from_raw(kMax);
+    assert((top + FixedDouble::from_raw(1)).raw_value() == kMin);
+    assert((top * FixedDouble::from_int(2)).raw_value() == kMax);
+    using WrapFixed = FixedPoint<1000, std::int64_t, fixed::Wrap>;
+    using SatFixed = FixedPoint<1000, std::int64_t, fixed::Saturate>;
+    using FlagFixed = FixedPoint<1000, std::int64_t, fixed::CheckedFlag>;
+    using ThrowFixed = FixedPoint<1000, std::int64_t, fixed::Throw>;
+    assert((WrapFixed::from_raw(kMax) + WrapFixed::from_raw(1)).raw_value() == kMin);
+    assert((WrapFixed::from_raw(kMax / 2 + 1) * WrapFixed::from_int(2)).raw_value() == kMin);
+    assert((SatFixed::from_raw(kMax) + SatFixed::from_raw(1)).raw_value() == kMax);
+    assert((SatFixed::from_raw(kMin) - SatFixed::from_raw(1)).raw_value() == kMin);
+    assert((SatFixed::from_raw(kMin) / -1).raw_value() == kMax);
+    assert((SatFixed::from_raw(kMax) * SatFixed::from_int(-2)).raw_value() == kMin);
+    fixed::CheckedFlag::clear();
+    FlagFixed flagged = FlagFixed::from_int(1) + FlagFixed::from_int(2);
+    flagged = flagged * FlagFixed::from_int(4);
+    assert(!fixed::CheckedFlag::overflowed() && flagged == FlagFixed::from_int(12));
+    flagged = FlagFixed::from_raw(kMax) + FlagFixed::from_raw(1);
+    assert(fixed::CheckedFlag::overflowed() && flagged.raw_value() == kMin);
+    flagged = flagged - FlagFixed::from_int(1); // the flag is sticky
+    assert(fixed::CheckedFlag::overflowed());
+    fixed::CheckedFlag::clear();
+    flagged = FlagFixed::from_raw(kMax / 2) * FlagFixed::from_int(3);
+    assert(fixed::CheckedFlag::overflowed());
+    fixed::CheckedFlag::clear();
+    const auto throws = [](auto op) {
+        try {
+            op();
+        } catch (const std::overflow_error&) {
+            return true;
+        }
+        return false;
+    };
+    assert(throws([&] { return ThrowFixed::from_raw(kMax) + ThrowFixed::from_raw(1); }));
+    assert(throws([&] { return ThrowFixed::from_raw(kMin) - ThrowFixed::from_raw(1); }));
+    assert(throws([&] { return ThrowFixed::from_raw(kMax) * ThrowFixed::from_int(2); }));
+    assert(throws([&] { return ThrowFixed::from_raw(kMax) / ThrowFixed::from_double(0.5); }));
+    assert(!throws([&] { return ThrowFixed::from_int(7) * ThrowFixed::from_double(1.5); }));
+    // Grid conversions go through the same policy.
+    const ticks::TickPrice far_tick(kMax / 5);
+    assert(ticks::Grid<ticks::TickPrice>(FixedDouble::from_raw(10)).to_fixed(far_tick).raw_value() == kMax);
+    assert((ticks::StaticGrid<ticks::TickPrice, 10>::to_fixed(ticks::TickPrice(-kMax / 5)).raw_value() == kMin));
+    assert(throws([&] { return ticks::Grid<ticks::TickPrice, ThrowFixed>(ThrowFixed::from_raw(10)).to_fixed(far_tick); }));
+    assert(throws([&] { return ticks::StaticGrid<ticks::TickPrice, 10, ThrowFixed>::to_fixed(far_tick); }));
+    using CountedFixed = FixedPoint<1000, std::int64_t, fixed::Counted<>>;
+    using CountedSat = FixedPoint<1000, std::int64_t, fixed::Counted<fixed::Saturate>>;
+    const fixed::OverflowCounters counted_before = fixed::overflow_counters();
+    assert((CountedFixed::from_int(2) + CountedFixed::from_int(3)) == CountedFixed::from_int(5));
+    assert(fixed::overflow_counters().total() == counted_before.total());
+    assert((CountedFixed::from_raw(kMax) + CountedFixed::from_raw(1)).raw_value() == kMin); // still wraps
+    assert((CountedFixed::from_raw(kMax) * CountedFixed::from_int(2)).raw_value() == kMax); // still saturates
+    assert((CountedSat::from_raw(kMin) - CountedSat::from_raw(1)).raw_value() == kMin);
+    assert(fixed::overflow_counters().add == counted_before.add + 1 &&
+           fixed::overflow_counters().sub == counted_before.sub + 1 &&
+           fixed::overflow_counters().narrow == counted_before.narrow + 1);
+    std::vector<SatFixed> sat_out(2);
+    const std::vector<SatFixed> sat_in = {SatFixed::from_raw(kMax), SatFixed::from_int(1)};
+    fixed::add<SatFixed>(sat_in, sat_in, sat_out);
+    assert(sat_out[0].raw_value() == kMax && sat_out[1] == SatFixed::from_int(2));
+
+    // Sums of products round once, not per element.
+    FixedAccumulator<FixedDouble> products;
+    const auto third = FixedDouble::from_raw(333); // 0.333
+    for (int i = 0; i < 3; ++i) {
+        products.add_product(third, FixedDouble::from_raw(1)); // 0.000333 each
+    }
+    assert(products.result() == FixedDouble::from_raw(0));
+    products.add_product(third, FixedDouble::from_raw(1));
+    assert(products.result() == FixedDouble::from_raw(1) && products.raw_sum() == 4 * 333);
+    products.reset();
+    products.add_product(FixedDouble::from_double(100.25), FixedDouble::from_int(2));
+    products.add_product(FixedDouble::from_double(100.5), FixedDouble::from_int(1));
+    assert(products.divided_by(FixedDouble::from_int(3)) == FixedDouble::from_raw(100'333));
+    products.add(FixedDouble::from_double(-301.0));
+    assert(products.result() == FixedDouble::zero());
+    const std::vector<FixedDouble> dot_px = {FixedDouble::from_double(101.25), FixedDouble::from_double(-3.5),
+                                         FixedDouble::from_double(0.001)};
+    const std::vector<FixedDouble> dot_qty = {FixedDouble::from_double(2.5), FixedDouble::from_double(1.5),
+                                         FixedDouble::from_double(0.5)};
+    assert(fixed::dot<FixedDouble>(dot_px, dot_qty) == FixedDouble::from_raw(253'125 - 5'250)); // 0.0005 truncates away
+
+    os << "All FixedDouble checks passed\n";
+}
+
+// The four operations on FixedDouble's layout under one overflow policy.
+template <typename Policy>
+void bench_policy(const std::vector<TickD>& double_ticks, std::size_t iters, const std::string& name,
+                  std::vector<Result>& results) {
+    using Fixed = FixedPoint<1000, std::int64_t, Policy>;
+    const auto ticks = to_fixed<Fixed>(double_ticks);
+    const std::string prefix = "FixedDouble<" + name + "> ";
+    results.push_back(bench_fixed_t<Operation::Add>(ticks, iters, prefix + "add"));
+    results.push_back(bench_fixed_t<Operation::Sub>(ticks, iters, prefix + "sub"));
+    results.push_back(bench_fixed_t<Operation::Mul>(ticks, iters, prefix + "mul"));
+    results.push_back(bench_fixed_t<Operation::Div>(ticks, iters, prefix + "div"));
 }
 
-void run_arithmetic_benchmarks() {
-    const std::size_t ticks = 64 * 1024;
-    const std::size_t iters = 5'000'000; // iterations per operation; 8 benches total
+// ticks must be a power of two (index masks).
+void run_arithmetic_benchmarks(bench::Reporter& report, std::size_t ticks, std::size_t iters) {
+    std::ostream& out = report.text();
 
     auto double_ticks = make_ticks(ticks);
     auto fixed_ticks = to_fixed(double_ticks);
+    auto q_ticks = to_fixed<FixedQ32_32>(double_ticks);
 
     std::vector<Result> results;
     results.push_back(bench_double_t<Operation::Add>(double_ticks, iters, "double add"));
@@ -293,42 +623,470 @@ void run_arithmetic_benchmarks() {
     results.push_back(bench_fixed_t<Operation::Mul>(fixed_ticks, iters, "FixedDouble mul"));
     results.push_back(bench_fixed_t<Operation::Div>(fixed_ticks, iters, "FixedDouble div"));
 
-    std::cout << "Arithmetic microbench (per op: " << iters << " iterations)\n";
-    for (const auto& r : results) {
-        std::cout << "  " << r.name << ": " << r.ms << " ms, " << r.ns_per_op << " ns/op\n";
-    }
-    std::cout << "sinks: " << g_double_sink << " / " << g_fixed_sink << "\n";
+    bench_policy<fixed::Wrap>(double_ticks, iters, "Wrap", results);
+    bench_policy<fixed::Saturate>(double_ticks, iters, "Saturate", results);
+    bench_policy<fixed::CheckedFlag>(double_ticks, iters, "CheckedFlag", results);
+    bench_policy<fixed::Throw>(double_ticks, iters, "Throw", results);
+    bench_policy<fixed::Counted<>>(double_ticks, iters, "Counted", results);
+
+    results.push_back(bench_fixed_t<Operation::Add>(q_ticks, iters, "FixedQ<32,32> add"));
+    results.push_back(bench_fixed_t<Operation::Sub>(q_ticks, iters, "FixedQ<32,32> sub"));
+    results.push_back(bench_fixed_t<Operation::Mul>(q_ticks, iters, "FixedQ<32,32> mul"));
+    results.push_back(bench_fixed_t<Operation::Div>(q_ticks, iters, "FixedQ<32,32> div"));
+
+    out << "Arithmetic microbench (" << ticks << " ticks, per op: " << iters << " iterations, latency per "
+        << kSampleBlock << "-op block)\n";
+    print_results(report, "arithmetic", ticks, results);
+    out << "sinks: " << g_double_sink << " / " << g_fixed_sink << "\n";
 }
 
-void run_division_benchmarks() {
-    const std::size_t samples = 16 * 1024;
-    const std::size_t iters = 20'000'000;
+void run_division_benchmarks(bench::Reporter& report, std::size_t samples, std::size_t iters) {
+    std::ostream& out = report.text();
 
     auto data_d = make_double_data(samples);
     auto data_f = make_fixed_data(data_d);
+    auto data_q = make_fixed_data<FixedQ32_32>(data_d);
 
     std::vector<Result> results;
     results.push_back(bench_double_div(data_d, iters));
     results.push_back(bench_double_mul_recip(data_d, iters));
     results.push_back(bench_double_div_const(data_d, iters));
     results.push_back(bench_double_mul_const_small(data_d, iters));
-    results.push_back(bench_fixed_div(data_f, iters));
-    results.push_back(bench_fixed_mul_recip(data_f, iters));
-    results.push_back(bench_fixed_div_const(data_f, iters));
+    results.push_back(bench_fixed_div(data_f, iters, "FixedDouble"));
+    results.push_back(bench_fixed_mul_recip(data_f, iters, "FixedDouble"));
+    results.push_back(bench_fixed_div_const(data_f, iters, "FixedDouble"));
+    results.push_back(bench_fixed_div_pow10(data_f, iters));
+    // Opaque to the optimizer so operator/ really divides at runtime.
+    volatile double lot_size = 0.125;
+    const FixedDouble lot = FixedDouble::from_double(lot_size);
+    results.push_back(bench_fixed_div_lot(data_f, iters, lot));
+    results.push_back(bench_fixed_divisor_lot(data_f, iters, lot));
     results.push_back(bench_fixed_mul_const_small(data_f, iters));
+    results.push_back(bench_fixed_notional(data_f, iters));
+    results.push_back(bench_fixed_div(data_q, iters, "FixedQ<32,32>"));
+    results.push_back(bench_fixed_mul_recip(data_q, iters, "FixedQ<32,32>"));
+    results.push_back(bench_fixed_div_const(data_q, iters, "FixedQ<32,32>"));
 
-    std::cout << "Division vs reciprocal multiply (" << iters << " iterations)\n";
-    for (const auto& r : results) {
-        std::cout << "  " << r.name << ": " << r.ms << " ms, " << r.ns_per_op << " ns/op\n";
+    out << "Division vs reciprocal multiply (" << samples << " operands, " << iters << " iterations, latency per "
+        << kSampleBlock << "-op block)\n";
+    print_results(report, "division", samples, results);
+    out << "sinks: " << g_double_sink << " / " << g_fixed_sink << "\n";
+}
+
+// Price -> level slot lookup as an order book does on every add: FixedDouble
+// raw keys in a hash map (order-book/order_book.hpp) or an ordered map, vs a
+// tick index used directly as an array offset.
+// levels: ticks covered around the mid; lookups spread over levels / 100
+// ticks either side of it.
+void run_level_lookup_benchmarks(bench::Reporter& report, std::size_t levels, std::size_t iters) {
+    std::ostream& out = report.text();
+    const std::size_t samples = 64 * 1024;
+    using TickGrid = ticks::StaticGrid<ticks::TickPrice, 10>; // 0.01 on FixedDouble
+    const ticks::Grid<ticks::TickPrice> runtime_grid(TickGrid::step());
+
+    const ticks::TickPrice base_tick = TickGrid::to_units(FixedDouble::from_int(90));
+    std::vector<std::uint32_t> level_qty(levels);
+    std::unordered_map<FixedDouble::storage_type, std::uint32_t> hash_levels;
+    std::map<FixedDouble::storage_type, std::uint32_t> tree_levels;
+    std::vector<std::uint32_t> tick_levels(levels);
+    for (std::size_t i = 0; i < levels; ++i) {
+        const FixedDouble price = TickGrid::to_fixed(base_tick + ticks::TickPrice(static_cast<std::int64_t>(i)));
+        level_qty[i] = static_cast<std::uint32_t>(i % 97 + 1);
+        hash_levels.emplace(price.raw_value(), static_cast<std::uint32_t>(i));
+        tree_levels.emplace(price.raw_value(), static_cast<std::uint32_t>(i));
+        tick_levels[i] = static_cast<std::uint32_t>(i);
     }
-    std::cout << "sinks: " << g_double_sink << " / " << g_fixed_sink << "\n";
+
+    // Activity clusters around the touch in the middle of the range.
+    std::mt19937_64 rng(99);
+    std::normal_distribution<double> offset_dist(0.0, static_cast<double>(levels) / 100.0);
+    std::vector<FixedDouble> fixed_prices(samples);
+    std::vector<ticks::TickPrice> tick_prices(samples);
+    for (std::size_t i = 0; i < samples; ++i) {
+        const auto offset = static_cast<std::int64_t>(std::llround(offset_dist(rng)));
+        const std::int64_t idx = std::clamp<std::int64_t>(static_cast<std::int64_t>(levels / 2) + offset, 0,
+                                                          static_cast<std::int64_t>(levels) - 1);
+        tick_prices[i] = base_tick + ticks::TickPrice(idx);
+        fixed_prices[i] = TickGrid::to_fixed(tick_prices[i]);
+    }
+
+    const std::size_t mask = samples - 1;
+    std::uint64_t acc = 0;
+    std::vector<Result> results;
+    results.push_back(run_timed("FixedDouble key, unordered_map", iters, [&](std::size_t i) {
+        acc += level_qty[hash_levels.find(fixed_prices[i & mask].raw_value())->second];
+    }));
+    results.push_back(run_timed("FixedDouble key, std::map", iters, [&](std::size_t i) {
+        acc += level_qty[tree_levels.find(fixed_prices[i & mask].raw_value())->second];
+    }));
+    results.push_back(run_timed("TickPrice, array index", iters, [&](std::size_t i) {
+        acc += level_qty[tick_levels[static_cast<std::size_t>((tick_prices[i & mask] - base_tick).count())]];
+    }));
+    results.push_back(run_timed("FixedDouble -> static tick grid, array index", iters, [&](std::size_t i) {
+        const ticks::TickPrice t = TickGrid::to_units(fixed_prices[i & mask]);
+        acc += level_qty[tick_levels[static_cast<std::size_t>((t - base_tick).count())]];
+    }));
+    results.push_back(run_timed("FixedDouble -> runtime tick grid, array index", iters, [&](std::size_t i) {
+        const ticks::TickPrice t = runtime_grid.to_units(fixed_prices[i & mask]);
+        acc += level_qty[tick_levels[static_cast<std::size_t>((t - base_tick).count())]];
+    }));
+    g_fixed_sink = acc;
+
+    out << "Book level lookup (" << levels << " levels, " << iters << " lookups, latency per " << kSampleBlock
+        << "-op block)\n";
+    print_results(report, "level-lookup", levels, results);
+    out << "sinks: " << g_fixed_sink << "\n";
 }
 
+// Mid, spread and notional recomputed over a whole book snapshot (SoA
+// arrays), one call per snapshot: scalar FixedDouble loops, the fixed:: batch
+// kernels, and the same loops on double (which the compiler vectorises).
+// ops: elements processed per case, split into calls over the whole snapshot.
+void run_batch_benchmarks(bench::Reporter& report, std::size_t levels, std::size_t ops) {
+    std::ostream& out_text = report.text();
+    const std::size_t reps = std::max<std::size_t>(1, ops / levels);
+    const auto src = make_ticks(levels);
+
+    std::vector<double> bid_d(levels), ask_d(levels), qty_d(levels), out_d(levels);
+    std::vector<FixedDouble> bid(levels), ask(levels), qty(levels), out(levels);
+    for (std::size_t i = 0; i < levels; ++i) {
+        bid_d[i] = src[i].bid;
+        ask_d[i] = src[i].ask;
+        qty_d[i] = src[i].qty * 100.0;
+        bid[i] = FixedDouble::from_double(bid_d[i]);
+        ask[i] = FixedDouble::from_double(ask_d[i]);
+        qty[i] = FixedDouble::from_double(qty_d[i]);
+    }
+    // Opaque to the compiler, like a divisor from reference data.
+    volatile std::int64_t two_raw = 2'000;
+    const FixedDouble two = FixedDouble::from_raw(two_raw);
+    const double two_d = two.to_double();
+    using CSpan = std::span<const FixedDouble>;
+    const CSpan bid_s(bid), ask_s(ask), qty_s(qty);
+    const std::span<FixedDouble> out_s(out);
+
+    std::vector<Result> results;
+    const auto add_row = [&](const char* name, auto&& body) {
+        results.push_back(run_batched(name, reps, levels, body));
+    };
+
+    add_row("double add (mid sum)", [&] {
+        for (std::size_t i = 0; i < levels; ++i) out_d[i] = bid_d[i] + ask_d[i];
+    });
+    add_row("FixedDouble scalar add", [&] {
+        for (std::size_t i = 0; i < levels; ++i) out[i] = bid[i] + ask[i];
+    });
+    add_row("fixed::add", [&] { fixed::add<FixedDouble>(bid_s, ask_s, out_s); });
+
+    add_row("double sub (spread)", [&] {
+        for (std::size_t i = 0; i < levels; ++i) out_d[i] = ask_d[i] - bid_d[i];
+    });
+    add_row("FixedDouble scalar sub", [&] {
+        for (std::size_t i = 0; i < levels; ++i) out[i] = ask[i] - bid[i];
+    });
+    add_row("fixed::sub", [&] { fixed::sub<FixedDouble>(ask_s, bid_s, out_s); });
+
+    add_row("double mul (notional)", [&] {
+        for (std::size_t i = 0; i < levels; ++i) out_d[i] = bid_d[i] * qty_d[i];
+    });
+    add_row("FixedDouble scalar mul", [&] {
+        for (std::size_t i = 0; i < levels; ++i) out[i] = bid[i] * qty[i];
+    });
+    add_row("fixed::mul_scaled", [&] { fixed::mul_scaled<FixedDouble>(bid_s, qty_s, out_s); });
+#if defined(__AVX512F__)
+    add_row("fixed::batch::mul_scaled<Avx2>", [&] { fixed::batch::mul_scaled<fixed::batch::Avx2>(bid_s, qty_s, out_s); });
+#endif
+
+    add_row("double div (mid / 2)", [&] {
+        for (std::size_t i = 0; i < levels; ++i) out_d[i] = bid_d[i] / two_d;
+    });
+    add_row("FixedDouble scalar div", [&] {
+        for (std::size_t i = 0; i < levels; ++i) out[i] = bid[i] / two;
+    });
+    add_row("fixed::div_by_const", [&] { fixed::div_by_const<FixedDouble>(bid_s, two, out_s); });
+#if defined(__AVX512F__)
+    add_row("fixed::batch::div_by_const<Avx2>", [&] { fixed::batch::div_by_const<fixed::batch::Avx2>(bid_s, two, out_s); });
+#endif
+    g_double_sink = out_d[levels / 2];
+    g_fixed_sink = static_cast<std::uint64_t>(out[levels / 2].raw_value());
+
+    const char* isa = std::is_same<fixed::batch::native, fixed::batch::Scalar>::value ? "scalar"
+                      : fixed::batch::native::lanes == 8                             ? "AVX-512"
+                                                                                      : "AVX2";
+    out_text << "Batch kernels (" << levels << "-level snapshot x " << reps << ", " << isa
+             << ", ns and latency per element)\n";
+    print_results(report, "batch", levels, results);
+    out_text << "sinks: " << g_double_sink << " / " << g_fixed_sink << "\n";
+}
+
+// VWAP over a trade tape: sum(price * qty) / sum(qty). The operator* loop
+// rescales (and truncates) every product; FixedAccumulator and fixed::dot keep
+// the exact sum and round once.
+void run_vwap_benchmarks(bench::Reporter& report, std::size_t trades, std::size_t ops) {
+    std::ostream& out = report.text();
+    const std::size_t reps = std::max<std::size_t>(1, ops / trades);
+    const auto src = make_ticks(trades);
+
+    std::vector<double> px_d(trades), qty_d(trades);
+    std::vector<FixedDouble> px(trades), qty(trades);
+    for (std::size_t i = 0; i < trades; ++i) {
+        px_d[i] = src[i].bid;
+        qty_d[i] = src[i].qty;
+        px[i] = FixedDouble::from_double(px_d[i]);
+        qty[i] = FixedDouble::from_double(qty_d[i]);
+        px_d[i] = px[i].to_double(); // same inputs for every variant
+        qty_d[i] = qty[i].to_double();
+    }
+    const std::span<const FixedDouble> px_s(px), qty_s(qty);
+
+    double vwap_d = 0.0;
+    FixedDouble vwap_mul = FixedDouble::zero();
+    FixedDouble vwap_acc = FixedDouble::zero();
+    FixedDouble vwap_dot = FixedDouble::zero();
+    std::vector<Result> results;
+    const auto add_row = [&](const char* name, auto&& body) {
+        results.push_back(run_batched(name, reps, trades, body));
+    };
+
+    add_row("double", [&] {
+        double notional = 0.0;
+        double volume = 0.0;
+        for (std::size_t i = 0; i < trades; ++i) {
+            notional += px_d[i] * qty_d[i];
+            volume += qty_d[i];
+        }
+        vwap_d = notional / volume;
+    });
+    add_row("FixedDouble operator*", [&] {
+        FixedDouble notional = FixedDouble::zero();
+        FixedDouble volume = FixedDouble::zero();
+        for (std::size_t i = 0; i < trades; ++i) {
+            notional += px[i] * qty[i];
+            volume += qty[i];
+        }
+        vwap_mul = notional / volume;
+    });
+    add_row("FixedAccumulator", [&] {
+        FixedAccumulator<FixedDouble> notional;
+        FixedDouble volume = FixedDouble::zero();
+        for (std::size_t i = 0; i < trades; ++i) {
+            notional.add_product(px[i], qty[i]);
+            volume += qty[i];
+        }
+        vwap_acc = notional.divided_by(volume);
+    });
+    add_row("fixed::dot", [&] {
+        FixedDouble volume = FixedDouble::zero();
+        for (std::size_t i = 0; i < trades; ++i) {
+            volume += qty[i];
+        }
+        vwap_dot = fixed::dot(px_s, qty_s) / volume;
+    });
+    g_double_sink = vwap_d;
+    g_fixed_sink = static_cast<std::uint64_t>(vwap_mul.raw_value() ^ vwap_acc.raw_value() ^ vwap_dot.raw_value());
+
+    // Reference: the exact rational sum(raw products) / sum(raw qty).
+    FixedAccumulator<FixedDouble> exact;
+    FixedDouble volume = FixedDouble::zero();
+    FixedDouble notional_mul = FixedDouble::zero();
+    for (std::size_t i = 0; i < trades; ++i) {
+        exact.add_product(px[i], qty[i]);
+        volume += qty[i];
+        notional_mul += px[i] * qty[i];
+    }
+    const long double exact_vwap = static_cast<long double>(exact.raw_sum()) / volume.raw_value() / 1000.0L;
+
+    out << "VWAP (" << trades << " trades x " << reps << ", ns and latency per trade)\n";
+    print_results(report, "vwap", trades, results);
+    out.precision(12);
+    out << "  notional: exact " << exact.result() << ", operator* sum " << notional_mul << " ("
+        << (exact.result() - notional_mul).raw_value() << " raw units lost)\n"
+        << "  vwap: exact " << static_cast<double>(exact_vwap) << ", double " << vwap_d << ", operator* "
+        << vwap_mul << ", accumulator " << vwap_acc << ", dot " << vwap_dot << "\n";
+    out.precision(6);
+}
+
+// Decimal price strings as they arrive in a feed or JSON field: mostly 2-4
+// decimals (some past FixedDouble's three, which round), a few integers.
+std::vector<std::string> make_price_strings(std::size_t n) {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> px(0.5, 20'000.0);
+    std::uniform_int_distribution<int> decimals(0, 5);
+    std::vector<std::string> out;
+    out.reserve(n);
+    char buf[64];
+    for (std::size_t i = 0; i < n; ++i) {
+        std::snprintf(buf, sizeof(buf), "%.*f", decimals(rng), px(rng));
+        out.emplace_back(buf);
+    }
+    return out;
+}
+
+// samples must be a power of two (index masks).
+void run_text_benchmarks(bench::Reporter& report, std::size_t samples, std::size_t iters) {
+    std::ostream& text = report.text();
+    const std::vector<std::string> strings = make_price_strings(samples);
+    std::vector<std::string_view> views(strings.begin(), strings.end());
+    std::vector<FixedDouble> values;
+    values.reserve(samples);
+    for (const auto& sv : views) {
+        values.push_back(FixedDouble::parse(sv));
+    }
+    std::vector<double> doubles;
+    doubles.reserve(samples);
+    for (const auto& v : values) {
+        doubles.push_back(v.to_double());
+    }
+
+    const std::size_t mask = samples - 1;
+    std::int64_t acc = 0;
+    std::size_t bytes = 0;
+    char out[48];
+    std::vector<Result> results;
+    results.push_back(run_timed("strtod + from_double", iters, [&](std::size_t i) {
+        acc += FixedDouble::from_double(std::strtod(strings[i & mask].c_str(), nullptr)).raw_value();
+    }));
+    results.push_back(run_timed("from_chars<double> + from_double", iters, [&](std::size_t i) {
+        const std::string_view sv = views[i & mask];
+        double v = 0.0;
+        std::from_chars(sv.data(), sv.data() + sv.size(), v);
+        acc += FixedDouble::from_double(v).raw_value();
+    }));
+    results.push_back(run_timed("FixedDouble::parse", iters, [&](std::size_t i) {
+        acc += FixedDouble::parse(views[i & mask]).raw_value();
+    }));
+    results.push_back(run_timed("fixed::from_chars", iters, [&](std::size_t i) {
+        const std::string_view sv = views[i & mask];
+        FixedDouble v;
+        fixed::from_chars(sv.data(), sv.data() + sv.size(), v);
+        acc += v.raw_value();
+    }));
+    results.push_back(run_timed("snprintf(\"%.3f\", double)", iters, [&](std::size_t i) {
+        bytes += static_cast<std::size_t>(std::snprintf(out, sizeof(out), "%.3f", doubles[i & mask]));
+    }));
+    results.push_back(run_timed("to_chars(double, fixed, 3)", iters, [&](std::size_t i) {
+        bytes += static_cast<std::size_t>(
+            std::to_chars(out, out + sizeof(out), doubles[i & mask], std::chars_format::fixed, 3).ptr - out);
+    }));
+    results.push_back(run_timed("fixed::to_chars(FixedDouble)", iters, [&](std::size_t i) {
+        bytes += static_cast<std::size_t>(fixed::to_chars(out, out + sizeof(out), values[i & mask]).ptr - out);
+    }));
+    g_fixed_sink = static_cast<std::uint64_t>(acc) + bytes;
+
+    text << "Decimal text (" << samples << " price strings, " << iters << " conversions, latency per "
+         << kSampleBlock << "-op block)\n";
+    print_results(report, "text", samples, results);
+    text << "sinks: " << g_fixed_sink << "\n";
+}
+
+// Random reads of a tick array, with the array on different page sizes.
+// Every access is to an unrelated line, so past the TLB's reach (a few MB of
+// 4K pages) each one also walks the page table; 2M pages cover 512x more.
+template <typename Alloc>
+Result bench_tick_gather(const std::vector<TickF>& src, std::size_t iters, std::string name) {
+    const std::vector<TickF, Alloc> ticks(src.begin(), src.end());
+    const std::size_t mask = ticks.size() - 1;
+    std::uint64_t x = 0x9E3779B97F4A7C15ull;
+    FixedDouble acc = FixedDouble::zero();
+    Result r = run_timed(std::move(name), iters, [&](std::size_t) {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        const auto& t = ticks[(x >> 24) & mask];
+        acc += t.bid * t.qty;
+    });
+    g_fixed_sink = acc.raw_value();
+    return r;
+}
+
+// ticks must be a power of two (index masks).
+void run_page_benchmarks(bench::Reporter& report, std::size_t ticks, std::size_t iters) {
+    std::ostream& out = report.text();
+    const auto fixed_ticks = to_fixed(make_ticks(ticks));
+
+    std::vector<Result> results;
+    std::vector<std::string> backings;
+    auto run = [&](auto alloc_tag, const std::string& name) {
+        using Alloc = typename decltype(alloc_tag)::type;
+        const mem::PageStats before = mem::page_stats();
+        results.push_back(bench_tick_gather<Alloc>(fixed_ticks, iters, name));
+        const mem::PageStats got = mem::page_stats() - before;
+        backings.push_back(name + ": " + mem::describe(got));
+    };
+    run(std::type_identity<std::allocator<TickF>>{}, "FixedDouble gather std::allocator");
+    run(std::type_identity<mem::PageAllocator<TickF, mem::Pages::Base4K>>{}, "FixedDouble gather 4K pages");
+    run(std::type_identity<mem::PageAllocator<TickF, mem::Pages::Huge2M>>{}, "FixedDouble gather 2M pages");
+    const bool have_1g = mem::hugetlb_pages_free(mem::Pages::Huge1G) > 0;
+    if (have_1g) {
+        run(std::type_identity<mem::PageAllocator<TickF, mem::Pages::Huge1G>>{}, "FixedDouble gather 1G pages");
+    }
+
+    out << "Page size (" << ticks << " ticks, " << ticks * sizeof(TickF) / (1 << 20) << " MB, " << iters
+        << " random reads, latency per " << kSampleBlock << "-op block"
+        << (have_1g ? "" : "; no free 1G hugetlb pages, 1G skipped") << ")\n";
+    for (const auto& b : backings) {
+        out << "  backing " << b << "\n";
+    }
+    print_results(report, "pages", ticks, results);
+    out << "sinks: " << g_fixed_sink << "\n";
+}
+
+// Benchmark groups in run order, with their default working-set size and
+// operation count (--sizes / --iters override them). Sizes are rounded up to
+// a power of two for the groups that index with a mask.
+struct Group {
+    const char* name;
+    void (*run)(bench::Reporter&, std::size_t size, std::size_t ops);
+    std::size_t size;
+    std::size_t ops;
+    bool pow2;
+};
+
+constexpr Group kGroups[] = {
+    {"arithmetic", run_arithmetic_benchmarks, 64 * 1024, 5'000'000, true},
+    {"division", run_division_benchmarks, 16 * 1024, 20'000'000, true},
+    {"level-lookup", run_level_lookup_benchmarks, 2'000, 20'000'000, false},
+    {"text", run_text_benchmarks, 16 * 1024, 10'000'000, true},
+    {"batch", run_batch_benchmarks, 4'096, 4'096 * 20'000, false},
+    {"vwap", run_vwap_benchmarks, 4'096, 4'096 * 20'000, false},
+    {"pages", run_page_benchmarks, 4 * 1024 * 1024, 20'000'000, true},
+};
+
 }  // namespace
 
-int main() {
-    run_fixed_double_tests();
-    run_arithmetic_benchmarks();
-    run_division_benchmarks();
+int main(int argc, char** argv) {
+    bench::Options opts;
+    try {
+        opts = bench::parse_options(argc, argv);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n" << bench::usage();
+        return 2;
+    }
+    if (opts.help) {
+        std::cout << "scenarios:";
+        for (const Group& g : kGroups) {
+            std::cout << " " << g.name << " (" << g.size << " x " << g.ops << ")";
+        }
+        std::cout << "\nsizes: working set of each scenario; iters: operations per case\n" << bench::usage();
+        return 0;
+    }
+
+    try {
+        bench::Reporter report(opts);
+        bench::setup_runner(opts, report);
+        g_runs = opts.reps_or(1);
+        run_fixed_double_tests(report.text());
+        bench::print_timer_info(report.text());
+        for (const Group& g : kGroups) {
+            if (!opts.selected(g.name)) {
+                continue;
+            }
+            for (std::size_t size : opts.sizes_or({g.size})) {
+                g.run(report, g.pow2 ? std::bit_ceil(size) : size, opts.iters_or(g.ops));
+            }
+        }
+        report.finish();
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
     return 0;
 }
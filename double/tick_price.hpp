@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+
+#include "fixed_double.hpp"
+
+namespace ticks {
+
+// Integer count of grid steps (ticks for prices, lots for quantities),
+// relative to the instrument's grid. Tag keeps prices and quantities from
+// mixing; the grid that gives the count a meaning lives outside the value so
+// an 8-byte price stays an 8-byte price.
+template <typename Tag>
+class GridUnits {
+public:
+    constexpr GridUnits() = default;
+    explicit constexpr GridUnits(std::int64_t count) : count_(count) {}
+
+    constexpr std::int64_t count() const { return count_; }
+
+    constexpr GridUnits& operator+=(GridUnits other) {
+        count_ += other.count_;
+        return *this;
+    }
+
+    constexpr GridUnits& operator-=(GridUnits other) {
+        count_ -= other.count_;
+        return *this;
+    }
+
+    friend constexpr GridUnits operator+(GridUnits lhs, GridUnits rhs) { return lhs += rhs; }
+    friend constexpr GridUnits operator-(GridUnits lhs, GridUnits rhs) { return lhs -= rhs; }
+
+    friend constexpr bool operator==(GridUnits lhs, GridUnits rhs) { return lhs.count_ == rhs.count_; }
+    friend constexpr bool operator!=(GridUnits lhs, GridUnits rhs) { return !(lhs == rhs); }
+    friend constexpr bool operator<(GridUnits lhs, GridUnits rhs) { return lhs.count_ < rhs.count_; }
+    friend constexpr bool operator<=(GridUnits lhs, GridUnits rhs) { return lhs.count_ <= rhs.count_; }
+    friend constexpr bool operator>(GridUnits lhs, GridUnits rhs) { return rhs < lhs; }
+    friend constexpr bool operator>=(GridUnits lhs, GridUnits rhs) { return rhs <= lhs; }
+
+private:
+    std::int64_t count_ = 0;
+};
+
+namespace detail {
+
+// units x step in raw units of Fixed, exact in 128 bits and brought to the
+// storage width by Fixed's overflow policy, like any other FixedPoint
+// product (DefaultOverflow saturates, Throw throws, Wrap is the plain
+// multiply).
+template <typename Fixed>
+constexpr Fixed scale_step(std::int64_t count, typename Fixed::storage_type step_raw) {
+    using Storage = typename Fixed::storage_type;
+    const __int128 prod = static_cast<__int128>(count) * static_cast<__int128>(step_raw);
+    return Fixed::from_raw(Fixed::overflow_policy::template narrow<Storage>(prod));
+}
+
+} // namespace detail
+
+struct PriceTag {};
+struct QtyTag {};
+
+using TickPrice = GridUnits<PriceTag>;
+using LotQty = GridUnits<QtyTag>;
+
+// Step size known only at runtime (loaded from instrument reference data).
+// to_fixed is one multiply, out-of-range results handled by Fixed's overflow
+// policy; to_units divides by the step with a precomputed
+// reciprocal, truncating toward zero for values off the grid. A grid built
+// from a constant is itself constexpr: constexpr Grid<TickPrice> tick(0.01_fx).
+template <typename Units, typename Fixed = FixedDouble>
+class Grid {
+public:
+    using units_type = Units;
+    using fixed_type = Fixed;
+
+    explicit constexpr Grid(Fixed step) : step_(step), divider_(checked_step(step)) {}
+
+    constexpr Fixed step() const { return step_; }
+
+    constexpr Fixed to_fixed(Units units) const { return detail::scale_step<Fixed>(units.count(), step_.raw_value()); }
+
+    constexpr Units to_units(Fixed value) const {
+        const std::int64_t raw = value.raw_value();
+        const auto q = static_cast<std::int64_t>(divider_.divide(magnitude(raw)));
+        return Units(raw < 0 ? -q : q);
+    }
+
+    constexpr bool on_grid(Fixed value) const { return to_fixed(to_units(value)) == value; }
+
+private:
+    static constexpr std::uint64_t magnitude(std::int64_t raw) {
+        return raw < 0 ? std::uint64_t{0} - static_cast<std::uint64_t>(raw) : static_cast<std::uint64_t>(raw);
+    }
+
+    static constexpr std::uint64_t checked_step(Fixed step) {
+        if (step.raw_value() <= 0) {
+            throw std::invalid_argument("grid step must be positive");
+        }
+        return static_cast<std::uint64_t>(step.raw_value());
+    }
+
+    Fixed step_;
+    fixed::Divider64 divider_;
+};
+
+// Step size fixed at compile time, given in raw units of Fixed (e.g. 10 for a
+// 0.01 tick on FixedDouble). Stateless; same interface as Grid.
+template <typename Units, std::int64_t StepRaw, typename Fixed = FixedDouble>
+class StaticGrid {
+    static_assert(StepRaw > 0, "grid step must be positive");
+    static_assert(StepRaw <= std::numeric_limits<typename Fixed::storage_type>::max(),
+                  "grid step must fit in the storage type");
+
+public:
+    using units_type = Units;
+    using fixed_type = Fixed;
+
+    static constexpr Fixed step() { return Fixed::from_raw(StepRaw); }
+
+    static constexpr Fixed to_fixed(Units units) {
+        return detail::scale_step<Fixed>(units.count(), static_cast<typename Fixed::storage_type>(StepRaw));
+    }
+    static constexpr Units to_units(Fixed value) { return Units(value.raw_value() / StepRaw); }
+    static constexpr bool on_grid(Fixed value) { return value.raw_value() % StepRaw == 0; }
+};
+
+// Notional of qty at price in Fixed: two multiplies by the steps and one
+// fixed-point multiply. Works with any mix of Grid/StaticGrid.
+template <typename PriceGrid, typename QtyGrid>
+constexpr typename PriceGrid::fixed_type notional(TickPrice price, LotQty qty, const PriceGrid& tick, const QtyGrid& lot) {
+    return tick.to_fixed(price) * lot.to_fixed(qty);
+}
+
+template <typename Tag>
+inline std::ostream& operator<<(std::ostream& os, GridUnits<Tag> v) {
+    return os << v.count();
+}
+
+} // namespace ticks
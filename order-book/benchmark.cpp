@@ -0,0 +1,921 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <optional>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <unistd.h>
+
+#include "../common/bench_env.hpp"
+#include "../common/bench_harness.hpp"
+#include "../common/itch.hpp"
+#include "../double/tick_price.hpp"
+#include "order_book.hpp"
+#include "price_ladder.hpp"
+#include "sharded_books.hpp"
+
+using orderbook::OrderBook;
+using orderbook::Side;
+using orderbook::kItchPerFixed;
+
+struct BenchmarkResult {
+    std::string name;
+    std::size_t operations = 0;
+    std::size_t final_orders = 0;
+    double ms = 0.0;
+    double ns_per_op = 0.0;
+    std::uint64_t checksum = 0;
+    bench::LatencyHistogram latency; // filled only by the sampled run
+};
+
+// To keep the compiler from optimizing away book work.
+volatile std::uint64_t g_sink = 0;
+
+enum class MsgType : std::uint8_t { Add, Cancel, Execute };
+
+struct Message {
+    MsgType type;
+    Side side;
+    std::uint64_t id;
+    FixedDouble price; // valid when type == Add
+    FixedDouble qty;   // valid when type == Add or Execute
+};
+
+struct Workload {
+    std::vector<Message> preload;
+    std::vector<Message> steps;
+};
+
+struct WorkloadConfig {
+    std::size_t levels_per_side;
+    std::size_t depth;      // resting orders the book hovers around
+    std::size_t ops;
+    double add_ratio;       // remaining ops split between cancel and execute
+    double execute_ratio;
+};
+
+// Upper bound on resting orders; sizes the book's shared node pool.
+std::size_t max_orders(const WorkloadConfig& cfg) { return 2 * cfg.depth; }
+
+// Builds a feed-like message stream. A reference book is run alongside the
+// generator so executions can target the head of the best level (as real
+// trades do) while cancels hit random resting orders.
+Workload make_workload(const WorkloadConfig& cfg) {
+    const FixedDouble mid = FixedDouble::from_int(100);
+    const FixedDouble tick = FixedDouble::from_raw(10); // 0.01
+
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<std::size_t> level_dist(1, cfg.levels_per_side);
+    std::uniform_int_distribution<std::int64_t> qty_dist(1, 10);
+    std::bernoulli_distribution side_dist(0.5);
+    std::uniform_real_distribution<double> op_dist(0.0, 1.0);
+
+    OrderBook ref(2 * cfg.levels_per_side, max_orders(cfg));
+    std::vector<std::uint64_t> live;
+    live.reserve(max_orders(cfg));
+    std::uint64_t next_id = 1;
+
+    auto make_add = [&] {
+        const Side side = side_dist(rng) ? Side::Buy : Side::Sell;
+        const FixedDouble offset = tick * static_cast<std::int64_t>(level_dist(rng));
+        const FixedDouble price = side == Side::Buy ? mid - offset : mid + offset;
+        const FixedDouble qty = FixedDouble::from_int(qty_dist(rng));
+        const Message msg{MsgType::Add, side, next_id++, price, qty};
+        ref.add(msg.id, msg.side, msg.price, msg.qty);
+        live.push_back(msg.id);
+        return msg;
+    };
+
+    auto drop_live = [&](std::uint64_t id) {
+        for (std::size_t i = live.size(); i-- > 0;) {
+            if (live[i] == id) {
+                live[i] = live.back();
+                live.pop_back();
+                return;
+            }
+        }
+    };
+
+    Workload w;
+    w.preload.reserve(cfg.depth);
+    for (std::size_t i = 0; i < cfg.depth; ++i) {
+        w.preload.push_back(make_add());
+    }
+
+    w.steps.reserve(cfg.ops);
+    for (std::size_t i = 0; i < cfg.ops; ++i) {
+        const double r = op_dist(rng);
+        // Bias towards adds when under target depth so the book stays stable.
+        const double add_ratio = live.size() < cfg.depth ? cfg.add_ratio + 0.1 : cfg.add_ratio - 0.1;
+        if (live.empty() || (r < add_ratio && live.size() < max_orders(cfg))) {
+            w.steps.push_back(make_add());
+        } else if (r < add_ratio + cfg.execute_ratio) {
+            Side side = side_dist(rng) ? Side::Buy : Side::Sell;
+            if (!ref.best(side)) {
+                side = side == Side::Buy ? Side::Sell : Side::Buy;
+            }
+            const orderbook::Order head = *ref.front(side);
+            // Mix of partial and full fills against the resting head order.
+            const FixedDouble qty = op_dist(rng) < 0.5 ? head.qty : FixedDouble::from_int(1);
+            w.steps.push_back(Message{MsgType::Execute, side, head.id, FixedDouble::zero(), qty});
+            if (qty >= head.qty) {
+                drop_live(head.id);
+            }
+            ref.execute(head.id, qty);
+        } else {
+            std::uniform_int_distribution<std::size_t> pick(0, live.size() - 1);
+            const std::size_t pos = pick(rng);
+            const std::uint64_t id = live[pos];
+            live[pos] = live.back();
+            live.pop_back();
+            ref.cancel(id);
+            w.steps.push_back(Message{MsgType::Cancel, Side::Buy, id, FixedDouble::zero(), FixedDouble::zero()});
+        }
+    }
+    return w;
+}
+
+void apply(OrderBook& book, const Message& msg) {
+    switch (msg.type) {
+    case MsgType::Add:
+        book.add(msg.id, msg.side, msg.price, msg.qty);
+        break;
+    case MsgType::Cancel:
+        book.cancel(msg.id);
+        break;
+    case MsgType::Execute:
+        book.execute(msg.id, msg.qty);
+        break;
+    }
+}
+
+// Untimed reference for the cross-check: per-side std::map levels and the
+// resting orders by id, with the same pool bound as the book.
+class ReferenceBook {
+public:
+    explicit ReferenceBook(std::size_t max_orders) : max_orders_(max_orders) {}
+
+    // False when the book should have refused the add for lack of space.
+    bool apply(const Message& msg) {
+        switch (msg.type) {
+        case MsgType::Add:
+            if (orders_.size() == max_orders_) {
+                return false;
+            }
+            orders_.emplace(msg.id, Resting{msg.side, msg.price, msg.qty});
+            add_level(msg.side, msg.price, msg.qty, 1);
+            return true;
+        case MsgType::Cancel:
+        case MsgType::Execute: {
+            auto it = orders_.find(msg.id);
+            if (it == orders_.end()) {
+                return true;
+            }
+            Resting& o = it->second;
+            const bool done = msg.type == MsgType::Cancel || msg.qty >= o.qty;
+            const FixedDouble qty = done ? o.qty : msg.qty;
+            add_level(o.side, o.price, FixedDouble::zero() - qty, done ? -1 : 0);
+            if (done) {
+                orders_.erase(it);
+            } else {
+                o.qty -= qty;
+            }
+            return true;
+        }
+        }
+        return true;
+    }
+
+    std::size_t order_count() const { return orders_.size(); }
+    std::size_t level_count(Side side) const { return levels(side).size(); }
+
+    std::optional<orderbook::LevelSummary> best(Side side) const {
+        const auto& l = levels(side);
+        if (l.empty()) {
+            return std::nullopt;
+        }
+        const auto it = side == Side::Buy ? std::prev(l.end()) : l.begin();
+        return orderbook::LevelSummary{it->first, it->second.qty, it->second.orders};
+    }
+
+private:
+    struct Resting {
+        Side side;
+        FixedDouble price;
+        FixedDouble qty;
+    };
+    struct Level {
+        FixedDouble qty;
+        std::size_t orders = 0;
+    };
+
+    const std::map<FixedDouble, Level>& levels(Side side) const { return side == Side::Buy ? bids_ : asks_; }
+
+    void add_level(Side side, FixedDouble price, FixedDouble qty, int orders) {
+        auto& l = side == Side::Buy ? bids_ : asks_;
+        Level& level = l[price];
+        level.qty += qty;
+        level.orders = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(level.orders) + orders);
+        if (level.orders == 0) {
+            l.erase(price);
+        }
+    }
+
+    std::size_t max_orders_;
+    std::unordered_map<std::uint64_t, Resting> orders_;
+    std::map<FixedDouble, Level> bids_;
+    std::map<FixedDouble, Level> asks_;
+};
+
+// Applies msgs to a book and the reference and compares order and level
+// counts and both touches after every message. Adds the book refuses with
+// overflow_error must be the ones the reference has no room for, and must
+// leave the book as it was. Throws std::runtime_error on a mismatch.
+void check_against_reference(const std::string& what, OrderBook& book, ReferenceBook& ref,
+                             const std::vector<Message>& msgs) {
+    auto fail = [&](std::size_t i, const std::string& why) {
+        throw std::runtime_error("order book disagrees with the reference on " + what + " at message " +
+                                 std::to_string(i) + ": " + why);
+    };
+    for (std::size_t i = 0; i < msgs.size(); ++i) {
+        bool applied = true;
+        try {
+            apply(book, msgs[i]);
+        } catch (const std::overflow_error&) {
+            applied = false;
+        }
+        if (ref.apply(msgs[i]) != applied) {
+            fail(i, applied ? "add accepted past the pool bound" : "add refused with room left");
+        }
+        if (book.order_count() != ref.order_count()) {
+            fail(i, "order count");
+        }
+        for (Side side : {Side::Buy, Side::Sell}) {
+            if (book.level_count(side) != ref.level_count(side)) {
+                fail(i, "level count");
+            }
+            const auto got = book.best(side);
+            const auto want = ref.best(side);
+            if (got.has_value() != want.has_value() ||
+                (got && (got->price != want->price || got->qty != want->qty || got->orders != want->orders))) {
+                fail(i, "best level");
+            }
+            if (got && book.front(side)->qty > got->qty) {
+                fail(i, "front order");
+            }
+        }
+    }
+}
+
+// The mix workload as generated, then random adds and cancels on a pool of
+// 16 orders so that adds regularly find it full.
+void check_book(const WorkloadConfig& cfg, const Workload& w) {
+    {
+        OrderBook book(2 * cfg.levels_per_side, max_orders(cfg));
+        ReferenceBook ref(max_orders(cfg));
+        check_against_reference("preload", book, ref, w.preload);
+        check_against_reference("mix", book, ref, w.steps);
+    }
+
+    constexpr std::size_t kPool = 16;
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<std::int64_t> tick_dist(1, static_cast<std::int64_t>(cfg.levels_per_side));
+    std::bernoulli_distribution coin(0.5);
+    std::vector<Message> msgs;
+    std::vector<std::uint64_t> ids;
+    for (std::uint64_t id = 1; id <= 4000; ++id) {
+        if (!ids.empty() && coin(rng)) {
+            const std::size_t pos = std::uniform_int_distribution<std::size_t>(0, ids.size() - 1)(rng);
+            msgs.push_back(Message{MsgType::Cancel, Side::Buy, ids[pos], FixedDouble::zero(), FixedDouble::zero()});
+            ids[pos] = ids.back();
+            ids.pop_back();
+        }
+        const Side side = coin(rng) ? Side::Buy : Side::Sell;
+        const FixedDouble offset = FixedDouble::from_raw(10) * tick_dist(rng);
+        const FixedDouble mid = FixedDouble::from_int(100);
+        msgs.push_back(Message{MsgType::Add, side, id, side == Side::Buy ? mid - offset : mid + offset,
+                               FixedDouble::from_int(1)});
+        ids.push_back(id);
+    }
+    OrderBook book(2 * cfg.levels_per_side, kPool);
+    ReferenceBook ref(kPool);
+    check_against_reference("full pool", book, ref, msgs);
+}
+
+BenchmarkResult bench_mix(const std::string& name, const WorkloadConfig& cfg, const Workload& w) {
+    OrderBook book(2 * cfg.levels_per_side, max_orders(cfg));
+    for (const auto& msg : w.preload) {
+        apply(book, msg);
+    }
+
+    std::uint64_t checksum = 0;
+    bench::OpTimer timer;
+    const auto start = std::chrono::steady_clock::now();
+    timer.start();
+    for (const auto& msg : w.steps) {
+        apply(book, msg);
+        // Feed handlers publish top of book after each message.
+        if (auto bid = book.best_bid()) {
+            checksum += static_cast<std::uint64_t>(bid->price.raw_value());
+        }
+        if (auto ask = book.best_ask()) {
+            checksum += static_cast<std::uint64_t>(ask->price.raw_value());
+        }
+        timer.lap();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    const double ns_per_op = (ms * 1e6) / static_cast<double>(w.steps.size());
+    g_sink = checksum;
+
+    return BenchmarkResult{name, w.steps.size(), book.order_count(), ms, ns_per_op, checksum, timer.take()};
+}
+
+// Writes a generated workload as an ITCH 5.0 capture of one instrument, one
+// message per microsecond from the open, so the replay path can run without a
+// real capture.
+void write_capture(const Workload& w, const std::string& path) {
+    itch::Writer out;
+    constexpr std::uint16_t locate = 1;
+    std::uint64_t ts = 34'200'000'000'000; // 09:30
+    auto write = [&](const Message& msg) {
+        const auto shares = static_cast<std::uint32_t>(msg.qty.to_int64());
+        switch (msg.type) {
+        case MsgType::Add:
+            out.add(locate, ts, msg.id, msg.side == Side::Buy ? 'B' : 'S', shares,
+                    static_cast<std::uint32_t>(msg.price.raw_value()) * kItchPerFixed);
+            break;
+        case MsgType::Cancel:
+            out.remove(locate, ts, msg.id);
+            break;
+        case MsgType::Execute:
+            out.execute(locate, ts, msg.id, shares);
+            break;
+        }
+        ts += 1000;
+    };
+    for (const auto& msg : w.preload) {
+        write(msg);
+    }
+    for (const auto& msg : w.steps) {
+        write(msg);
+    }
+    out.save(path);
+}
+
+// Decodes the mapped capture and applies the profiled instrument's messages,
+// reading top of book after each like bench_mix. Decoding is inside the
+// timed loop: it is part of what a feed handler pays per message.
+BenchmarkResult bench_replay(const std::string& name, const itch::MappedFile& file, const itch::Profile& prof) {
+    OrderBook book(std::max<std::size_t>(1, prof.prices), std::max<std::size_t>(1, prof.peak_orders));
+
+    std::uint64_t checksum = 0;
+    bench::OpTimer timer;
+    const auto start = std::chrono::steady_clock::now();
+    timer.start();
+    itch::for_each_event(file.data(), file.size(), [&](const itch::Event& e) {
+        if (e.locate != prof.locate) {
+            return;
+        }
+        orderbook::apply(book, e);
+        if (auto bid = book.best_bid()) {
+            checksum += static_cast<std::uint64_t>(bid->price.raw_value());
+        }
+        if (auto ask = book.best_ask()) {
+            checksum += static_cast<std::uint64_t>(ask->price.raw_value());
+        }
+        timer.lap();
+    });
+    const auto end = std::chrono::steady_clock::now();
+    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    const double ns_per_op = (ms * 1e6) / static_cast<double>(std::max<std::size_t>(1, prof.events));
+    g_sink = checksum;
+
+    return BenchmarkResult{name, prof.events, book.order_count(), ms, ns_per_op, checksum, timer.take()};
+}
+
+// Writes an ITCH capture of `instruments` books (locates 1..instruments)
+// whose activity is Zipf-distributed, as on a real feed where a few names
+// carry most of the messages. Each book hovers around `depth` resting orders
+// on 10 price levels a side; order ids are unique across the capture.
+void write_multi_capture(std::size_t instruments, std::size_t depth, std::size_t ops, const std::string& path) {
+    struct Resting {
+        std::uint64_t id;
+        std::uint32_t shares;
+    };
+    std::mt19937_64 rng(42);
+    std::vector<double> weights(instruments);
+    for (std::size_t i = 0; i < instruments; ++i) {
+        weights[i] = 1.0 / static_cast<double>(i + 1);
+    }
+    std::discrete_distribution<std::size_t> instrument_dist(weights.begin(), weights.end());
+    std::uniform_int_distribution<std::uint32_t> mid_dist(10, 200);
+    std::uniform_int_distribution<std::uint32_t> level_dist(1, 10);
+    std::uniform_int_distribution<std::uint32_t> shares_dist(1, 10);
+    std::uniform_real_distribution<double> op_dist(0.0, 1.0);
+    std::bernoulli_distribution side_dist(0.5);
+
+    constexpr std::uint32_t kDollar = itch::kPriceScale;
+    constexpr std::uint32_t kTick = itch::kPriceScale / 100;
+    std::vector<std::uint32_t> mids(instruments);
+    for (auto& mid : mids) {
+        mid = mid_dist(rng) * kDollar;
+    }
+    std::vector<std::vector<Resting>> live(instruments);
+    itch::Writer out;
+    std::uint64_t ts = 34'200'000'000'000; // 09:30
+    std::uint64_t next_id = 1;
+    for (std::size_t step = 0; step < ops; ++step, ts += 1000) {
+        const std::size_t i = instrument_dist(rng);
+        const auto locate = static_cast<std::uint16_t>(i + 1);
+        auto& orders = live[i];
+        if (orders.empty() || op_dist(rng) < (orders.size() < depth ? 0.55 : 0.45)) {
+            const char side = side_dist(rng) ? 'B' : 'S';
+            const std::uint32_t offset = level_dist(rng) * kTick;
+            const std::uint32_t shares = shares_dist(rng);
+            out.add(locate, ts, next_id, side, shares, side == 'B' ? mids[i] - offset : mids[i] + offset);
+            orders.push_back(Resting{next_id++, shares});
+            continue;
+        }
+        const std::size_t k = std::uniform_int_distribution<std::size_t>(0, orders.size() - 1)(rng);
+        if (op_dist(rng) < 0.3) {
+            out.execute(locate, ts, orders[k].id, orders[k].shares);
+        } else {
+            out.remove(locate, ts, orders[k].id);
+        }
+        orders[k] = orders.back();
+        orders.pop_back();
+    }
+    out.save(path);
+}
+
+// Dispatcher -> shard message: the decoded event and, in the sampled run,
+// the dispatcher's rdtsc when it was sent (0 otherwise).
+struct ShardMsg {
+    itch::Event event;
+    std::uint64_t tsc;
+};
+
+// Per-thread state of one shard: its books, a top-of-book checksum and the
+// dispatch-to-applied latency of sampled messages.
+struct BookShard {
+    orderbook::InstrumentBooks books;
+    std::uint64_t checksum = 0;
+    bench::LatencyHistogram latency{bench::ns_per_tick()};
+
+    void operator()(const ShardMsg& msg) {
+        OrderBook* book = books.find(msg.event.locate);
+        if (book == nullptr) {
+            return;
+        }
+        orderbook::apply(*book, msg.event);
+        if (auto bid = book->best_bid()) {
+            checksum += static_cast<std::uint64_t>(bid->price.raw_value());
+        }
+        if (auto ask = book->best_ask()) {
+            checksum += static_cast<std::uint64_t>(ask->price.raw_value());
+        }
+        if (msg.tsc != 0) {
+            const std::uint64_t now = bench::rdtscp();
+            latency.record(now > msg.tsc ? now - msg.tsc : 0);
+        }
+    }
+};
+
+// Decodes the capture on the calling thread and routes every book event to
+// the shard owning its instrument. Shard i's thread pins itself to
+// worker_cpus[i] when there is one. The clock stops once every shard has
+// drained its ring, so ns/msg is end-to-end throughput. Under ScopedSampling
+// every message is timestamped at dispatch.
+template <typename Wait>
+BenchmarkResult bench_sharded(const std::string& name, const itch::MappedFile& file,
+                              const std::vector<itch::Profile>& profiles, const std::vector<std::uint16_t>& shard_of,
+                              std::size_t shards, const std::vector<int>& worker_cpus) {
+    const bool sample = bench::ops_per_sample() != 0;
+    orderbook::Shards<ShardMsg, BookShard, Wait> workers(shards, 4 * 1024, [&](std::size_t i) {
+        if (i < worker_cpus.size()) {
+            bench::pin_this_thread(worker_cpus[i]);
+        }
+        return BookShard{orderbook::InstrumentBooks(profiles, shard_of, static_cast<std::uint16_t>(i))};
+    });
+
+    std::size_t events = 0;
+    const auto start = std::chrono::steady_clock::now();
+    itch::for_each_event(file.data(), file.size(), [&](const itch::Event& e) {
+        if (profiles[e.locate].adds == 0) {
+            return;
+        }
+        workers.send(shard_of[e.locate], ShardMsg{e, sample ? bench::rdtsc() : 0});
+        ++events;
+    });
+    workers.finish();
+    const auto end = std::chrono::steady_clock::now();
+
+    BenchmarkResult r;
+    r.name = name;
+    r.operations = events;
+    r.ms = std::chrono::duration<double, std::milli>(end - start).count();
+    r.ns_per_op = (r.ms * 1e6) / static_cast<double>(std::max<std::size_t>(1, events));
+    r.latency = bench::LatencyHistogram(bench::ns_per_tick());
+    for (std::size_t i = 0; i < shards; ++i) {
+        BookShard& shard = workers.worker(i);
+        r.final_orders += shard.books.order_count();
+        r.checksum += shard.checksum;
+        r.latency.merge(shard.latency);
+    }
+    g_sink = r.checksum;
+    return r;
+}
+
+// Aggregated price level of a market-by-price view.
+struct LevelQty {
+    FixedDouble qty;
+    std::uint32_t updates = 0;
+};
+
+enum class LevelOp : std::uint8_t { Add, Remove, Update };
+
+struct LevelMsg {
+    LevelOp op;
+    FixedDouble price;
+    FixedDouble qty; // new level quantity for Add and Update
+};
+
+struct LevelStream {
+    std::vector<LevelMsg> preload;
+    std::vector<LevelMsg> steps;
+};
+
+constexpr std::int64_t kLevelTickRaw = 10; // 0.01
+
+// Market-by-price stream of one bid side hovering around `levels` levels:
+// half the messages change the quantity of one of the top 10 levels, the rest
+// add levels a few ticks around the touch or remove ones at or just behind
+// it, so the best price wanders. 5% of adds land 20 to 200 dollars below the
+// touch, as stale far orders do.
+LevelStream make_level_stream(std::size_t levels, std::size_t ops) {
+    const FixedDouble tick = FixedDouble::from_raw(kLevelTickRaw);
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> op_dist(0.0, 1.0);
+    std::uniform_int_distribution<std::int64_t> qty_dist(1, 100);
+    std::uniform_int_distribution<std::int64_t> near_dist(-8, 2);
+    std::uniform_int_distribution<std::int64_t> far_dist(2'000, 20'000);
+    std::uniform_int_distribution<std::size_t> top_dist(0, 9);
+
+    std::set<std::int64_t, std::greater<>> book; // ticks, best first
+    auto nth = [&](std::size_t k) { return std::next(book.begin(), std::min(k, book.size() - 1)); };
+    auto try_add = [&](std::vector<LevelMsg>& out) {
+        const std::int64_t best = book.empty() ? 100'000 : *book.begin(); // 1000.00
+        const std::int64_t t = op_dist(rng) < 0.05 ? best - far_dist(rng) : best + near_dist(rng);
+        if (book.insert(t).second) {
+            out.push_back(LevelMsg{LevelOp::Add, tick * t, FixedDouble::from_int(qty_dist(rng))});
+        }
+    };
+
+    LevelStream s;
+    while (book.size() < levels) {
+        try_add(s.preload);
+    }
+    s.steps.reserve(ops);
+    while (s.steps.size() < ops) {
+        const double r = op_dist(rng);
+        const double add_ratio = book.size() < levels ? 0.3 : 0.2;
+        if (book.empty() || r < add_ratio) {
+            try_add(s.steps);
+        } else if (r < 0.5) {
+            const auto it = op_dist(rng) < 0.8
+                                ? nth(top_dist(rng) / 3)
+                                : nth(std::uniform_int_distribution<std::size_t>(0, book.size() - 1)(rng));
+            s.steps.push_back(LevelMsg{LevelOp::Remove, tick * *it, FixedDouble::zero()});
+            book.erase(it);
+        } else {
+            s.steps.push_back(LevelMsg{LevelOp::Update, tick * *nth(top_dist(rng)), FixedDouble::from_int(qty_dist(rng))});
+        }
+    }
+    return s;
+}
+
+// Bid levels in a std::map keyed by price, best first.
+struct MapLevels {
+    std::map<FixedDouble, LevelQty, std::greater<FixedDouble>> levels;
+
+    void apply(const LevelMsg& m) {
+        switch (m.op) {
+        case LevelOp::Add:
+            levels.emplace(m.price, LevelQty{m.qty, 0});
+            break;
+        case LevelOp::Remove:
+            levels.erase(m.price);
+            break;
+        case LevelOp::Update: {
+            LevelQty& level = levels.find(m.price)->second;
+            level.qty = m.qty;
+            ++level.updates;
+            break;
+        }
+        }
+    }
+
+    std::size_t size() const { return levels.size(); }
+
+    template <typename Fn>
+    void walk(std::size_t n, Fn&& fn) const {
+        for (auto it = levels.begin(); it != levels.end() && n-- > 0; ++it) {
+            fn(it->first, it->second);
+        }
+    }
+};
+
+// The same levels in a PriceLadder, prices converted to ticks on the way in
+// and back on the way out.
+struct LadderLevels {
+    ticks::Grid<ticks::TickPrice> grid{FixedDouble::from_raw(kLevelTickRaw)};
+    orderbook::PriceLadder<LevelQty> levels;
+
+    explicit LadderLevels(std::size_t window) : levels(Side::Buy, window) {}
+
+    void apply(const LevelMsg& m) {
+        const std::int64_t t = grid.to_units(m.price).count();
+        switch (m.op) {
+        case LevelOp::Add:
+            *levels.try_emplace(t).first = LevelQty{m.qty, 0};
+            break;
+        case LevelOp::Remove:
+            levels.erase(t);
+            break;
+        case LevelOp::Update: {
+            LevelQty& level = *levels.find(t);
+            level.qty = m.qty;
+            ++level.updates;
+            break;
+        }
+        }
+    }
+
+    std::size_t size() const { return levels.size(); }
+
+    template <typename Fn>
+    void walk(std::size_t n, Fn&& fn) {
+        levels.walk(n, [&](std::int64_t t, const LevelQty& level) { fn(grid.to_fixed(ticks::TickPrice(t)), level); });
+    }
+};
+
+// Applies the stream and, after every message, reads the top `depth` levels
+// (1: top of book; 10: the depth snapshot a strategy or feed publishes).
+template <typename Levels>
+BenchmarkResult bench_levels(const std::string& name, Levels levels, const LevelStream& s, std::size_t depth) {
+    for (const auto& msg : s.preload) {
+        levels.apply(msg);
+    }
+
+    std::uint64_t checksum = 0;
+    bench::OpTimer timer;
+    const auto start = std::chrono::steady_clock::now();
+    timer.start();
+    for (const auto& msg : s.steps) {
+        levels.apply(msg);
+        levels.walk(depth, [&](FixedDouble price, const LevelQty& level) {
+            checksum += static_cast<std::uint64_t>(price.raw_value() + level.qty.raw_value());
+        });
+        timer.lap();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    const double ns_per_op = (ms * 1e6) / static_cast<double>(s.steps.size());
+    g_sink = checksum;
+
+    return BenchmarkResult{name, s.steps.size(), levels.size(), ms, ns_per_op, checksum, timer.take()};
+}
+
+struct RunSummary {
+    BenchmarkResult best;
+    BenchmarkResult worst;
+    bench::LatencyHistogram latency;
+    bench::Interference interference; // over all runs, sampled one included
+};
+
+// Wall-clock best/worst over `runs` unsampled runs, then one extra run with a
+// timestamp per message for the latency distribution.
+template <typename Fn>
+RunSummary run_best_and_worst(std::size_t runs, Fn&& fn) {
+    RunSummary summary;
+    const bench::Interference before = bench::interference_now();
+    summary.best.ms = std::numeric_limits<double>::max();
+    summary.worst.ms = 0.0;
+    for (std::size_t i = 0; i < runs; ++i) {
+        auto r = fn();
+        if (r.ms < summary.best.ms) {
+            summary.best = r;
+        }
+        if (r.ms > summary.worst.ms) {
+            summary.worst = r;
+        }
+    }
+    bench::ScopedSampling sampling(1);
+    summary.latency = fn().latency;
+    summary.interference = bench::interference_now() - before;
+    return summary;
+}
+
+int main(int argc, char** argv) {
+    bench::Options opts;
+    try {
+        opts = bench::parse_options(argc, argv);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n" << bench::usage();
+        return 2;
+    }
+    if (opts.help) {
+        std::cout << "scenarios: mix, replay, sharded, levels\n"
+                  << "sizes: resting depth of the mix (default 4k); iters: mix messages (default 500000); "
+                     "reps: runs per case (default 5)\n"
+                  << "replay: --replay=FILE, or a capture written from the 10 levels/side mix\n"
+                  << "sharded: --replay=FILE, or a 256-instrument capture; 1, 2, 4, ... shards, one per allowed "
+                     "CPU besides the dispatcher's (--cpu=N, default the last allowed CPU)\n"
+                  << "levels: one bid side of 64 and 1024 price levels, std::map vs a 4096-tick price ladder, "
+                     "reading top of book or the top 10 after each of iters messages\n"
+                  << bench::usage();
+        return 0;
+    }
+
+    const std::size_t ops = opts.iters_or(500'000);
+    const std::size_t runs_per_case = opts.reps_or(5);
+    const double add_ratio = 0.5;
+    const double execute_ratio = 0.15;
+
+    try {
+        // Sharded placement is chosen before setup_runner pins the main thread.
+        const std::vector<int> cpus = bench::allowed_cpus();
+        bench::Reporter report(opts);
+        bench::setup_runner(opts, report);
+        std::ostream& out = report.text();
+
+        std::string scenario;
+        auto print = [&](const RunSummary& r, std::size_t size) {
+            report.add(bench::Record{scenario, r.best.name, size, r.best.operations, runs_per_case, r.best.ns_per_op,
+                                     r.worst.ns_per_op, r.latency.summary(), r.interference.ctx_switches,
+                                     r.interference.page_faults});
+            out << "  " << r.best.name << "\n"
+                << "    final orders: " << r.best.final_orders << "\n"
+                << "    time:         " << r.best.ms << " ms best, " << r.worst.ms << " ms worst\n"
+                << "    ns/op:        " << r.best.ns_per_op << " best, " << r.worst.ns_per_op << " worst\n"
+                << "    latency:      " << r.latency.summary() << "\n";
+        };
+
+        bench::print_timer_info(out);
+
+        const std::vector<std::size_t> depths = opts.sizes_or({4 * 1024});
+        if (opts.selected("mix")) {
+            scenario = "mix";
+            for (std::size_t depth : depths) {
+                out << "Add/cancel/execute mix (" << ops << " msgs, " << add_ratio * 100 << "% add, "
+                    << execute_ratio * 100 << "% execute, depth ~" << depth << ", best/worst of " << runs_per_case
+                    << ")\n";
+                for (std::size_t levels : {1, 10, 100}) {
+                    const WorkloadConfig cfg{levels, depth, ops, add_ratio, execute_ratio};
+                    const Workload w = make_workload(cfg);
+                    check_book(cfg, w);
+                    const std::string name = "book " + std::to_string(levels) + " levels/side";
+                    print(run_best_and_worst(runs_per_case, [&] { return bench_mix(name, cfg, w); }), depth);
+                }
+                out << "\n";
+            }
+        }
+
+        if (opts.selected("replay")) {
+            scenario = "replay";
+            std::string path = opts.replay;
+            if (path.empty()) {
+                path = (std::filesystem::temp_directory_path() /
+                        ("order_book_replay_" + std::to_string(::getpid()) + ".itch"))
+                           .string();
+                write_capture(make_workload(WorkloadConfig{10, depths.front(), ops, add_ratio, execute_ratio}), path);
+            }
+            const itch::MappedFile file(path);
+            if (opts.replay.empty()) {
+                std::remove(path.c_str()); // the mapping stays valid
+            }
+            const itch::Profile prof = itch::profile(file.data(), file.size());
+            out << "ITCH replay (" << (opts.replay.empty() ? "synthetic 10 levels/side mix" : opts.replay) << ", "
+                << file.size() << " bytes, locate " << prof.locate << ": " << prof.events << " book msgs, peak "
+                << prof.peak_orders << " orders, " << prof.prices << " prices, best/worst of " << runs_per_case
+                << ")\n";
+            print(run_best_and_worst(runs_per_case, [&] { return bench_replay("book replay", file, prof); }),
+                  prof.peak_orders);
+            out << "\n";
+        }
+
+        if (opts.selected("sharded")) {
+            scenario = "sharded";
+            const std::size_t instruments = 256;
+            std::string path = opts.replay;
+            if (path.empty()) {
+                path = (std::filesystem::temp_directory_path() /
+                        ("order_book_sharded_" + std::to_string(::getpid()) + ".itch"))
+                           .string();
+                write_multi_capture(instruments, 256, ops, path);
+            }
+            const itch::MappedFile file(path);
+            if (opts.replay.empty()) {
+                std::remove(path.c_str());
+            }
+            const std::vector<itch::Profile> profiles = itch::profile_all(file.data(), file.size());
+
+            // The dispatcher keeps its CPU; each shard gets one of the others.
+            const int dispatcher = opts.cpu >= 0 ? opts.cpu : (cpus.empty() ? -1 : cpus.back());
+            if (opts.cpu < 0 && dispatcher >= 0 && !bench::pin_this_thread(dispatcher)) {
+                throw std::runtime_error("cannot pin the dispatcher to cpu " + std::to_string(dispatcher));
+            }
+            std::vector<int> worker_cpus;
+            for (auto it = cpus.rbegin(); it != cpus.rend(); ++it) {
+                if (*it != dispatcher) {
+                    worker_cpus.push_back(*it);
+                }
+            }
+            std::vector<std::size_t> shard_counts;
+            const std::size_t max_shards = worker_cpus.empty() ? 4 : worker_cpus.size();
+            for (std::size_t n = 1; n <= max_shards; n *= 2) {
+                shard_counts.push_back(n);
+            }
+            if (shard_counts.back() != max_shards) {
+                shard_counts.push_back(max_shards);
+            }
+
+            std::size_t books = 0;
+            std::size_t events = 0;
+            for (const auto& p : profiles) {
+                books += p.adds != 0 ? 1 : 0;
+                events += p.adds != 0 ? p.events : 0;
+            }
+            out << "Sharded replay (" << (opts.replay.empty() ? "synthetic Zipf capture" : opts.replay) << ", "
+                << books << " books, " << events << " book msgs, dispatcher on cpu " << dispatcher
+                << ", best/worst of " << runs_per_case << "; latency is dispatch to applied, queueing included)\n";
+            if (worker_cpus.empty()) {
+                out << "single CPU: dispatcher and shards share it and yield to each other, so this measures "
+                       "the scheduler, not scaling\n";
+            }
+
+            std::size_t expected_orders = 0;
+            for (std::size_t shards : shard_counts) {
+                const std::string name = std::to_string(shards) + (shards == 1 ? " shard" : " shards");
+                const std::vector<std::uint16_t> shard_of = orderbook::assign_shards(profiles, shards);
+                auto run = [&] {
+                    return worker_cpus.empty()
+                               ? bench_sharded<spsc::YieldWait>(name, file, profiles, shard_of, shards, worker_cpus)
+                               : bench_sharded<spsc::BusyPoll>(name, file, profiles, shard_of, shards, worker_cpus);
+                };
+                const RunSummary r = run_best_and_worst(runs_per_case, run);
+                if (shards == shard_counts.front()) {
+                    expected_orders = r.best.final_orders;
+                } else if (r.best.final_orders != expected_orders) {
+                    throw std::runtime_error("sharded books disagree: " + std::to_string(r.best.final_orders) +
+                                             " resting orders with " + name + ", " +
+                                             std::to_string(expected_orders) + " with 1 shard");
+                }
+                print(r, shards);
+                out << "    throughput:   " << 1e3 / r.best.ns_per_op << " Mmsg/s best\n";
+            }
+            out << "\n";
+        }
+        if (opts.selected("levels")) {
+            scenario = "levels";
+            constexpr std::size_t kWindow = 4096;
+            for (std::size_t levels : {64, 1024}) {
+                const LevelStream stream = make_level_stream(levels, ops);
+                out << "Price levels (" << ops << " msgs on one side, ~" << levels
+                    << " levels, 50% top-10 qty updates, ladder window " << kWindow << " ticks, best/worst of "
+                    << runs_per_case << ")\n";
+                for (std::size_t depth : {1, 10}) {
+                    const std::string what = depth == 1 ? " top of book" : " top-10 walk";
+                    const RunSummary map = run_best_and_worst(
+                        runs_per_case, [&] { return bench_levels("std::map" + what, MapLevels{}, stream, depth); });
+                    const RunSummary ladder = run_best_and_worst(runs_per_case, [&] {
+                        return bench_levels("ladder" + what, LadderLevels(kWindow), stream, depth);
+                    });
+                    if (ladder.best.checksum != map.best.checksum || ladder.best.final_orders != map.best.final_orders) {
+                        throw std::runtime_error("price ladder disagrees with std::map on" + what);
+                    }
+                    print(map, levels);
+                    print(ladder, levels);
+                }
+                out << "\n";
+            }
+        }
+        report.finish();
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "../arr-list/array_linked_list_pool.hpp"
+#include "../arr-list/order_index.hpp"
+#include "../double/fixed_double.hpp"
+
+namespace orderbook {
+
+enum class Side : std::uint8_t { Buy, Sell };
+
+// Resting order as stored inside a price level queue. Price and side live on
+// the level, so the queue node only carries what a fill or cancel touches.
+struct Order {
+    std::uint64_t id = 0;
+    FixedDouble qty;
+};
+
+struct LevelSummary {
+    FixedDouble price;
+    FixedDouble qty;
+    std::size_t orders = 0;
+};
+
+// L3 (order-by-order) book. Each price level is a FIFO queue keyed on
+// FixedDouble::raw_value(), so level keys are exact integers. Level queues take
+// their nodes from one shared arrlist_pool::NodePool, so memory is bounded by
+// resting orders rather than levels x worst-case depth. Orders are found by id
+// through an arrlist::OrderIndex holding the list handle, which makes
+// add/cancel/modify/execute O(1) apart from creating or retiring a level.
+//
+// Each side keeps its active prices in a vector sorted so that the best price
+// sits at the back: best bid/ask is a single load, and levels appearing or
+// disappearing near the touch only shift a handful of elements.
+class OrderBook {
+public:
+    using List = arrlist_pool::ArrayLinkedList<Order>;
+    using Pool = List::Pool;
+    using NodeHandle = List::NodeHandle;
+    using PriceKey = FixedDouble::storage_type;
+
+    OrderBook(std::size_t max_levels, std::size_t max_orders)
+        : max_levels_(max_levels), pool_(std::make_unique<Pool>(max_orders)), orders_(max_orders) {
+        if (max_levels == 0) {
+            throw std::invalid_argument("max_levels must be greater than zero");
+        }
+        levels_.reserve(max_levels);
+        free_levels_.reserve(max_levels);
+        bids_.prices.reserve(max_levels);
+        asks_.prices.reserve(max_levels);
+    }
+
+    std::size_t order_count() const { return orders_.size(); }
+    std::size_t level_count(Side side) const { return side_of(side).prices.size(); }
+
+    // Adds a new resting order at the back of its price level. The node pool
+    // is checked before a level is created, so a full book throws with no
+    // empty level left behind.
+    void add(std::uint64_t id, Side side, FixedDouble price, FixedDouble qty) {
+        if (orders_.contains(id)) {
+            throw std::invalid_argument("duplicate order id");
+        }
+        if (pool_->available() == 0) {
+            throw std::overflow_error("no free order slots left in the book");
+        }
+        const std::uint32_t slot = find_or_create_level(side, price.raw_value());
+        Level& level = levels_[slot];
+        const NodeHandle handle = level.orders.emplace_back(Order{id, qty});
+        level.total_qty += qty;
+        orders_.insert(id, OrderRef{handle, slot, side});
+    }
+
+    // Removes an order. Returns false when the id is unknown.
+    bool cancel(std::uint64_t id) {
+        OrderRef ref;
+        if (!orders_.take(id, ref)) {
+            return false;
+        }
+        remove_from_level(ref);
+        return true;
+    }
+
+    // Changes price and/or quantity. A quantity reduction at the same price is
+    // applied in place and keeps queue priority; anything else re-queues the
+    // order at the back of its (possibly new) level by relinking its node.
+    bool modify(std::uint64_t id, FixedDouble new_price, FixedDouble new_qty) {
+        OrderRef* found = orders_.find(id);
+        if (found == nullptr) {
+            return false;
+        }
+        OrderRef& ref = *found;
+        Level& level = levels_[ref.level];
+        Order& order = level.orders.value(ref.handle);
+        if (new_price.raw_value() == level.price && new_qty <= order.qty) {
+            level.total_qty -= order.qty - new_qty;
+            order.qty = new_qty;
+            return true;
+        }
+        const Side side = ref.side;
+        if (new_price.raw_value() == level.price) {
+            // Size increase: back of the same queue, node and handle kept.
+            level.total_qty += new_qty - order.qty;
+            order.qty = new_qty;
+            level.orders.move_to_back(ref.handle);
+            return true;
+        }
+        if (level.orders.size() == 1) {
+            // The old level retires first, so its slot can take the new price.
+            remove_from_level(ref);
+            const std::uint32_t slot = find_or_create_level(side, new_price.raw_value());
+            Level& target = levels_[slot];
+            ref.handle = target.orders.emplace_back(Order{id, new_qty});
+            ref.level = slot;
+            target.total_qty += new_qty;
+            return true;
+        }
+        // New price: splice the node onto the new level's queue. The level is
+        // found or created before anything changes, so running out of levels
+        // throws with the order still as it was.
+        const std::uint32_t from = ref.level;
+        const std::uint32_t slot = find_or_create_level(side, new_price.raw_value());
+        levels_[from].total_qty -= order.qty;
+        order.qty = new_qty;
+        levels_[slot].orders.splice(levels_[from].orders, ref.handle);
+        levels_[slot].total_qty += new_qty;
+        ref.level = slot;
+        return true;
+    }
+
+    // Replaces an order with a new id at a new price and quantity on the same
+    // side, always re-queued at the back (ITCH "U"). Returns false when the old
+    // id is unknown.
+    bool replace(std::uint64_t id, std::uint64_t new_id, FixedDouble new_price, FixedDouble new_qty) {
+        const OrderRef* found = orders_.find(id);
+        if (found == nullptr) {
+            return false;
+        }
+        if (new_id != id && orders_.contains(new_id)) {
+            throw std::invalid_argument("duplicate order id");
+        }
+        const OrderRef ref = *found;
+        if (levels_[ref.level].orders.size() == 1) {
+            // The old level retires first, so its slot can take the new price.
+            orders_.erase(id);
+            remove_from_level(ref);
+            add(new_id, ref.side, new_price, new_qty);
+            return true;
+        }
+        // The old level stays: find or create the new one before anything
+        // changes, so running out of levels throws with the old order resting.
+        const std::uint32_t slot = find_or_create_level(ref.side, new_price.raw_value());
+        orders_.erase(id);
+        remove_from_level(ref);
+        Level& target = levels_[slot];
+        const NodeHandle handle = target.orders.emplace_back(Order{new_id, new_qty});
+        target.total_qty += new_qty;
+        orders_.insert(new_id, OrderRef{handle, slot, ref.side});
+        return true;
+    }
+
+    // Applies a fill against a resting order; the order is removed once its
+    // remaining quantity reaches zero. Returns false when the id is unknown.
+    bool execute(std::uint64_t id, FixedDouble qty) {
+        const OrderRef* found = orders_.find(id);
+        if (found == nullptr) {
+            return false;
+        }
+        const OrderRef ref = *found;
+        Level& level = levels_[ref.level];
+        Order& order = level.orders.value(ref.handle);
+        if (qty < order.qty) {
+            order.qty -= qty;
+            level.total_qty -= qty;
+            return true;
+        }
+        orders_.erase(id);
+        remove_from_level(ref);
+        return true;
+    }
+
+    std::optional<LevelSummary> best_bid() const { return best(Side::Buy); }
+    std::optional<LevelSummary> best_ask() const { return best(Side::Sell); }
+
+    std::optional<LevelSummary> best(Side side) const {
+        const BookSide& s = side_of(side);
+        if (s.prices.empty()) {
+            return std::nullopt;
+        }
+        const Level& level = levels_[s.prices.back().level];
+        return LevelSummary{FixedDouble::from_raw(level.price), level.total_qty, level.orders.size()};
+    }
+
+    // Order at the head of the best level on the given side, i.e. the next one
+    // an aggressor would trade against.
+    std::optional<Order> front(Side side) const {
+        const BookSide& s = side_of(side);
+        if (s.prices.empty()) {
+            return std::nullopt;
+        }
+        const List& orders = levels_[s.prices.back().level].orders;
+        return orders.value_unchecked(orders.head_index_unchecked());
+    }
+
+private:
+    struct Level {
+        explicit Level(Pool& pool) : orders(pool) {}
+
+        PriceKey price = 0;
+        FixedDouble total_qty;
+        List orders;
+    };
+
+    struct OrderRef {
+        NodeHandle handle;
+        std::uint32_t level;
+        Side side;
+    };
+
+    struct PriceRef {
+        PriceKey price;
+        std::uint32_t level;
+    };
+
+    // Bids are sorted ascending and asks descending so the touch is always
+    // prices.back().
+    struct BookSide {
+        std::vector<PriceRef> prices;
+        std::unordered_map<PriceKey, std::uint32_t> levels;
+    };
+
+    BookSide& side_of(Side side) { return side == Side::Buy ? bids_ : asks_; }
+    const BookSide& side_of(Side side) const { return side == Side::Buy ? bids_ : asks_; }
+
+    static bool worse(Side side, PriceKey a, PriceKey b) { return side == Side::Buy ? a < b : a > b; }
+
+    // Position of price in the sorted vector. Searches backwards from the
+    // touch because most activity happens in the first few levels.
+    static std::vector<PriceRef>::iterator position_of(std::vector<PriceRef>& prices, Side side, PriceKey price) {
+        auto it = prices.end();
+        while (it != prices.begin() && worse(side, price, (it - 1)->price)) {
+            --it;
+        }
+        return it;
+    }
+
+    std::uint32_t find_or_create_level(Side side, PriceKey price) {
+        BookSide& s = side_of(side);
+        auto found = s.levels.find(price);
+        if (found != s.levels.end()) {
+            return found->second;
+        }
+
+        std::uint32_t slot;
+        if (!free_levels_.empty()) {
+            slot = free_levels_.back();
+            free_levels_.pop_back();
+        } else if (levels_.size() < max_levels_) {
+            slot = static_cast<std::uint32_t>(levels_.size());
+            levels_.emplace_back(*pool_);
+        } else {
+            throw std::overflow_error("no free price levels left in the book");
+        }
+
+        Level& level = levels_[slot];
+        level.price = price;
+        level.total_qty = FixedDouble::zero();
+        s.prices.insert(position_of(s.prices, side, price), PriceRef{price, slot});
+        s.levels.emplace(price, slot);
+        return slot;
+    }
+
+    void remove_from_level(const OrderRef& ref) {
+        Level& level = levels_[ref.level];
+        level.total_qty -= level.orders.value(ref.handle).qty;
+        level.orders.erase(ref.handle);
+        if (!level.orders.empty()) {
+            return;
+        }
+
+        BookSide& s = side_of(ref.side);
+        s.levels.erase(level.price);
+        // position_of lands just past the matching entry.
+        auto it = position_of(s.prices, ref.side, level.price);
+        s.prices.erase(it - 1);
+        free_levels_.push_back(ref.level);
+    }
+
+    std::size_t max_levels_;
+    // Heap-allocated so level lists keep a stable pool address if the book moves.
+    std::unique_ptr<Pool> pool_;
+    std::vector<Level> levels_;
+    std::vector<std::uint32_t> free_levels_;
+    arrlist::OrderIndex<OrderRef> orders_;
+    BookSide bids_;
+    BookSide asks_;
+};
+
+} // namespace orderbook
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "order_book.hpp"
+
+namespace orderbook {
+
+// Price levels of one book side keyed by tick index (price / tick size, see
+// ticks::Grid in ../double/tick_price.hpp), for best-price lookups and top-N
+// walks without a tree. A flat window of ticks around the touch holds the
+// levels in place, indexed by tick - base, with a two-level occupancy bitmap:
+// one bit per tick and one summary bit per 64-tick word. The best level is a
+// leading/trailing-zero count on a summary word and on one bitmap word, and
+// walking the next levels skips empty ticks 64 (or 4096) at a time.
+//
+// Levels outside the window spill to a std::map. The window re-centres on
+// the touch when a better price arrives beyond it, or when it empties while
+// spilled levels remain, so the best level is always in the window and every
+// spilled level is worse than every windowed one: walks read the window
+// first, then the map in price order.
+template <typename Value>
+class PriceLadder {
+public:
+    static constexpr std::int64_t kNoTick = std::numeric_limits<std::int64_t>::min();
+
+    // window is rounded up to a power of two, at least 64 ticks.
+    PriceLadder(Side side, std::size_t window) : side_(side), window_(round_window(window)) {
+        values_.resize(window_);
+        bits_.assign(window_ / 64, 0);
+        summary_.assign((bits_.size() + 63) / 64, 0);
+    }
+
+    Side side() const { return side_; }
+    std::size_t window() const { return window_; }
+    std::size_t size() const { return in_window_ + spill_.size(); }
+    std::size_t spilled() const { return spill_.size(); }
+    bool empty() const { return size() == 0; }
+
+    Value* find(std::int64_t tick) {
+        const std::size_t slot = slot_of(tick);
+        if (slot != kNone) {
+            return test(slot) ? &values_[slot] : nullptr;
+        }
+        auto it = spill_.find(tick);
+        return it == spill_.end() ? nullptr : &it->second;
+    }
+
+    // Level at tick, value-initialised when new; second tells which.
+    std::pair<Value*, bool> try_emplace(std::int64_t tick) {
+        if (empty()) {
+            base_ = tick - static_cast<std::int64_t>(window_ / 2);
+        } else if (slot_of(tick) == kNone && better(tick, best_tick())) {
+            recentre(tick);
+        }
+        const std::size_t slot = slot_of(tick);
+        if (slot == kNone) {
+            auto inserted = spill_.try_emplace(tick);
+            return {&inserted.first->second, inserted.second};
+        }
+        if (test(slot)) {
+            return {&values_[slot], false};
+        }
+        set(slot);
+        ++in_window_;
+        values_[slot] = Value{};
+        return {&values_[slot], true};
+    }
+
+    bool erase(std::int64_t tick) {
+        const std::size_t slot = slot_of(tick);
+        if (slot == kNone) {
+            return spill_.erase(tick) != 0;
+        }
+        if (!test(slot)) {
+            return false;
+        }
+        clear(slot);
+        --in_window_;
+        if (in_window_ == 0 && !spill_.empty()) {
+            recentre(side_ == Side::Buy ? spill_.rbegin()->first : spill_.begin()->first);
+        }
+        return true;
+    }
+
+    // Tick of the best level, kNoTick when empty.
+    std::int64_t best_tick() const {
+        const std::size_t slot = best_slot();
+        return slot == kNone ? kNoTick : base_ + static_cast<std::int64_t>(slot);
+    }
+
+    Value* best() {
+        const std::size_t slot = best_slot();
+        return slot == kNone ? nullptr : &values_[slot];
+    }
+
+    // Calls fn(tick, value) for up to n levels from the best outwards and
+    // returns how many it visited.
+    template <typename Fn>
+    std::size_t walk(std::size_t n, Fn&& fn) {
+        std::size_t visited = 0;
+        for (std::size_t slot = n == 0 ? kNone : best_slot(); slot != kNone; slot = next_worse(slot)) {
+            fn(base_ + static_cast<std::int64_t>(slot), values_[slot]);
+            if (++visited == n) {
+                return visited;
+            }
+        }
+        if (side_ == Side::Buy) {
+            for (auto it = spill_.rbegin(); it != spill_.rend() && visited < n; ++it, ++visited) {
+                fn(it->first, it->second);
+            }
+        } else {
+            for (auto it = spill_.begin(); it != spill_.end() && visited < n; ++it, ++visited) {
+                fn(it->first, it->second);
+            }
+        }
+        return visited;
+    }
+
+private:
+    static constexpr std::size_t kNone = static_cast<std::size_t>(-1);
+
+    static std::size_t round_window(std::size_t window) {
+        if (window > (std::size_t{1} << 30)) {
+            throw std::invalid_argument("price ladder window is too large");
+        }
+        std::size_t w = 64;
+        while (w < window) {
+            w *= 2;
+        }
+        return w;
+    }
+
+    bool better(std::int64_t a, std::int64_t b) const { return side_ == Side::Buy ? a > b : a < b; }
+
+    std::size_t slot_of(std::int64_t tick) const {
+        const auto offset = static_cast<std::uint64_t>(tick) - static_cast<std::uint64_t>(base_);
+        return offset < window_ ? static_cast<std::size_t>(offset) : kNone;
+    }
+
+    bool test(std::size_t slot) const { return (bits_[slot >> 6] >> (slot & 63)) & 1; }
+
+    void set(std::size_t slot) {
+        bits_[slot >> 6] |= std::uint64_t{1} << (slot & 63);
+        summary_[slot >> 12] |= std::uint64_t{1} << ((slot >> 6) & 63);
+    }
+
+    void clear(std::size_t slot) {
+        const std::size_t word = slot >> 6;
+        bits_[word] &= ~(std::uint64_t{1} << (slot & 63));
+        if (bits_[word] == 0) {
+            summary_[word >> 6] &= ~(std::uint64_t{1} << (word & 63));
+        }
+    }
+
+    static unsigned highest(std::uint64_t x) { return 63u - static_cast<unsigned>(__builtin_clzll(x)); }
+    static unsigned lowest(std::uint64_t x) { return static_cast<unsigned>(__builtin_ctzll(x)); }
+
+    // Highest occupied slot <= slot.
+    std::size_t highest_at_or_below(std::size_t slot) const {
+        std::size_t word = slot >> 6;
+        const unsigned bit = slot & 63;
+        const std::uint64_t below = bit == 63 ? ~std::uint64_t{0} : (std::uint64_t{1} << (bit + 1)) - 1;
+        if (const std::uint64_t m = bits_[word] & below) {
+            return (word << 6) + highest(m);
+        }
+        std::size_t s = word >> 6;
+        std::uint64_t m = summary_[s] & ((std::uint64_t{1} << (word & 63)) - 1);
+        while (m == 0) {
+            if (s == 0) {
+                return kNone;
+            }
+            m = summary_[--s];
+        }
+        word = (s << 6) + highest(m);
+        return (word << 6) + highest(bits_[word]);
+    }
+
+    // Lowest occupied slot >= slot.
+    std::size_t lowest_at_or_above(std::size_t slot) const {
+        std::size_t word = slot >> 6;
+        if (const std::uint64_t m = bits_[word] & (~std::uint64_t{0} << (slot & 63))) {
+            return (word << 6) + lowest(m);
+        }
+        std::size_t s = word >> 6;
+        std::uint64_t m = (word & 63) == 63 ? 0 : summary_[s] & (~std::uint64_t{0} << ((word & 63) + 1));
+        while (m == 0) {
+            if (++s == summary_.size()) {
+                return kNone;
+            }
+            m = summary_[s];
+        }
+        word = (s << 6) + lowest(m);
+        return (word << 6) + lowest(bits_[word]);
+    }
+
+    std::size_t best_slot() const {
+        if (in_window_ == 0) {
+            return kNone;
+        }
+        return side_ == Side::Buy ? highest_at_or_below(window_ - 1) : lowest_at_or_above(0);
+    }
+
+    std::size_t next_worse(std::size_t slot) const {
+        if (side_ == Side::Buy) {
+            return slot == 0 ? kNone : highest_at_or_below(slot - 1);
+        }
+        return slot + 1 == window_ ? kNone : lowest_at_or_above(slot + 1);
+    }
+
+    // Moves the window to centre on tick: windowed levels that fall outside
+    // spill, spilled levels that fall inside come back. Only called with tick
+    // at or beyond the best, so spilled levels stay on the worse side.
+    void recentre(std::int64_t tick) {
+        std::vector<std::pair<std::int64_t, Value>> moved;
+        moved.reserve(in_window_);
+        for (std::size_t slot = best_slot(); slot != kNone; slot = next_worse(slot)) {
+            moved.emplace_back(base_ + static_cast<std::int64_t>(slot), values_[slot]);
+        }
+        std::fill(bits_.begin(), bits_.end(), 0);
+        std::fill(summary_.begin(), summary_.end(), 0);
+        in_window_ = 0;
+        base_ = tick - static_cast<std::int64_t>(window_ / 2);
+
+        auto place = [&](std::int64_t t, const Value& v) {
+            const std::size_t slot = slot_of(t);
+            if (slot == kNone) {
+                spill_.emplace(t, v);
+                return;
+            }
+            set(slot);
+            ++in_window_;
+            values_[slot] = v;
+        };
+        for (const auto& level : moved) {
+            place(level.first, level.second);
+        }
+        const auto first = spill_.lower_bound(base_);
+        const auto last = spill_.lower_bound(base_ + static_cast<std::int64_t>(window_));
+        for (auto it = first; it != last; ++it) {
+            const std::size_t slot = slot_of(it->first);
+            set(slot);
+            ++in_window_;
+            values_[slot] = it->second;
+        }
+        spill_.erase(first, last);
+    }
+
+    Side side_;
+    std::size_t window_;
+    std::int64_t base_ = 0;
+    std::size_t in_window_ = 0;
+    std::vector<Value> values_;
+    std::vector<std::uint64_t> bits_;
+    std::vector<std::uint64_t> summary_;
+    std::map<std::int64_t, Value> spill_;
+};
+
+} // namespace orderbook
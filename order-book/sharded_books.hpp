@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../common/itch.hpp"
+#include "../ring-buffer/spsc_ring.hpp"
+#include "order_book.hpp"
+
+namespace orderbook {
+
+// ITCH prices carry four decimals and FixedDouble three, so sub-mil digits
+// (only legal below $1) are truncated.
+static_assert(itch::kPriceScale % FixedDouble::scale == 0, "ITCH price scale must be a multiple of FixedDouble's");
+constexpr std::uint32_t kItchPerFixed = itch::kPriceScale / FixedDouble::scale;
+
+inline FixedDouble from_itch_price(std::uint32_t price) {
+    return FixedDouble::from_raw(static_cast<FixedDouble::storage_type>(price / kItchPerFixed));
+}
+
+inline void apply(OrderBook& book, const itch::Event& e) {
+    switch (e.kind) {
+    case itch::Kind::Add:
+        book.add(e.order_id, e.side == 'B' ? Side::Buy : Side::Sell, from_itch_price(e.price),
+                 FixedDouble::from_int(e.shares));
+        break;
+    case itch::Kind::Execute:
+    case itch::Kind::Cancel:
+        // A partial cancel shrinks the order exactly like a fill does.
+        book.execute(e.order_id, FixedDouble::from_int(e.shares));
+        break;
+    case itch::Kind::Delete:
+        book.cancel(e.order_id);
+        break;
+    case itch::Kind::Replace:
+        book.replace(e.order_id, e.new_order_id, from_itch_price(e.price), FixedDouble::from_int(e.shares));
+        break;
+    }
+}
+
+// One OrderBook per instrument, indexed by ITCH stock locate and sized from
+// the capture profile. A shard owns one of these for the instruments assigned
+// to it; the books (and their node pools) are allocated by the shard's own
+// thread, so on a NUMA host they land on that thread's node.
+class InstrumentBooks {
+public:
+    InstrumentBooks(const std::vector<itch::Profile>& profiles, const std::vector<std::uint16_t>& shard_of,
+                    std::uint16_t shard)
+        : books_(profiles.size()) {
+        for (std::size_t locate = 0; locate < profiles.size(); ++locate) {
+            const itch::Profile& p = profiles[locate];
+            if (p.adds != 0 && shard_of[locate] == shard) {
+                books_[locate] = std::make_unique<OrderBook>(std::max<std::size_t>(1, p.prices),
+                                                             std::max<std::size_t>(1, p.peak_orders));
+                ++instruments_;
+            }
+        }
+    }
+
+    // Book of the event's instrument, or nullptr when it is not on this shard
+    // or never had an add.
+    OrderBook* find(std::uint16_t locate) { return books_[locate].get(); }
+
+    std::size_t instruments() const { return instruments_; }
+
+    std::size_t order_count() const {
+        std::size_t n = 0;
+        for (const auto& book : books_) {
+            n += book ? book->order_count() : 0;
+        }
+        return n;
+    }
+
+private:
+    std::vector<std::unique_ptr<OrderBook>> books_;
+    std::size_t instruments_ = 0;
+};
+
+// Instrument -> shard table balancing event counts: busiest instruments
+// first, each to the currently least loaded shard.
+inline std::vector<std::uint16_t> assign_shards(const std::vector<itch::Profile>& profiles, std::size_t shards) {
+    if (shards == 0 || shards > 0xFFFF) {
+        throw std::invalid_argument("shard count must be between 1 and 65535");
+    }
+    std::vector<std::size_t> order(profiles.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t a, std::size_t b) { return profiles[a].events > profiles[b].events; });
+    std::vector<std::size_t> load(shards, 0);
+    std::vector<std::uint16_t> shard_of(profiles.size(), 0);
+    for (std::size_t locate : order) {
+        if (profiles[locate].events == 0) {
+            break;
+        }
+        const auto lightest = static_cast<std::size_t>(std::min_element(load.begin(), load.end()) - load.begin());
+        shard_of[locate] = static_cast<std::uint16_t>(lightest);
+        load[lightest] += profiles[locate].events;
+    }
+    return shard_of;
+}
+
+// Fans messages out to worker threads, one SPSC ring per worker. The
+// dispatcher (the thread calling send/finish) is the only producer of every
+// ring and each worker the only consumer of its own, so the hot path touches
+// no state shared between workers: per worker there is its ring, its stop
+// flag and its Worker object, each on its own cache lines.
+//
+// make_worker(index) runs on the worker's thread before it starts consuming
+// (pin the thread there, then allocate), and the Worker it returns is called
+// as worker(msg) for every message. Workers can be inspected after finish().
+template <typename Msg, typename Worker, typename Wait = spsc::BusyPoll>
+class Shards {
+public:
+    template <typename MakeWorker>
+    Shards(std::size_t count, std::size_t ring_capacity, MakeWorker&& make_worker) {
+        if (count == 0) {
+            throw std::invalid_argument("shard count must be greater than zero");
+        }
+        lanes_.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            lanes_.push_back(std::make_unique<Lane>(ring_capacity));
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            Lane& lane = *lanes_[i];
+            lane.thread = std::thread([&lane, i, &make_worker] {
+                try {
+                    lane.worker = std::make_unique<Worker>(make_worker(i));
+                } catch (...) {
+                    lane.error = std::current_exception();
+                    lane.ready.store(true, std::memory_order_release);
+                    return;
+                }
+                lane.ready.store(true, std::memory_order_release);
+                consume(lane);
+            });
+        }
+        // Workers are built before the first message so setup stays out of
+        // the timed dispatch; a failed make_worker is rethrown here.
+        std::exception_ptr error;
+        for (auto& lane : lanes_) {
+            while (!lane->ready.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            if (lane->error && !error) {
+                error = lane->error;
+            }
+        }
+        if (error) {
+            finish();
+            std::rethrow_exception(error);
+        }
+    }
+
+    Shards(const Shards&) = delete;
+    Shards& operator=(const Shards&) = delete;
+
+    ~Shards() { finish(); }
+
+    std::size_t size() const { return lanes_.size(); }
+
+    void send(std::size_t shard, const Msg& msg) { lanes_[shard]->ring.push(msg); }
+
+    // Lets every worker drain its ring, then joins the threads.
+    void finish() {
+        for (auto& lane : lanes_) {
+            lane->stop.store(true, std::memory_order_release);
+        }
+        for (auto& lane : lanes_) {
+            if (lane->thread.joinable()) {
+                lane->thread.join();
+            }
+        }
+    }
+
+    Worker& worker(std::size_t shard) { return *lanes_[shard]->worker; }
+
+private:
+    struct Lane {
+        explicit Lane(std::size_t capacity) : ring(capacity) {}
+
+        spsc::Ring<Msg, Wait> ring;
+        alignas(spsc::kCacheLine) std::atomic<bool> stop{false};
+        std::atomic<bool> ready{false};
+        std::unique_ptr<Worker> worker;
+        std::exception_ptr error;
+        std::thread thread;
+    };
+
+    static void consume(Lane& lane) {
+        Worker& worker = *lane.worker;
+        Msg msg;
+        while (true) {
+            if (lane.ring.try_pop(msg)) {
+                worker(msg);
+                continue;
+            }
+            // stop is set after the last send, so once it is seen an empty
+            // ring means everything has been consumed.
+            if (lane.stop.load(std::memory_order_acquire)) {
+                if (!lane.ring.try_pop(msg)) {
+                    return;
+                }
+                worker(msg);
+                continue;
+            }
+            Wait::wait();
+        }
+    }
+
+    std::vector<std::unique_ptr<Lane>> lanes_;
+};
+
+} // namespace orderbook
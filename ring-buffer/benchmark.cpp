@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../common/bench_env.hpp"
+#include "../common/bench_harness.hpp"
+#include "spsc_ring.hpp"
+
+// Decoder -> book handoff of one order message, the size of arr-list's Order
+// plus the producer's timestamp.
+struct OrderMsg {
+    std::uint64_t tsc;
+    std::uint64_t id;
+    std::int32_t qty;
+};
+
+// A full cache line per message, e.g. a decoded add with symbol, side, price
+// and attribution.
+struct LineMsg {
+    std::uint64_t tsc;
+    std::uint64_t id;
+    std::uint64_t payload[6];
+};
+
+static_assert(sizeof(OrderMsg) == 24 && sizeof(LineMsg) == 64, "message sizes are part of the case names");
+
+// To keep the compiler from optimizing away the consumer.
+volatile std::uint64_t g_sink = 0;
+
+struct Placement {
+    int producer = -1;
+    int consumer = -1;
+    bool shared_cpu = false; // fewer than two CPUs: spinning cases are skipped
+};
+
+struct RunResult {
+    double ms = 0.0;
+    bench::LatencyHistogram latency{bench::ns_per_tick()};
+};
+
+struct CaseSummary {
+    std::string name;
+    std::size_t msgs = 0;
+    double best_ns_per_msg = 0.0;
+    double worst_ns_per_msg = 0.0;
+    bench::LatencyHistogram latency{bench::ns_per_tick()};
+    bench::Interference interference;
+};
+
+// Runs one producer thread against the consumer on the calling thread.
+// gap_ticks == 0 streams as fast as the ring allows (throughput); otherwise
+// the producer releases one batch every gap_ticks so the ring is normally
+// empty and the consumer measures one-way handoff latency: its rdtscp on
+// receipt minus the producer's rdtsc written into the message.
+template <typename Msg, typename Wait>
+RunResult run_once(const Placement& where, std::size_t capacity, std::size_t msgs, std::size_t batch,
+                   std::uint64_t gap_ticks) {
+    auto ring = std::make_unique<spsc::Ring<Msg, Wait>>(capacity);
+    std::atomic<bool> go{false};
+
+    std::thread producer([&] {
+        if (where.producer >= 0) {
+            bench::pin_this_thread(where.producer);
+        }
+        std::vector<Msg> out(batch);
+        while (!go.load(std::memory_order_acquire)) {
+            Wait::wait();
+        }
+        std::uint64_t next_release = bench::rdtsc();
+        for (std::size_t sent = 0; sent < msgs;) {
+            const std::size_t n = std::min(batch, msgs - sent);
+            if (gap_ticks != 0) {
+                while (bench::rdtsc() < next_release) {
+                }
+                next_release += gap_ticks;
+            }
+            const std::uint64_t now = bench::rdtsc();
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = Msg{};
+                out[i].tsc = now;
+                out[i].id = sent + i;
+            }
+            if (n == 1) {
+                ring->push(out[0]);
+            } else {
+                ring->push_bulk(out.data(), n);
+            }
+            sent += n;
+        }
+    });
+
+    RunResult r;
+    std::vector<Msg> in(batch);
+    std::uint64_t expected = 0;
+    std::uint64_t checksum = 0;
+    bool ordered = true;
+    const bool sample = gap_ticks != 0;
+    const auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    while (expected < msgs) {
+        const std::size_t n = batch == 1 ? (in[0] = ring->pop(), 1) : ring->pop_bulk(in.data(), batch);
+        const std::uint64_t now = sample ? bench::rdtscp() : 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            ordered = ordered && in[i].id == expected;
+            ++expected;
+            checksum += in[i].id;
+            if (sample) {
+                r.latency.record(now > in[i].tsc ? now - in[i].tsc : 0);
+            }
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    producer.join();
+    if (!ordered) {
+        throw std::runtime_error("ring delivered messages out of order");
+    }
+    g_sink = checksum;
+    r.ms = std::chrono::duration<double, std::milli>(end - start).count();
+    return r;
+}
+
+// Best/worst throughput over `runs` streaming runs, then one paced run for the
+// latency distribution.
+template <typename Msg, typename Wait>
+CaseSummary run_case(std::string name, const Placement& where, std::size_t capacity, std::size_t msgs,
+                     std::size_t batch, std::size_t runs, std::size_t latency_msgs, std::uint64_t gap_ticks) {
+    CaseSummary c;
+    c.name = std::move(name);
+    c.msgs = msgs;
+    c.best_ns_per_msg = std::numeric_limits<double>::max();
+    const bench::Interference before = bench::interference_now();
+    for (std::size_t i = 0; i < runs; ++i) {
+        const double ns = run_once<Msg, Wait>(where, capacity, msgs, batch, 0).ms * 1e6 / static_cast<double>(msgs);
+        c.best_ns_per_msg = std::min(c.best_ns_per_msg, ns);
+        c.worst_ns_per_msg = std::max(c.worst_ns_per_msg, ns);
+    }
+    c.latency = run_once<Msg, Wait>(where, capacity, latency_msgs, batch, gap_ticks).latency;
+    c.interference = bench::interference_now() - before;
+    return c;
+}
+
+// Consumer on the main thread, producer on another allowed CPU: --cpu names
+// the consumer's CPU, otherwise the last two allowed CPUs are used (away from
+// CPU 0, which usually takes the most interrupts).
+Placement place(const bench::Options& opts, const std::vector<int>& cpus) {
+    Placement p;
+    if (opts.cpu >= 0) {
+        p.consumer = opts.cpu;
+        for (int cpu : cpus) {
+            if (cpu != opts.cpu) {
+                p.producer = cpu;
+                if (cpu > opts.cpu) {
+                    break;
+                }
+            }
+        }
+    } else if (cpus.size() >= 2) {
+        p.consumer = cpus[cpus.size() - 1];
+        p.producer = cpus[cpus.size() - 2];
+    }
+    p.shared_cpu = p.producer < 0;
+    return p;
+}
+
+std::string core_of(int cpu) {
+    if (cpu < 0) {
+        return "any";
+    }
+    const std::string topo = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+    return std::to_string(cpu) + " (package " + bench::detail::read_line(topo + "physical_package_id") + ", core " +
+           bench::detail::read_line(topo + "core_id") + ")";
+}
+
+int main(int argc, char** argv) {
+    bench::Options opts;
+    try {
+        opts = bench::parse_options(argc, argv);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n" << bench::usage();
+        return 2;
+    }
+    if (opts.help) {
+        std::cout << "scenarios: order, line (message type), busy-poll, pause, yield (wait), batch N\n"
+                  << "sizes: ring capacity, rounded up to a power of two (default 4k); iters: messages per "
+                     "throughput run (default 1M, latency runs use iters/10); reps: runs per case (default 5)\n"
+                  << "--cpu=N: consumer CPU; the producer takes the next allowed CPU\n"
+                  << bench::usage();
+        return 0;
+    }
+
+    try {
+        // Placement is chosen before setup_runner pins the main thread.
+        const std::vector<int> cpus = bench::allowed_cpus();
+        const Placement where = place(opts, cpus);
+
+        bench::Reporter report(opts);
+        bench::setup_runner(opts, report);
+        if (opts.cpu < 0 && where.consumer >= 0 && !bench::pin_this_thread(where.consumer)) {
+            throw std::runtime_error("cannot pin the consumer to cpu " + std::to_string(where.consumer));
+        }
+        std::ostream& out = report.text();
+        const std::string placement = "producer " + core_of(where.producer) + ", consumer " + core_of(where.consumer);
+        out << "env: ring_threads " << placement << "\n";
+        report.set_env("ring_threads", placement);
+        bench::print_timer_info(out);
+
+        const std::size_t msgs = opts.iters_or(1'000'000);
+        const std::size_t latency_msgs = std::max<std::size_t>(1, msgs / 10);
+        const std::size_t runs = opts.reps_or(5);
+        const double gap_ns = 1000.0;
+        const auto gap_ticks = static_cast<std::uint64_t>(gap_ns / bench::ns_per_tick());
+        if (where.shared_cpu) {
+            out << "single CPU: producer and consumer share it, so only the yield cases run and they measure "
+                   "scheduler handoffs, not cache-line transfers\n";
+        }
+
+        for (std::size_t requested : opts.sizes_or({4 * 1024})) {
+            const std::size_t capacity = std::bit_ceil(std::max<std::size_t>(requested, 2));
+            out << "SPSC ring (capacity " << capacity << ", " << msgs << " msgs, best/worst of " << runs
+                << "; latency: " << latency_msgs << " msgs, one batch every " << gap_ns << " ns)\n";
+
+            auto run = [&](auto msg_tag, auto wait_tag, const char* msg_name, const char* wait_name) {
+                using Msg = typename decltype(msg_tag)::type;
+                using Wait = typename decltype(wait_tag)::type;
+                for (std::size_t batch : {std::size_t{1}, std::size_t{16}}) {
+                    const std::string name = std::string(msg_name) + " " + wait_name + " batch " + std::to_string(batch);
+                    if (!opts.selected(name) || batch > capacity) {
+                        continue;
+                    }
+                    const CaseSummary c = run_case<Msg, Wait>(name, where, capacity, msgs, batch, runs,
+                                                              latency_msgs, gap_ticks);
+                    report.add(bench::Record{"spsc", c.name, capacity, c.msgs, runs, c.best_ns_per_msg,
+                                             c.worst_ns_per_msg, c.latency.summary(), c.interference.ctx_switches,
+                                             c.interference.page_faults});
+                    out << "  " << c.name << "\n"
+                        << "    throughput:  " << 1e3 / c.best_ns_per_msg << " Mmsg/s best (" << c.best_ns_per_msg
+                        << " ns/msg best, " << c.worst_ns_per_msg << " worst)\n"
+                        << "    latency:     " << c.latency.summary() << "\n"
+                        << "    interrupted: " << c.interference.ctx_switches << " ctx switches, "
+                        << c.interference.page_faults << " page faults\n";
+                }
+            };
+            auto run_waits = [&](auto msg_tag, const char* msg_name) {
+                if (where.shared_cpu) {
+                    run(msg_tag, std::type_identity<spsc::YieldWait>{}, msg_name, "yield");
+                    return;
+                }
+                run(msg_tag, std::type_identity<spsc::BusyPoll>{}, msg_name, "busy-poll");
+                run(msg_tag, std::type_identity<spsc::PauseWait>{}, msg_name, "pause");
+            };
+            run_waits(std::type_identity<OrderMsg>{}, "order 24B");
+            run_waits(std::type_identity<LineMsg>{}, "line 64B");
+            out << "\n";
+        }
+        report.finish();
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace spsc {
+
+constexpr std::size_t kCacheLine = 64;
+
+// What a side does while the ring is full (producer) or empty (consumer).
+// BusyPoll re-reads the other cursor at once; PauseWait issues a pause first,
+// which frees pipeline resources for a sibling hyperthread and slows the
+// re-read rate on the contended line; YieldWait gives up the CPU and is only
+// for machines where both threads share a core.
+struct BusyPoll {
+    static void wait() {}
+};
+
+struct PauseWait {
+    static void wait() {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#endif
+    }
+};
+
+struct YieldWait {
+    static void wait() { std::this_thread::yield(); }
+};
+
+// Bounded lock-free single-producer/single-consumer ring of trivially
+// copyable messages. Exactly one thread may call the producer functions
+// (try_push, push, try_push_bulk) and one the consumer functions (try_pop, pop,
+// try_pop_bulk).
+//
+// The two cursors grow monotonically and are masked on access, so full and
+// empty need no spare slot. Each side keeps a cached copy of the other side's
+// cursor and only reloads it (an acquire load of a line the other core owns)
+// when the cached value says full/empty, so a steady stream costs one release
+// store per push or pop. The bulk calls move up to n messages with a single
+// cursor update, which is where batching pays: one coherence transfer of the
+// cursor line per batch instead of per message.
+template <typename T, typename Wait = BusyPoll>
+class Ring {
+    static_assert(std::is_trivially_copyable<T>::value, "ring messages are copied as bytes");
+
+public:
+    // capacity must be a power of two.
+    explicit Ring(std::size_t capacity)
+        : slots_(std::make_unique<T[]>(checked_capacity(capacity))), mask_(capacity - 1) {}
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    // Approximate when called concurrently with the other side.
+    std::size_t size() const {
+        return producer_.tail.load(std::memory_order_acquire) - consumer_.head.load(std::memory_order_acquire);
+    }
+
+    // Producer side.
+    bool try_push(const T& value) {
+        const std::size_t tail = producer_.tail.load(std::memory_order_relaxed);
+        if (tail - producer_.cached_head == capacity()) {
+            producer_.cached_head = consumer_.head.load(std::memory_order_acquire);
+            if (tail - producer_.cached_head == capacity()) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = value;
+        producer_.tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(const T& value) {
+        while (!try_push(value)) {
+            Wait::wait();
+        }
+    }
+
+    // Pushes up to n messages, as many as fit; returns how many.
+    std::size_t try_push_bulk(const T* values, std::size_t n) {
+        const std::size_t tail = producer_.tail.load(std::memory_order_relaxed);
+        std::size_t space = capacity() - (tail - producer_.cached_head);
+        if (space < n) {
+            producer_.cached_head = consumer_.head.load(std::memory_order_acquire);
+            space = capacity() - (tail - producer_.cached_head);
+        }
+        const std::size_t count = n < space ? n : space;
+        for (std::size_t i = 0; i < count; ++i) {
+            slots_[(tail + i) & mask_] = values[i];
+        }
+        if (count != 0) {
+            producer_.tail.store(tail + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    // Pushes all n messages, waiting for space as needed.
+    void push_bulk(const T* values, std::size_t n) {
+        while (n != 0) {
+            const std::size_t pushed = try_push_bulk(values, n);
+            values += pushed;
+            n -= pushed;
+            if (n != 0) {
+                Wait::wait();
+            }
+        }
+    }
+
+    // Consumer side.
+    bool try_pop(T& out) {
+        const std::size_t head = consumer_.head.load(std::memory_order_relaxed);
+        if (head == consumer_.cached_tail) {
+            consumer_.cached_tail = producer_.tail.load(std::memory_order_acquire);
+            if (head == consumer_.cached_tail) {
+                return false;
+            }
+        }
+        out = slots_[head & mask_];
+        consumer_.head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    T pop() {
+        T out;
+        while (!try_pop(out)) {
+            Wait::wait();
+        }
+        return out;
+    }
+
+    // Pops up to max messages that are already available; returns how many.
+    std::size_t try_pop_bulk(T* out, std::size_t max) {
+        const std::size_t head = consumer_.head.load(std::memory_order_relaxed);
+        std::size_t avail = consumer_.cached_tail - head;
+        if (avail < max) {
+            consumer_.cached_tail = producer_.tail.load(std::memory_order_acquire);
+            avail = consumer_.cached_tail - head;
+        }
+        const std::size_t count = max < avail ? max : avail;
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = slots_[(head + i) & mask_];
+        }
+        if (count != 0) {
+            consumer_.head.store(head + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    // Pops at least one message (waiting if the ring is empty) and at most max.
+    std::size_t pop_bulk(T* out, std::size_t max) {
+        std::size_t count;
+        while ((count = try_pop_bulk(out, max)) == 0) {
+            Wait::wait();
+        }
+        return count;
+    }
+
+private:
+    static std::size_t checked_capacity(std::size_t capacity) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("ring capacity must be a power of two of at least 2");
+        }
+        return capacity;
+    }
+
+    // Written by the producer only (cached_head is producer-private).
+    struct alignas(kCacheLine) ProducerSide {
+        std::atomic<std::size_t> tail{0};
+        std::size_t cached_head = 0;
+    };
+
+    // Written by the consumer only (cached_tail is consumer-private).
+    struct alignas(kCacheLine) ConsumerSide {
+        std::atomic<std::size_t> head{0};
+        std::size_t cached_tail = 0;
+    };
+
+    ProducerSide producer_;
+    ConsumerSide consumer_;
+    // Read-only after construction; its own line so neither cursor line
+    // bounces it out of the other core's cache.
+    alignas(kCacheLine) std::unique_ptr<T[]> slots_;
+    std::size_t mask_;
+};
+
+} // namespace spsc